@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <fstream>
+#include <vector>
 
 #include <Windows.h>
 
@@ -134,7 +135,16 @@ auto HijackActionManager::absolute_cfg_temp() const
 HijackActionManager::HijackActionManager(const Settings& settings) :
 	m_Settings(&settings)
 {
-	std::filesystem::remove_all(absolute_cfg_temp());
+	// Queued ahead of any writes, so it can't delete files we create
+	m_FileWorker.add_task([tempDir = absolute_cfg_temp()]
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(tempDir, ec);
+			if (ec)
+				LogError("Failed to clear temp cfg directory "s << tempDir << ": " << ec.message());
+
+			return !ec;
+		});
 }
 
 HijackActionManager::~HijackActionManager()
@@ -151,6 +161,73 @@ bool HijackActionManager::RunCommand(std::string cmd, std::string args)
 void HijackActionManager::Update()
 {
 	ProcessRunningCommands();
+	ProcessPendingExecs();
+	EvictStaleTempCfgFiles();
+}
+
+void HijackActionManager::ProcessPendingExecs()
+{
+	// Front to back, so execs still run in the order they were requested
+	while (!m_PendingExecs.empty())
+	{
+		auto& front = m_PendingExecs.front();
+		if (front.m_Written.wait_for(0s) != std::future_status::ready)
+			break;
+
+		if (front.m_Written.get())
+			SendHijackCommand(std::move(front.m_Command));
+		else
+			LogError("Dropping "s << std::quoted(front.m_Command) << ", failed to write its cfg file");
+
+		m_PendingExecs.pop_front();
+	}
+}
+
+void HijackActionManager::EvictStaleTempCfgFiles()
+{
+	constexpr size_t MAX_TEMP_CFG_FILES = 256;
+
+	// Comfortably longer than RunningCommand's timeout, so we never delete a file hl2.exe is about to exec
+	constexpr auto MIN_UNUSED_TIME = 30s;
+
+	if (m_TempCfgFiles.size() <= MAX_TEMP_CFG_FILES)
+		return;
+
+	const auto now = clock_t::now();
+	std::vector<uint32_t> evicted;
+	for (auto it = m_TempCfgFiles.begin(); it != m_TempCfgFiles.end(); )
+	{
+		if ((now - it->second.m_LastUsed) >= MIN_UNUSED_TIME &&
+			it->second.m_Written.wait_for(0s) == std::future_status::ready)
+		{
+			evicted.push_back(it->second.m_Index);
+			it = m_TempCfgFiles.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if (evicted.empty())
+		return;
+
+	m_FileWorker.add_task([tempDir = absolute_cfg_temp(), evicted = std::move(evicted)]
+		{
+			bool success = true;
+			for (uint32_t index : evicted)
+			{
+				std::error_code ec;
+				std::filesystem::remove(tempDir / (""s << index << ".cfg"), ec);
+				if (ec)
+				{
+					DebugLogWarning("Failed to delete temp cfg file "s << index << ".cfg: " << ec.message());
+					success = false;
+				}
+			}
+
+			return success;
+		});
 }
 
 bool HijackActionManager::ProcessSimpleCommands(const Writer& writer)
@@ -197,64 +274,55 @@ bool HijackActionManager::ProcessComplexCommands(const Writer& writer)
 	for (const auto& cmd : writer.m_Commands)
 		cfgFileContents << cmd.first << ' ' << cmd.second << '\n';
 
-	const auto globalPath = absolute_cfg_temp();
-	std::filesystem::create_directories(globalPath);
+	if (!IsGameRunning())
+	{
+		DebugLogWarning("Attempted to exec a temp cfg file, but game is not running");
+		return false;
+	}
+
+	auto [it, inserted] = m_TempCfgFiles.try_emplace(std::move(cfgFileContents));
+	TempCfgFile& cfgFile = it->second;
+	cfgFile.m_LastUsed = clock_t::now();
 
-	const auto hash = std::hash<std::string>{}(cfgFileContents);
-	std::string cfgFilename;
+	if (inserted)
 	{
-		auto found = m_TempCfgFiles.equal_range(hash);
-		for (auto it = found.first; it != found.second; ++it)
-		{
-			// Make sure file contents are identical
-			std::string localCfgFilename = ""s << it->second << ".cfg";
-			std::filesystem::path path = globalPath / localCfgFilename;
+		cfgFile.m_Index = ++m_LastUpdateIndex;
+		//Log("Creating new temp cfg file "s << cfgFile.m_Index << ".cfg");
 
-			std::ifstream file(path);
-			size_t comparePos = 0;
-			while (true)
+		cfgFile.m_Written = m_FileWorker.add_task(
+			[tempDir = absolute_cfg_temp(), index = cfgFile.m_Index, contents = it->first]
 			{
-				char buf[4096];
-				file.read(buf, std::size(buf));
-				if (file.bad())
-					break;
-
-				const auto bufCount = static_cast<size_t>(file.gcount());
-				if (bufCount == 0)
-					break;
+				std::error_code ec;
+				std::filesystem::create_directories(tempDir, ec);
 
-				if (cfgFileContents.compare(comparePos, bufCount, buf, bufCount))
+				std::ofstream file(tempDir / (""s << index << ".cfg"), std::ios_base::trunc);
+				file << contents;
+				if (!file.good())
 				{
-					// Not equal
-					break;
+					LogError("Failed to write temp cfg file "s << index << ".cfg");
+					return false;
 				}
 
-				comparePos += bufCount;
-			}
-
-			if (comparePos == cfgFileContents.size())
-			{
-				cfgFilename = std::move(localCfgFilename);
-				break;
-			}
-		}
+				return true;
+			});
 	}
 
-	if (cfgFilename.empty())
-	{
-		// Create a new temp cfg file
-		cfgFilename = ""s << ++m_LastUpdateIndex << ".cfg";
-		//Log("Creating new temp cfg file "s << std::quoted(cfgFilename));
+	std::string command = "+exec "s << (tfbd_paths::local::cfg_temp() / (""s << cfgFile.m_Index << ".cfg")).generic_string();
 
-		std::ofstream file(globalPath / cfgFilename, std::ios_base::trunc);
-		assert(file.good());
-		file << cfgFileContents;
-		assert(file.good());
+	// Don't jump the queue, even if our own file is already written
+	if (m_PendingExecs.empty() && cfgFile.m_Written.wait_for(0s) == std::future_status::ready)
+	{
+		if (!cfgFile.m_Written.get())
+		{
+			m_TempCfgFiles.erase(it); // Try writing it again next time
+			return false;
+		}
 
-		m_TempCfgFiles.emplace(std::hash<std::string>{}(cfgFileContents), m_LastUpdateIndex);
+		return SendHijackCommand(std::move(command));
 	}
 
-	return SendHijackCommand("+exec "s << (tfbd_paths::local::cfg_temp() / cfgFilename).generic_string());
+	m_PendingExecs.push_back({ cfgFile.m_Written, std::move(command) });
+	return true;
 }
 
 bool HijackActionManager::SendHijackCommands(const Writer& writer)
@@ -266,12 +334,17 @@ bool HijackActionManager::SendHijackCommands(const Writer& writer)
 		return ProcessComplexCommands(writer);
 }
 
+bool HijackActionManager::IsGameRunning()
+{
+	return FindWindowA("Valve001", nullptr) != nullptr;
+}
+
 bool HijackActionManager::SendHijackCommand(std::string cmd)
 {
 	if (cmd.empty())
 		return true;
 
-	if (!FindWindowA("Valve001", nullptr))
+	if (!IsGameRunning())
 	{
 		DebugLogWarning("Attempted to send command \""s << cmd << "\" to game, but game is not running");
 		return false;
@@ -1,8 +1,14 @@
 #pragma once
 #ifdef _WIN32
 
+#include "Clock.h"
+
+#include <mh/concurrency/thread_pool.hpp>
+
+#include <future>
 #include <list>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace tf2_bot_detector
@@ -30,15 +36,35 @@ namespace tf2_bot_detector
 		auto absolute_cfg() const;
 		auto absolute_cfg_temp() const;
 
-		// Map of temp cfg file content hashes to cfg file name so we don't
-		// create a ton of duplicate files.
-		std::unordered_multimap<size_t, uint32_t> m_TempCfgFiles;
+		// Temp cfg files we've written, keyed by their exact contents so repeated
+		// commands reuse a file without reading it back from disk.
+		struct TempCfgFile
+		{
+			uint32_t m_Index = 0;
+			std::shared_future<bool> m_Written;
+			time_point_t m_LastUsed{};
+		};
+		std::unordered_map<std::string, TempCfgFile> m_TempCfgFiles;
 		uint32_t m_LastUpdateIndex = 0;
+		void EvictStaleTempCfgFiles();
+
+		// Cfg files are written/deleted in order on this thread, and any exec of
+		// a file that isn't written yet waits in m_PendingExecs.
+		mh::thread_pool<bool> m_FileWorker{ 1 };
+		struct PendingExec
+		{
+			std::shared_future<bool> m_Written;
+			std::string m_Command;
+		};
+		std::list<PendingExec> m_PendingExecs;
+		void ProcessPendingExecs();
+
 		bool ProcessSimpleCommands(const Writer& writer);
 		bool ProcessComplexCommands(const Writer& writer);
 
 		bool SendHijackCommands(const Writer& writer);
 		bool SendHijackCommand(std::string cmd);
+		static bool IsGameRunning();
 
 		struct RunningCommand;
 		std::list<RunningCommand> m_RunningCommands;
@@ -21,6 +21,15 @@ void CompensatedTS::SetRecorded(time_point_t recorded)
 		m_Parsed = recorded;
 }
 
+void CompensatedTS::SetExact(time_point_t time)
+{
+	m_Recorded = time;
+	m_Parsed = time;
+	m_Snapshot = time;
+	m_PreviousSnapshot = time;
+	m_SnapshotUsed = false;
+}
+
 void CompensatedTS::Snapshot()
 {
 	const auto now = clock_t::now();
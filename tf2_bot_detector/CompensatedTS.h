@@ -16,6 +16,9 @@ namespace tf2_bot_detector
 		bool IsRecordedValid() const { return m_Recorded.has_value(); }
 		void SetRecorded(time_point_t recorded);
 
+		// Jumps straight to a known time with no compensation, for replaying recorded sessions
+		void SetExact(time_point_t time);
+
 		void Snapshot();
 		bool IsSnapshotValid() const { return m_Snapshot.has_value(); }
 		time_point_t GetSnapshot() const;
@@ -4,6 +4,7 @@
 #include "Util/JSONUtils.h"
 #include "Util/TextUtils.h"
 #include "Log.h"
+#include "TaskScheduler.h"
 
 #include <vdf_parser.hpp>
 #include <cppcoro/generator.hpp>
@@ -11,11 +12,15 @@
 #include <mh/text/string_insertion.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <array>
 #include <charconv>
 #include <compare>
 #include <concepts>
-#include <execution>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <regex>
 #include <set>
@@ -256,32 +261,111 @@ static bool GetChatCategory(const std::string* src, std::string_view* name, Chat
 	return true;
 }
 
-static void GetChatMsgFormats(const std::string_view& debugInfo, const std::string_view& translations, ChatFormatStrings& strings)
+namespace
 {
-	const char* begin = translations.data();
-	const char* end = begin + translations.size();
-	std::error_code ec;
-	auto parsed = tyti::vdf::read(begin, end, ec);
-	if (ec)
+	// The chat format strings a single localization file sets. Unlike ChatFormatStrings,
+	// this distinguishes "not in this file" from an empty string.
+	struct ChatFormatOverrides
 	{
-		LogError("Failed to parse translations from "s << std::quoted(debugInfo) << ": " << ec);
-		return;
+		using array_t = std::array<std::optional<std::string>, (size_t)ChatCategory::COUNT>;
+		array_t m_English;
+		array_t m_Localized;
+
+		void ApplyTo(ChatFormatStrings& strings) const
+		{
+			for (size_t i = 0; i < size_t(ChatCategory::COUNT); i++)
+			{
+				if (m_English[i])
+					strings.m_English[i] = *m_English[i];
+				if (m_Localized[i])
+					strings.m_Localized[i] = *m_Localized[i];
+			}
+		}
+	};
+
+	// Unset strings are stored as null
+	void to_json(nlohmann::json& j, const ChatFormatOverrides::array_t& d)
+	{
+		j = nlohmann::json::array();
+		for (const auto& str : d)
+			j.push_back(str ? nlohmann::json(*str) : nlohmann::json());
+	}
+	void from_json(const nlohmann::json& j, ChatFormatOverrides::array_t& d)
+	{
+		for (size_t i = 0; i < d.size(); i++)
+		{
+			if (const auto& str = j.at(i); str.is_null())
+				d[i].reset();
+			else
+				d[i] = str.get<std::string>();
+		}
 	}
 
-	if (auto tokens = parsed.childs["Tokens"])
+	void to_json(nlohmann::json& j, const ChatFormatOverrides& d)
 	{
-		std::string_view chatType;
-		bool isEnglish;
+		to_json(j["english"], d.m_English);
+		to_json(j["localized"], d.m_Localized);
+	}
+	void from_json(const nlohmann::json& j, ChatFormatOverrides& d)
+	{
+		from_json(j.at("english"), d.m_English);
+		from_json(j.at("localized"), d.m_Localized);
+	}
+}
+
+// Pulls just the TF_Chat_* tokens out of a localization file. Only their keys and
+// values are transcoded, instead of converting and parsing the entire file as vdf.
+static ChatFormatOverrides GetChatMsgFormats(const std::u16string_view& translations)
+{
+	constexpr std::u16string_view WHITESPACE = u" \t\r";
+
+	ChatFormatOverrides retVal;
+	for (size_t lineBegin = 0; lineBegin < translations.size(); )
+	{
+		const size_t lineEnd = std::min(translations.find(u'\n', lineBegin), translations.size());
+		const auto line = translations.substr(lineBegin, lineEnd - lineBegin);
+		lineBegin = lineEnd + 1;
+
+		// "key"	"value"
+		auto pos = line.find_first_not_of(WHITESPACE);
+		if (pos == line.npos || line[pos] != u'"')
+			continue;
 
-		for (const auto& attrib : tokens->attribs)
+		const auto keyEnd = line.find(u'"', pos + 1);
+		if (keyEnd == line.npos)
+			continue;
+
+		const auto key = line.substr(pos + 1, keyEnd - pos - 1);
+		if (!key.starts_with(u"TF_Chat_") && !key.starts_with(u"[english]TF_Chat_"))
+			continue;
+
+		pos = line.find_first_not_of(WHITESPACE, keyEnd + 1);
+		if (pos == line.npos || line[pos] != u'"')
+			continue;
+
+		// Same escapes the vdf parser strips
+		std::u16string value;
+		for (pos++; pos < line.size() && line[pos] != u'"'; pos++)
 		{
-			ChatCategory cat;
-			if (!GetChatCategory(&attrib.first, &chatType, &cat, &isEnglish))
-				continue;
+			if (line[pos] == u'\\' && pos + 1 < line.size() && (line[pos + 1] == u'"' || line[pos + 1] == u'\\'))
+				pos++;
 
-			(isEnglish ? strings.m_English : strings.m_Localized)[(int)cat] = attrib.second;
+			value.push_back(line[pos]);
 		}
+
+		if (pos >= line.size())
+			continue; // Unterminated value
+
+		const std::string keyStr = ToMB(key);
+		ChatCategory cat;
+		bool isEnglish;
+		if (!GetChatCategory(&keyStr, nullptr, &cat, &isEnglish))
+			continue;
+
+		(isEnglish ? retVal.m_English : retVal.m_Localized)[(int)cat] = ToMB(value);
 	}
+
+	return retVal;
 }
 
 static void ApplyChatWrappers(ChatCategory cat, std::string& translation, const ChatWrappers& wrappers)
@@ -359,12 +443,142 @@ static std::filesystem::path FindExistingChatTranslationFile(
 	return {};
 }
 
-static ChatFormatStrings FindExistingTranslations(const std::filesystem::path& tfdir, const std::string_view& language)
+namespace
+{
+	// Chat format strings extracted from each localization file, persisted between runs
+	// and keyed by path, size and last write time, so regenerating chat wrappers only
+	// has to read files that changed.
+	class LocalizationCache final
+	{
+	public:
+		LocalizationCache();
+
+		ChatFormatOverrides GetChatMsgFormats(const std::filesystem::path& path);
+
+		// Drops any entries that weren't used since this cache was loaded
+		void Save();
+
+	private:
+		struct Entry
+		{
+			uint64_t m_Size{};
+			int64_t m_WriteTime{};
+			ChatFormatOverrides m_Formats;
+			bool m_Used = false;
+		};
+
+		std::filesystem::path m_CacheFile;
+		std::mutex m_Mutex;
+		std::map<std::filesystem::path, Entry> m_Entries;
+		bool m_Modified = false;
+	};
+
+	static constexpr int LOCALIZATION_CACHE_VERSION = 1;
+}
+
+LocalizationCache::LocalizationCache() :
+	m_CacheFile(std::filesystem::temp_directory_path() / "TF2 Bot Detector" / "localization_cache.json")
+{
+	if (!std::filesystem::exists(m_CacheFile))
+		return;
+
+	try
+	{
+		std::ifstream file(m_CacheFile);
+		const auto json = nlohmann::json::parse(file);
+		if (json.at("version").get<int>() != LOCALIZATION_CACHE_VERSION)
+			return;
+
+		for (const auto& entry : json.at("files"))
+		{
+			auto& cached = m_Entries[std::filesystem::path(ToU8(entry.at("path").get<std::string_view>()))];
+			entry.at("size").get_to(cached.m_Size);
+			entry.at("write_time").get_to(cached.m_WriteTime);
+			from_json(entry.at("formats"), cached.m_Formats);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to load localization cache, ignoring it");
+		m_Entries.clear();
+	}
+}
+
+ChatFormatOverrides LocalizationCache::GetChatMsgFormats(const std::filesystem::path& path)
+{
+	const uint64_t size = std::filesystem::file_size(path);
+	const int64_t writeTime = std::filesystem::last_write_time(path).time_since_epoch().count();
+
+	{
+		std::lock_guard lock(m_Mutex);
+		if (auto found = m_Entries.find(path); found != m_Entries.end() &&
+			found->second.m_Size == size && found->second.m_WriteTime == writeTime)
+		{
+			found->second.m_Used = true;
+			return found->second.m_Formats;
+		}
+	}
+
+	auto formats = ::GetChatMsgFormats(ReadWideFile(path));
+
+	std::lock_guard lock(m_Mutex);
+	m_Entries[path] = Entry{ .m_Size = size, .m_WriteTime = writeTime, .m_Formats = formats, .m_Used = true };
+	m_Modified = true;
+	return formats;
+}
+
+void LocalizationCache::Save()
+{
+	std::lock_guard lock(m_Mutex);
+
+	nlohmann::json files = nlohmann::json::array();
+	for (const auto& [path, entry] : m_Entries)
+	{
+		if (!entry.m_Used)
+		{
+			m_Modified = true;
+			continue;
+		}
+
+		auto& fileJson = files.emplace_back();
+		fileJson["path"] = ToMB(path.u8string());
+		fileJson["size"] = entry.m_Size;
+		fileJson["write_time"] = entry.m_WriteTime;
+		to_json(fileJson["formats"], entry.m_Formats);
+	}
+
+	if (!m_Modified)
+		return;
+
+	try
+	{
+		std::filesystem::create_directories(m_CacheFile.parent_path());
+		std::ofstream file(m_CacheFile, std::ios::trunc);
+		file << nlohmann::json{ { "version", LOCALIZATION_CACHE_VERSION }, { "files", std::move(files) } };
+		m_Modified = false;
+	}
+	catch (const std::exception& e)
+	{
+		LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to save localization cache");
+	}
+}
+
+static ChatFormatStrings FindExistingTranslations(const std::filesystem::path& tfdir,
+	const std::string_view& language, LocalizationCache& cache)
 {
 	ChatFormatStrings retVal;
 
 	for (const auto& filename : GetLocalizationFiles(tfdir, language))
-		GetChatMsgFormats(filename.string(), ToMB(ReadWideFile(filename)), retVal);
+	{
+		try
+		{
+			cache.GetChatMsgFormats(filename).ApplyTo(retVal);
+		}
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to read translations from "s << filename);
+		}
+	}
 
 	return retVal;
 }
@@ -542,6 +756,139 @@ void tf2_bot_detector::from_json(const nlohmann::json& j, ChatWrappers& d)
 	}
 }
 
+ChatWrapperMatcher::ChatWrapperMatcher(const ChatWrappers& wrappers) :
+	m_Wrappers(wrappers)
+{
+	// Node 0 is the root, and doubles as "no node" in m_FirstByteNodes/m_Children
+	m_Nodes.emplace_back();
+
+	for (size_t i = 0; i < m_Wrappers.m_Types.size(); i++)
+	{
+		const std::string_view start = m_Wrappers.m_Types[i].m_Full.m_Start.m_Narrow;
+
+		uint32_t node = 0;
+		for (size_t c = 0; c < start.size(); c++)
+		{
+			uint32_t child = (c == 0) ? m_FirstByteNodes[uint8_t(start[c])] : m_Nodes[node].FindChild(start[c]);
+			if (!child)
+			{
+				child = uint32_t(m_Nodes.size());
+				m_Nodes.emplace_back();
+
+				if (c == 0)
+				{
+					m_FirstByteNodes[uint8_t(start[c])] = child;
+				}
+				else
+				{
+					auto& children = m_Nodes[node].m_Children;
+					children.insert(std::upper_bound(children.begin(), children.end(), start[c],
+						[](char lhs, const auto& rhs) { return lhs < rhs.first; }),
+						{ start[c], child });
+				}
+			}
+
+			node = child;
+		}
+
+		// Categories are visited in order, so the first one to claim a node has the lowest index
+		if (m_Nodes[node].m_Category < 0)
+			m_Nodes[node].m_Category = int8_t(i);
+	}
+}
+
+uint32_t ChatWrapperMatcher::TrieNode::FindChild(char c) const
+{
+	auto it = std::lower_bound(m_Children.begin(), m_Children.end(), c,
+		[](const auto& lhs, char rhs) { return lhs.first < rhs; });
+
+	if (it == m_Children.end() || it->first != c)
+		return 0;
+
+	return it->second;
+}
+
+std::optional<ChatCategory> ChatWrapperMatcher::MatchStart(const std::string_view& line) const
+{
+	std::optional<ChatCategory> retVal;
+	if (m_Nodes[0].m_Category >= 0)
+		retVal = ChatCategory(m_Nodes[0].m_Category); // Empty wrapper, matches everything
+
+	if (line.empty())
+		return retVal;
+
+	uint32_t node = m_FirstByteNodes[uint8_t(line[0])];
+	for (size_t i = 1; node; i++)
+	{
+		const auto& current = m_Nodes[node];
+		if (current.m_Category >= 0 && (!retVal || current.m_Category < int8_t(*retVal)))
+			retVal = ChatCategory(current.m_Category);
+
+		if (i >= line.size())
+			break;
+
+		node = current.FindChild(line[i]);
+	}
+
+	return retVal;
+}
+
+auto ChatWrapperMatcher::Decode(ChatCategory category, const std::string_view& text,
+	DecodedMessage& message) const -> DecodeResult
+{
+	const auto& type = m_Wrappers.m_Types.at(size_t(category));
+	const std::string_view fullStart = type.m_Full.m_Start.m_Narrow;
+	const std::string_view fullEnd = type.m_Full.m_End.m_Narrow;
+	const std::string_view nameStart = type.m_Name.m_Start.m_Narrow;
+	const std::string_view nameEnd = type.m_Name.m_End.m_Narrow;
+	const std::string_view msgStart = type.m_Message.m_Start.m_Narrow;
+	const std::string_view msgEnd = type.m_Message.m_End.m_Narrow;
+
+	assert(text.starts_with(fullStart));
+
+	const auto bodyEnd = text.find(fullEnd, fullStart.size());
+	if (bodyEnd == text.npos)
+		return DecodeResult::Incomplete;
+
+	const auto body = text.substr(fullStart.size(), bodyEnd - fullStart.size());
+	message.m_TotalLength = bodyEnd + fullEnd.size();
+
+	// The wrappers are always written in this order, so normally a single forward
+	// pass over the body finds all of them.
+	if (const auto nameBegin = body.find(nameStart); nameBegin != body.npos)
+	{
+		const auto nameBodyBegin = nameBegin + nameStart.size();
+		if (const auto nameBodyEnd = body.find(nameEnd, nameBodyBegin); nameBodyEnd != body.npos)
+		{
+			if (const auto msgBegin = body.find(msgStart, nameBodyEnd + nameEnd.size()); msgBegin != body.npos)
+			{
+				const auto msgBodyBegin = msgBegin + msgStart.size();
+				if (const auto msgBodyEnd = body.find(msgEnd, msgBodyBegin); msgBodyEnd != body.npos)
+				{
+					message.m_Name = body.substr(nameBodyBegin, nameBodyEnd - nameBodyBegin);
+					message.m_Message = body.substr(msgBodyBegin, msgBodyEnd - msgBodyBegin);
+					return DecodeResult::Success;
+				}
+			}
+		}
+	}
+
+	// Out of order wrappers (or a message containing them); search for each one independently
+	const auto nameBegin = body.find(nameStart);
+	const auto nameBodyEnd = body.find(nameEnd);
+	const auto msgBegin = body.find(msgStart);
+	const auto msgBodyEnd = body.find(msgEnd);
+	if (nameBegin == body.npos || nameBodyEnd == body.npos || msgBegin == body.npos || msgBodyEnd == body.npos)
+		return DecodeResult::Malformed;
+
+	// An end wrapper before its start wraps around to npos, taking the rest of the body
+	const auto nameBodyBegin = nameBegin + nameStart.size();
+	const auto msgBodyBegin = msgBegin + msgStart.size();
+	message.m_Name = body.substr(nameBodyBegin, nameBodyEnd - nameBodyBegin);
+	message.m_Message = body.substr(msgBodyBegin, msgBodyEnd - msgBodyBegin);
+	return DecodeResult::Success;
+}
+
 ChatFmtStrLengths ChatFmtStrLengths::Max(const ChatFmtStrLengths& other) const
 {
 	ChatFmtStrLengths retVal;
@@ -644,14 +991,15 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 	ChatFmtStrLengths translationLengths;
 
 	{
+		LocalizationCache cache;
 		std::mutex lengthsMutex;
 
 		// Get all the existing translations
-		std::for_each(std::execution::par_unseq, std::begin(LANGUAGES), std::end(LANGUAGES),
+		TaskScheduler::Get().ParallelForEach(TaskPriority::UICritical, std::begin(LANGUAGES), std::end(LANGUAGES),
 			[&](const std::string_view& lang)
 			{
 				const size_t index = &lang - std::begin(LANGUAGES);
-				const auto& localTrans = translations[index] = FindExistingTranslations(tfdir, lang);
+				const auto& localTrans = translations[index] = FindExistingTranslations(tfdir, lang, cache);
 
 				ChatFmtStrLengths localLengths;
 
@@ -672,12 +1020,14 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 
 				IncrementProgress();
 			});
+
+		cache.Save();
 	}
 
 	ChatWrappers wrappers(translationLengths);
 	PrintChatWrappers(wrappers);
 
-	std::for_each(std::execution::par_unseq, std::begin(LANGUAGES), std::end(LANGUAGES),
+	TaskScheduler::Get().ParallelForEach(TaskPriority::UICritical, std::begin(LANGUAGES), std::end(LANGUAGES),
 		[&](const std::string_view& lang)
 		{
 			auto& translationsSet = translations[&lang - std::begin(LANGUAGES)];
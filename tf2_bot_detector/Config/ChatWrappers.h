@@ -7,9 +7,12 @@
 #include <cassert>
 #include <compare>
 #include <filesystem>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace tf2_bot_detector
 {
@@ -101,6 +104,48 @@ namespace tf2_bot_detector
 		std::array<Type, (size_t)ChatCategory::COUNT> m_Types;
 	};
 
+	// ChatWrappers compiled for matching console output. The full message start
+	// wrappers are stored in a trie whose root is a jump table on the first byte,
+	// so lines that can't be chat are rejected after a single lookup.
+	class ChatWrapperMatcher final
+	{
+	public:
+		explicit ChatWrapperMatcher(const ChatWrappers& wrappers);
+
+		// The category whose full wrapper starts the line, lowest category first if several do
+		std::optional<ChatCategory> MatchStart(const std::string_view& line) const;
+
+		enum class DecodeResult
+		{
+			Success,
+			Malformed,   // Found the end of the message, but not the name/message wrappers
+			Incomplete,  // The end of the message hasn't been written yet
+		};
+
+		struct DecodedMessage
+		{
+			std::string_view m_Name;
+			std::string_view m_Message;
+			size_t m_TotalLength = 0; // Including all wrappers
+		};
+
+		// text must start with the full wrapper of the given category
+		DecodeResult Decode(ChatCategory category, const std::string_view& text, DecodedMessage& message) const;
+
+	private:
+		struct TrieNode
+		{
+			std::vector<std::pair<char, uint32_t>> m_Children;
+			int8_t m_Category = -1;
+
+			uint32_t FindChild(char c) const;
+		};
+
+		ChatWrappers m_Wrappers;
+		std::array<uint32_t, 256> m_FirstByteNodes{};
+		std::vector<TrieNode> m_Nodes;
+	};
+
 	void to_json(nlohmann::json& j, const ChatWrappers::WrapperPair& d);
 	void from_json(const nlohmann::json& j, ChatWrappers::WrapperPair& d);
 
@@ -1,14 +1,17 @@
 #pragma once
 #include "Log.h"
 #include "Settings.h"
+#include "TaskScheduler.h"
 
 #include <mh/future.hpp>
 #include <mh/text/fmtstr.hpp>
 #include <mh/text/format.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <future>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -111,7 +114,7 @@ namespace tf2_bot_detector
 		{
 			if (allowAutoupdate)
 			{
-				return std::async([filename, &settings]
+				return TaskScheduler::Get().Run(TaskPriority::Network, [filename, &settings]
 					{
 						return LoadConfigFile<T>(filename, true, settings);
 					});
@@ -128,16 +131,13 @@ namespace tf2_bot_detector
 		}
 	}
 
-	template<typename T, typename TOthers = typename T::collection_type>
+	template<typename T>
 	class ConfigFileGroupBase
 	{
 	public:
-		using collection_type = TOthers;
-
 		ConfigFileGroupBase(const Settings& settings) : m_Settings(&settings) {}
 		virtual ~ConfigFileGroupBase() = default;
 
-		virtual void CombineEntries(collection_type& collection, const T& file) const = 0;
 		virtual std::string GetBaseFileName() const = 0;
 
 		void LoadFiles()
@@ -146,33 +146,83 @@ namespace tf2_bot_detector
 
 			const auto paths = GetConfigFilePaths(GetBaseFileName());
 
-			if (!IsOfficial() && !paths.m_User.empty())
-				m_UserList = LoadConfigFile<T>(paths.m_User, false, *m_Settings);
-
-			if (!paths.m_Official.empty())
-				m_OfficialList = LoadConfigFileAsync<T>(paths.m_Official, !IsOfficial(), *m_Settings);
-			else
-				m_OfficialList = {};
+			// Third party lists are independent of each other, so parse them in parallel and
+			// start on them first. Overall load time is then bounded by the largest list.
+			std::vector<ThirdPartyList> lists;
+			lists.reserve(paths.m_Others.size());
+			for (const auto& file : paths.m_Others)
+			{
+				auto& list = lists.emplace_back();
+				list.m_Path = file;
 
-			m_ThirdPartyLists = std::async([this, paths]
+				// Keep serving the old version of this list until the new one is ready
+				if (auto found = std::find_if(m_ThirdPartyLists.begin(), m_ThirdPartyLists.end(),
+					[&](const ThirdPartyList& old) { return old.m_Path == file; }); found != m_ThirdPartyLists.end())
 				{
-					collection_type collection;
+					list.m_Previous = found->GetSnapshot();
+				}
 
-					for (const auto& file : paths.m_Others)
+				list.m_Loading = TaskScheduler::Get().Run(TaskPriority::Network, [file, settings = m_Settings]() -> std::shared_ptr<const T>
 					{
 						try
 						{
-							auto parsedFile = LoadConfigFile<T>(file, true, *m_Settings);
-							CombineEntries(collection, parsedFile);
+							return std::make_shared<const T>(LoadConfigFile<T>(file, true, *settings));
 						}
 						catch (const std::exception& e)
 						{
 							LogError("Exception when loading "s << file << ": " << e.what());
+							return std::make_shared<const T>();
 						}
-					}
+					});
+			}
+
+			m_ThirdPartyLists = std::move(lists);
+
+			if (!paths.m_Official.empty())
+				m_OfficialList = LoadConfigFileAsync<T>(paths.m_Official, !IsOfficial(), *m_Settings);
+			else
+				m_OfficialList = {};
 
-					return collection;
-				});
+			if (!IsOfficial() && !paths.m_User.empty())
+				m_UserList = LoadConfigFile<T>(paths.m_User, false, *m_Settings);
+		}
+
+		// Third party lists are immutable once loaded and shared by reference, so anything
+		// holding on to a snapshot (or indexing it) stays valid across reloads.
+		struct ThirdPartyList
+		{
+			std::filesystem::path m_Path;
+			std::shared_future<std::shared_ptr<const T>> m_Loading;
+			mutable std::shared_ptr<const T> m_Previous; // From before the last reload, until it finishes
+
+			bool IsLoaded() const { return mh::is_future_ready(m_Loading); }
+			const std::shared_ptr<const T>& GetSnapshot() const
+			{
+				if (!IsLoaded())
+					return m_Previous;
+
+				// Nobody gets handed the old version anymore, so don't keep it around
+				m_Previous.reset();
+				return m_Loading.get();
+			}
+		};
+
+		// Calls func(const T&) for the current snapshot of each third party list, in load order
+		template<typename TFunc>
+		void ForEachLoadedThirdPartyList(TFunc&& func) const
+		{
+			for (const auto& list : m_ThirdPartyLists)
+			{
+				if (const auto& snapshot = list.GetSnapshot())
+					func(*snapshot);
+			}
+		}
+
+		size_t GetThirdPartyListCount() const { return m_ThirdPartyLists.size(); }
+		size_t GetLoadedThirdPartyListCount() const
+		{
+			return std::count_if(m_ThirdPartyLists.begin(), m_ThirdPartyLists.end(),
+				[](const ThirdPartyList& list) { return list.IsLoaded(); });
 		}
 
 		void SaveFiles() const
@@ -233,8 +283,7 @@ namespace tf2_bot_detector
 				retVal += m_OfficialList.get().size();
 			if (m_UserList)
 				retVal += m_UserList->size();
-			if (mh::is_future_ready(m_ThirdPartyLists))
-				retVal += m_ThirdPartyLists.get().size();
+			ForEachLoadedThirdPartyList([&](const T& list) { retVal += list.size(); });
 
 			return retVal;
 		}
@@ -242,7 +291,7 @@ namespace tf2_bot_detector
 		const Settings* m_Settings = nullptr;
 		std::shared_future<T> m_OfficialList;
 		std::optional<T> m_UserList;
-		std::shared_future<collection_type> m_ThirdPartyLists;
+		std::vector<ThirdPartyList> m_ThirdPartyLists;
 	};
 }
 
@@ -9,6 +9,7 @@
 #include <mh/text/string_insertion.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
@@ -222,31 +223,14 @@ void PlayerListJSON::SaveFiles() const
 auto PlayerListJSON::FindPlayerData(const SteamID& id) const ->
 	cppcoro::generator<std::pair<const ConfigFileName&, const PlayerListData&>>
 {
-	if (m_CFGGroup.m_UserList.has_value())
-	{
-		if (auto found = m_CFGGroup.m_UserList->m_Players.find(id);
-			found != m_CFGGroup.m_UserList->m_Players.end())
-		{
-			co_yield { m_CFGGroup.m_UserList->GetName(), found->second };
-		}
-	}
-	if (mh::is_future_ready(m_CFGGroup.m_ThirdPartyLists))
-	{
-		for (auto& file : m_CFGGroup.m_ThirdPartyLists.get())
+	std::vector<std::pair<const ConfigFileName*, const PlayerListData*>> found;
+	ForEachPlayerData(id, [&](const ConfigFileName& fileName, const PlayerListData& data)
 		{
-			if (auto found = file.second.find(id); found != file.second.end())
-				co_yield { file.first, found->second };
-		}
+			found.push_back({ &fileName, &data });
+		});
 
-	}
-	if (mh::is_future_ready(m_CFGGroup.m_OfficialList))
-	{
-		if (auto found = m_CFGGroup.m_OfficialList.get().m_Players.find(id);
-			found != m_CFGGroup.m_OfficialList.get().m_Players.end())
-		{
-			co_yield { m_CFGGroup.m_OfficialList.get().GetName(), found->second };
-		}
-	}
+	for (const auto& [fileName, data] : found)
+		co_yield { *fileName, *data };
 }
 
 auto PlayerListJSON::FindPlayerAttributes(const SteamID& id) const ->
@@ -262,11 +246,11 @@ PlayerMarks PlayerListJSON::GetPlayerAttributes(const SteamID& id) const
 		return {};
 
 	PlayerMarks marks;
-	for (const auto& [file, found] : FindPlayerAttributes(id))
-	{
-		if (found)
-			marks.m_Marks.push_back({ found, file });
-	}
+	ForEachPlayerData(id, [&](const ConfigFileName& file, const PlayerListData& data)
+		{
+			if (data.m_Attributes)
+				marks.m_Marks.push_back({ data.m_Attributes, file });
+		});
 
 	return marks;
 }
@@ -277,12 +261,11 @@ PlayerMarks PlayerListJSON::HasPlayerAttributes(const SteamID& id, const PlayerA
 		return {};
 
 	PlayerMarks marks;
-	for (const auto& [file, found] : FindPlayerAttributes(id))
-	{
-		auto attr = found & attributes;
-		if (attr)
-			marks.m_Marks.push_back({ attr, file });
-	}
+	ForEachPlayerData(id, [&](const ConfigFileName& file, const PlayerListData& data)
+		{
+			if (auto attr = data.m_Attributes & attributes)
+				marks.m_Marks.push_back({ attr, file });
+		});
 
 	return marks;
 }
@@ -351,6 +334,61 @@ ModifyPlayerAction PlayerListJSON::OnPlayerDataChanged(PlayerListData& data)
 	return retVal;
 }
 
+void PlayerListJSON::ThirdPartyIndex::Sync(const ConfigFileGroup& group)
+{
+	const auto& lists = group.m_ThirdPartyLists;
+
+	for (size_t i = lists.size(); i < m_Indexed.size(); i++)
+		Remove(i);
+
+	m_Indexed.resize(lists.size());
+
+	for (size_t i = 0; i < lists.size(); i++)
+	{
+		if (const auto& snapshot = lists[i].GetSnapshot(); snapshot != m_Indexed[i])
+		{
+			Remove(i);
+			m_Indexed[i] = snapshot;
+			Add(i);
+		}
+	}
+}
+
+void PlayerListJSON::ThirdPartyIndex::Add(size_t listIndex)
+{
+	if (!m_Indexed[listIndex])
+		return;
+
+	for (const auto& [id, data] : m_Indexed[listIndex]->m_Players)
+	{
+		// Keep entries in list order, same as looking through each list in turn
+		auto& entries = m_Players[id];
+		auto it = std::find_if(entries.begin(), entries.end(),
+			[&](const Entry& entry) { return entry.m_ListIndex > listIndex; });
+
+		entries.insert(it, Entry{ listIndex, &data });
+	}
+}
+
+void PlayerListJSON::ThirdPartyIndex::Remove(size_t listIndex)
+{
+	if (listIndex >= m_Indexed.size() || !m_Indexed[listIndex])
+		return;
+
+	for (const auto& [id, data] : m_Indexed[listIndex]->m_Players)
+	{
+		auto found = m_Players.find(id);
+		if (found == m_Players.end())
+			continue;
+
+		std::erase_if(found->second, [&](const Entry& entry) { return entry.m_ListIndex == listIndex; });
+		if (found->second.empty())
+			m_Players.erase(found);
+	}
+
+	m_Indexed[listIndex].reset();
+}
+
 PlayerListData::PlayerListData(const SteamID& id) :
 	m_SteamID(id)
 {
@@ -411,11 +449,6 @@ bool PlayerAttributesList::SetAttribute(PlayerAttribute attribute, bool set)
 	}
 }
 
-void PlayerListJSON::ConfigFileGroup::CombineEntries(BaseClass::collection_type& map, const PlayerListFile& file) const
-{
-	map.push_back({ file.GetName(), file.m_Players });
-}
-
 bool PlayerMarks::Has(const PlayerAttributesList& attr) const
 {
 	for (const auto& mark : m_Marks)
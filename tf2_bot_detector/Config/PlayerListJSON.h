@@ -11,7 +11,10 @@
 #include <filesystem>
 #include <future>
 #include <map>
+#include <memory>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace tf2_bot_detector
 {
@@ -157,6 +160,10 @@ namespace tf2_bot_detector
 		bool LoadFiles();
 		void SaveFiles() const;
 
+		// Calls func(const ConfigFileName&, const PlayerListData&) for every list containing id.
+		// Prefer this over FindPlayerData(), it doesn't need to allocate a coroutine frame.
+		template<typename TFunc> void ForEachPlayerData(const SteamID& id, TFunc&& func) const;
+
 		cppcoro::generator<std::pair<const ConfigFileName&, const PlayerListData&>>
 			FindPlayerData(const SteamID& id) const;
 		cppcoro::generator<std::pair<const ConfigFileName&, const PlayerAttributesList&>>
@@ -191,17 +198,71 @@ namespace tf2_bot_detector
 
 		static constexpr int PLAYERLIST_SCHEMA_VERSION = 3;
 
-		struct ConfigFileGroup final : ConfigFileGroupBase<PlayerListFile, std::vector<std::pair<ConfigFileName, PlayerMap_t>>>
+		struct ConfigFileGroup final : ConfigFileGroupBase<PlayerListFile>
 		{
-			using BaseClass = ConfigFileGroupBase;
-
 			using ConfigFileGroupBase::ConfigFileGroupBase;
-			void CombineEntries(BaseClass::collection_type& map, const PlayerListFile& file) const override;
 			std::string GetBaseFileName() const override { return "playerlist"; }
 
 		} m_CFGGroup;
+
+		// Merged view of the third party lists: which of them contain each SteamID. Lists are
+		// indexed individually, so swapping in a reloaded/auto-updated list only costs as
+		// much as that list, and everything else stays shared.
+		class ThirdPartyIndex final
+		{
+		public:
+			void Sync(const ConfigFileGroup& group);
+
+			template<typename TFunc> void ForEach(const SteamID& id, TFunc&& func) const
+			{
+				if (auto found = m_Players.find(id); found != m_Players.end())
+				{
+					for (const auto& entry : found->second)
+						func(*m_Indexed[entry.m_ListIndex], *entry.m_Data);
+				}
+			}
+
+		private:
+			void Add(size_t listIndex);
+			void Remove(size_t listIndex);
+
+			struct Entry
+			{
+				size_t m_ListIndex;
+				const PlayerListData* m_Data;
+			};
+
+			std::vector<std::shared_ptr<const PlayerListFile>> m_Indexed;
+			std::unordered_map<SteamID, std::vector<Entry>> m_Players;
+
+		};
+		mutable ThirdPartyIndex m_ThirdPartyIndex;
 	};
 
+	template<typename TFunc>
+	inline void PlayerListJSON::ForEachPlayerData(const SteamID& id, TFunc&& func) const
+	{
+		if (m_CFGGroup.m_UserList.has_value())
+		{
+			if (auto found = m_CFGGroup.m_UserList->m_Players.find(id);
+				found != m_CFGGroup.m_UserList->m_Players.end())
+			{
+				func(m_CFGGroup.m_UserList->GetName(), found->second);
+			}
+		}
+		m_ThirdPartyIndex.Sync(m_CFGGroup);
+		m_ThirdPartyIndex.ForEach(id, [&](const PlayerListFile& file, const PlayerListData& data)
+			{
+				func(file.GetName(), data);
+			});
+		if (mh::is_future_ready(m_CFGGroup.m_OfficialList))
+		{
+			const auto& officialList = m_CFGGroup.m_OfficialList.get();
+			if (auto found = officialList.m_Players.find(id); found != officialList.m_Players.end())
+				func(officialList.GetName(), found->second);
+		}
+	}
+
 	void to_json(nlohmann::json& j, const PlayerAttribute& d);
 	void from_json(const nlohmann::json& j, PlayerAttribute& d);
 }
@@ -1,9 +1,12 @@
 #include "Rules.h"
 #include "Util/JSONUtils.h"
 #include "IPlayer.h"
+#include "KillStats.h"
 #include "Log.h"
 #include "PlayerListJSON.h"
+#include "PlayerNameIndex.h"
 #include "Settings.h"
+#include "WorldState.h"
 
 #include <mh/text/case_insensitive_string.hpp>
 #include <mh/text/string_insertion.hpp>
@@ -59,6 +62,31 @@ namespace tf2_bot_detector
 		};
 	}
 
+	void to_json(nlohmann::json& j, const KillStatsMatch& d)
+	{
+		j =
+		{
+			{ "min_kills", d.m_MinKills },
+		};
+
+		if (d.m_KillsPerMinute)
+			j["kills_per_minute"] = *d.m_KillsPerMinute;
+		if (d.m_CritRatio)
+			j["crit_ratio"] = *d.m_CritRatio;
+		if (d.m_HeadshotRatio)
+			j["headshot_ratio"] = *d.m_HeadshotRatio;
+		if (d.m_BurstKills)
+			j["burst_kills"] = *d.m_BurstKills;
+	}
+
+	void to_json(nlohmann::json& j, const NameCollisionMatch& d)
+	{
+		j =
+		{
+			{ "ignore_first_joined", d.m_IgnoreFirstJoined },
+		};
+	}
+
 	void to_json(nlohmann::json& j, const ModerationRule::Triggers& d)
 	{
 		size_t count = 0;
@@ -73,6 +101,16 @@ namespace tf2_bot_detector
 			j["username_text_match"] = *d.m_UsernameTextMatch;
 			count++;
 		}
+		if (d.m_KillStatsMatch)
+		{
+			j["kill_stats_match"] = *d.m_KillStatsMatch;
+			count++;
+		}
+		if (d.m_NameCollisionMatch)
+		{
+			j["name_collision_match"] = *d.m_NameCollisionMatch;
+			count++;
+		}
 
 		if (count > 1)
 			j["mode"] = d.m_Mode;
@@ -133,6 +171,25 @@ namespace tf2_bot_detector
 		try_get_to_defaulted(j, d.m_CaseSensitive, "case_sensitive", false);
 	}
 
+	void from_json(const nlohmann::json& j, KillStatsMatch& d)
+	{
+		try_get_to_defaulted(j, d.m_MinKills, "min_kills", uint16_t(10));
+
+		if (auto found = j.find("kills_per_minute"); found != j.end())
+			d.m_KillsPerMinute = found->get<float>();
+		if (auto found = j.find("crit_ratio"); found != j.end())
+			d.m_CritRatio = found->get<float>();
+		if (auto found = j.find("headshot_ratio"); found != j.end())
+			d.m_HeadshotRatio = found->get<float>();
+		if (auto found = j.find("burst_kills"); found != j.end())
+			d.m_BurstKills = found->get<uint16_t>();
+	}
+
+	void from_json(const nlohmann::json& j, NameCollisionMatch& d)
+	{
+		try_get_to_defaulted(j, d.m_IgnoreFirstJoined, "ignore_first_joined", true);
+	}
+
 	void from_json(const nlohmann::json& j, ModerationRule::Triggers& d)
 	{
 		if (auto found = j.find("mode"); found != j.end())
@@ -142,6 +199,10 @@ namespace tf2_bot_detector
 			d.m_ChatMsgTextMatch.emplace(TextMatch(*found));
 		if (auto found = j.find("username_text_match"); found != j.end())
 			d.m_UsernameTextMatch.emplace(TextMatch(*found));
+		if (auto found = j.find("kill_stats_match"); found != j.end())
+			d.m_KillStatsMatch = found->get<KillStatsMatch>();
+		if (auto found = j.find("name_collision_match"); found != j.end())
+			d.m_NameCollisionMatch = found->get<NameCollisionMatch>();
 	}
 
 	void from_json(const nlohmann::json& j, ModerationRule::Actions& d)
@@ -168,6 +229,7 @@ ModerationRules::ModerationRules(const Settings& settings) :
 bool ModerationRules::LoadFiles()
 {
 	m_CFGGroup.LoadFiles();
+	m_LoadCount++;
 	return true;
 }
 
@@ -191,13 +253,32 @@ cppcoro::generator<const ModerationRule&> tf2_bot_detector::ModerationRules::Get
 			co_yield rule;
 	}
 
-	if (mh::is_future_ready(m_CFGGroup.m_ThirdPartyLists))
+	for (const auto& list : m_CFGGroup.m_ThirdPartyLists)
 	{
-		for (const auto& rule : m_CFGGroup.m_ThirdPartyLists.get())
+		// Hold a reference so the rules outlive a reload while we're suspended
+		const auto snapshot = list.GetSnapshot();
+		if (!snapshot)
+			continue;
+
+		for (const auto& rule : snapshot->m_Rules)
 			co_yield rule;
 	}
 }
 
+uint64_t ModerationRules::GetGeneration() const
+{
+	// The official and third party lists are swapped in (possibly after auto-updating)
+	// whenever their futures complete, so fold their readiness into the generation.
+	// Third party lists only ever go from loading to loaded, so counting them is enough.
+	uint64_t generation = uint64_t(m_LoadCount) << 32;
+	if (mh::is_future_ready(m_CFGGroup.m_OfficialList))
+		generation |= 1;
+
+	generation |= uint64_t(m_CFGGroup.GetLoadedThirdPartyListCount()) << 1;
+
+	return generation;
+}
+
 void ModerationRules::RuleFile::ValidateSchema(const ConfigSchemaInfo& schema) const
 {
 	if (schema.m_Type != "rules")
@@ -223,11 +304,6 @@ void ModerationRules::RuleFile::Serialize(nlohmann::json& json) const
 	json["rules"] = m_Rules;
 }
 
-void ModerationRules::ConfigFileGroup::CombineEntries(RuleList_t& list, const RuleFile& file) const
-{
-	list.insert(list.end(), file.m_Rules.begin(), file.m_Rules.end());
-}
-
 bool TextMatch::Match(const std::string_view& text) const
 {
 	switch (m_Mode)
@@ -314,6 +390,53 @@ bool TextMatch::Match(const std::string_view& text) const
 	}
 }
 
+bool KillStatsMatch::Match(const KillStatsSummary& stats) const
+{
+	if (!m_KillsPerMinute && !m_CritRatio && !m_HeadshotRatio && !m_BurstKills)
+		return false;
+
+	if (m_KillsPerMinute && stats.m_KillsPerMinute < *m_KillsPerMinute)
+		return false;
+	if (m_BurstKills && stats.m_MaxBurst < *m_BurstKills)
+		return false;
+	if (m_CritRatio && (stats.m_WindowKills < m_MinKills || stats.m_CritRatio < *m_CritRatio))
+		return false;
+	if (m_HeadshotRatio && (stats.m_HeadshotWeaponKills < m_MinKills || stats.m_HeadshotRatio < *m_HeadshotRatio))
+		return false;
+
+	return true;
+}
+
+bool NameCollisionMatch::Match(const IPlayer& player) const
+{
+	const IWorldState& world = player.GetWorld();
+	const auto collisions = world.GetPlayerNameIndex().GetCollisions(player.GetSteamID());
+	if (collisions.size() < 2)
+		return false;
+
+	if (!m_IgnoreFirstJoined)
+		return true;
+
+	// UserIDs are handed out in join order
+	const auto userID = player.GetUserID();
+	if (!userID)
+		return false;
+
+	for (const SteamID& otherID : collisions)
+	{
+		if (otherID == player.GetSteamID())
+			continue;
+
+		if (const IPlayer* other = world.FindPlayer(otherID))
+		{
+			if (const auto otherUserID = other->GetUserID(); otherUserID && *otherUserID < *userID)
+				return true;
+		}
+	}
+
+	return false;
+}
+
 bool ModerationRule::Match(const IPlayer& player) const
 {
 	return Match(player, std::string_view{});
@@ -345,14 +468,36 @@ bool ModerationRule::Match(const IPlayer& player, const std::string_view& chatMs
 	if (m_Triggers.m_Mode == TriggerMatchMode::MatchAny && chatMsgMatch)
 		return true;
 
+	const bool killStatsMatch = [&]()
+	{
+		if (!m_Triggers.m_KillStatsMatch)
+			return false;
+
+		const auto stats = player.GetData<PlayerKillStats>();
+		if (!stats)
+			return false;
+
+		return m_Triggers.m_KillStatsMatch->Match(stats->GetSummary(player.GetWorld().GetCurrentTime()));
+	}();
+	if (m_Triggers.m_Mode == TriggerMatchMode::MatchAny && killStatsMatch)
+		return true;
+
+	const bool nameCollisionMatch = m_Triggers.m_NameCollisionMatch && m_Triggers.m_NameCollisionMatch->Match(player);
+	if (m_Triggers.m_Mode == TriggerMatchMode::MatchAny && nameCollisionMatch)
+		return true;
+
 	if (m_Triggers.m_Mode == TriggerMatchMode::MatchAll)
 	{
-		if (m_Triggers.m_UsernameTextMatch && m_Triggers.m_ChatMsgTextMatch)
-			return usernameMatch && chatMsgMatch;
-		else if (m_Triggers.m_UsernameTextMatch)
-			return usernameMatch;
-		else if (m_Triggers.m_ChatMsgTextMatch)
-			return chatMsgMatch;
+		if (!m_Triggers.m_UsernameTextMatch && !m_Triggers.m_ChatMsgTextMatch &&
+			!m_Triggers.m_KillStatsMatch && !m_Triggers.m_NameCollisionMatch)
+		{
+			return false;
+		}
+
+		return (!m_Triggers.m_UsernameTextMatch || usernameMatch) &&
+			(!m_Triggers.m_ChatMsgTextMatch || chatMsgMatch) &&
+			(!m_Triggers.m_KillStatsMatch || killStatsMatch) &&
+			(!m_Triggers.m_NameCollisionMatch || nameCollisionMatch);
 	}
 
 	return false;
@@ -4,6 +4,7 @@
 #include <cppcoro/generator.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <vector>
@@ -45,6 +46,29 @@ namespace tf2_bot_detector
 		bool Match(const std::string_view& text) const;
 	};
 
+	struct KillStatsSummary;
+
+	// Thresholds against a player's PlayerKillStats. Every threshold that is set must be reached.
+	struct KillStatsMatch
+	{
+		uint16_t m_MinKills = 10; // Ratios are only trusted once there are at least this many kills to go on
+		std::optional<float> m_KillsPerMinute;
+		std::optional<float> m_CritRatio;
+		std::optional<float> m_HeadshotRatio;
+		std::optional<uint16_t> m_BurstKills;
+
+		bool Match(const KillStatsSummary& stats) const;
+	};
+
+	// Matches players whose name looks the same as another connected player's (see NormalizePlayerName())
+	struct NameCollisionMatch
+	{
+		// Don't match whoever joined first with the name, since that is usually the one being impersonated
+		bool m_IgnoreFirstJoined = true;
+
+		bool Match(const IPlayer& player) const;
+	};
+
 	struct ModerationRule
 	{
 		std::string m_Description;
@@ -58,6 +82,8 @@ namespace tf2_bot_detector
 
 			std::optional<TextMatch> m_UsernameTextMatch;
 			std::optional<TextMatch> m_ChatMsgTextMatch;
+			std::optional<KillStatsMatch> m_KillStatsMatch;
+			std::optional<NameCollisionMatch> m_NameCollisionMatch;
 		} m_Triggers;
 
 		struct Actions
@@ -78,7 +104,13 @@ namespace tf2_bot_detector
 		cppcoro::generator<const ModerationRule&> GetRules() const;
 		size_t GetRuleCount() const { return m_CFGGroup.size(); }
 
+		// Changes whenever the set of rules returned by GetRules() may have changed,
+		// either from an explicit reload or from an async (auto-updated) list finishing loading.
+		uint64_t GetGeneration() const;
+
 	private:
+		uint32_t m_LoadCount = 0;
+
 		using RuleList_t = std::vector<ModerationRule>;
 		struct RuleFile final : SharedConfigFileBase
 		{
@@ -93,10 +125,9 @@ namespace tf2_bot_detector
 
 		static constexpr int RULES_SCHEMA_VERSION = 3;
 
-		struct ConfigFileGroup final : ConfigFileGroupBase<RuleFile, RuleList_t>
+		struct ConfigFileGroup final : ConfigFileGroupBase<RuleFile>
 		{
 			using ConfigFileGroupBase::ConfigFileGroupBase;
-			void CombineEntries(RuleList_t& list, const RuleFile& file) const override;
 			std::string GetBaseFileName() const override { return "rules"; }
 
 		} m_CFGGroup;
@@ -9,6 +9,7 @@
 
 #include <filesystem>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace srcon
@@ -94,9 +95,21 @@ namespace tf2_bot_detector
 			bool m_DebugShowCommands = false;
 
 			uint32_t m_ChatMsgWrappersToken{};
-			std::optional<ChatWrappers> m_ChatMsgWrappers;
+			const std::optional<ChatWrappers>& GetChatMsgWrappers() const { return m_ChatMsgWrappers; }
+			void SetChatMsgWrappers(std::optional<ChatWrappers> wrappers)
+			{
+				m_ChatMsgWrappers = std::move(wrappers);
+				m_ChatMsgWrappersGeneration++;
+			}
+			// Changes every time the chat wrappers are set, so anything compiled from them knows to recompile
+			uint32_t GetChatMsgWrappersGeneration() const { return m_ChatMsgWrappersGeneration; }
+
 			std::unique_ptr<srcon::async_client> m_RCONClient;
 
+		private:
+			std::optional<ChatWrappers> m_ChatMsgWrappers;
+			uint32_t m_ChatMsgWrappersGeneration = 0;
+
 		} m_Unsaved;
 
 		std::optional<bool> m_AllowInternetUsage;
@@ -3,37 +3,39 @@
 
 using namespace tf2_bot_detector;
 
-AutoConsoleLineListener::AutoConsoleLineListener(IWorldState& world) :
-	m_World(&world)
+AutoConsoleLineListener::AutoConsoleLineListener(IWorldState& world, ConsoleLineTypeMask types) :
+	m_World(&world), m_Types(types)
 {
-	m_World->AddConsoleLineListener(this);
+	m_World->AddConsoleLineListener(this, m_Types);
 }
 
 AutoConsoleLineListener::AutoConsoleLineListener(const AutoConsoleLineListener& other) :
-	m_World(other.m_World)
+	m_World(other.m_World), m_Types(other.m_Types)
 {
-	m_World->AddConsoleLineListener(this);
+	m_World->AddConsoleLineListener(this, m_Types);
 }
 
 AutoConsoleLineListener& AutoConsoleLineListener::operator=(const AutoConsoleLineListener& other)
 {
 	m_World->RemoveConsoleLineListener(this);
 	m_World = other.m_World;
-	m_World->AddConsoleLineListener(this);
+	m_Types = other.m_Types;
+	m_World->AddConsoleLineListener(this, m_Types);
 	return *this;
 }
 
 AutoConsoleLineListener::AutoConsoleLineListener(AutoConsoleLineListener&& other) :
-	m_World(other.m_World)
+	m_World(other.m_World), m_Types(other.m_Types)
 {
-	m_World->AddConsoleLineListener(this);
+	m_World->AddConsoleLineListener(this, m_Types);
 }
 
 AutoConsoleLineListener& AutoConsoleLineListener::operator=(AutoConsoleLineListener&& other)
 {
 	m_World->RemoveConsoleLineListener(this);
 	m_World = other.m_World;
-	m_World->AddConsoleLineListener(this);
+	m_Types = other.m_Types;
+	m_World->AddConsoleLineListener(this, m_Types);
 	return *this;
 }
 
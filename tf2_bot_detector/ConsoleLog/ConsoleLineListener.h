@@ -1,14 +1,24 @@
 #pragma once
 
 #include "Clock.h"
+#include "IConsoleLine.h"
 
+#include <chrono>
+#include <cstdint>
 #include <string_view>
 
 namespace tf2_bot_detector
 {
-	class IConsoleLine;
 	class IWorldState;
 
+	// How often (and how expensively) lines of a given type were handed to listeners
+	struct ConsoleLineDispatchStats
+	{
+		uint64_t m_LineCount = 0;
+		uint64_t m_ListenerCalls = 0;
+		std::chrono::steady_clock::duration m_TotalTime{};
+	};
+
 	class IConsoleLineListener
 	{
 	public:
@@ -38,7 +48,8 @@ namespace tf2_bot_detector
 	class AutoConsoleLineListener : public BaseConsoleLineListener
 	{
 	public:
-		AutoConsoleLineListener(IWorldState& world);
+		// Only lines with a type in the mask are passed to OnConsoleLineParsed()
+		AutoConsoleLineListener(IWorldState& world, ConsoleLineTypeMask types = ConsoleLineTypeMask::All());
 		AutoConsoleLineListener(const AutoConsoleLineListener& other);
 		AutoConsoleLineListener& operator=(const AutoConsoleLineListener& other);
 		AutoConsoleLineListener(AutoConsoleLineListener&& other);
@@ -47,5 +58,6 @@ namespace tf2_bot_detector
 
 	private:
 		IWorldState* m_World = nullptr;
+		ConsoleLineTypeMask m_Types;
 	};
 }
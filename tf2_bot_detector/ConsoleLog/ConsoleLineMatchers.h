@@ -0,0 +1,413 @@
+#pragma once
+
+#include "Util/TextScanner.h"
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+// Hand-written matchers for the hottest console line grammars. Each one accepts
+// exactly the strings the original std::regex pattern (noted above it) would
+// regex_match, and returns the same captures as views into the input. Unmatched
+// optional groups are returned as empty views. Tests/ConsoleLineMatcherTests.cpp
+// keeps the original patterns around as a differential oracle.
+namespace tf2_bot_detector::line_matchers
+{
+	namespace detail
+	{
+		// Calls func(closePos) for every ']' on the same line as openPos, rightmost first,
+		// which is the order a greedy \[.*\] tries them in. Stops at the first true.
+		template<typename TFunc>
+		constexpr bool ForEachGreedyBracketClose(std::string_view text, size_t openPos, TFunc&& func)
+		{
+			size_t lineEnd = openPos + 1;
+			while (lineEnd < text.size() && IsLineChar(text[lineEnd]))
+				lineEnd++;
+
+			for (size_t i = lineEnd; i-- > openPos + 1; )
+			{
+				if (text[i] == ']' && func(i))
+					return true;
+			}
+
+			return false;
+		}
+	}
+
+	struct ServerStatusPlayerCaptures
+	{
+		std::string_view m_UserID;
+		std::string_view m_Name;
+		std::string_view m_SteamID;
+		std::string_view m_ConnectedHours;
+		std::string_view m_ConnectedMins;
+		std::string_view m_ConnectedSecs;
+		std::string_view m_Ping;
+		std::string_view m_Loss;
+		std::string_view m_State;
+		std::string_view m_Address;
+	};
+
+	namespace detail
+	{
+		// \s+(?:(\d+):)?(\d+):(\d+)\s+(\d+)\s+(\d+)\s+(\w+)(?:\s+(\S+))?
+		constexpr bool MatchServerStatusPlayerTail(std::string_view text, ServerStatusPlayerCaptures& out)
+		{
+			TextScanner s(text);
+			if (s.Spaces().empty())
+				return false;
+
+			const auto first = s.Digits();
+			if (first.empty() || !s.Char(':'))
+				return false;
+
+			const auto second = s.Digits();
+			if (second.empty())
+				return false;
+
+			if (s.Char(':'))
+			{
+				const auto third = s.Digits();
+				if (third.empty())
+					return false;
+
+				out.m_ConnectedHours = first;
+				out.m_ConnectedMins = second;
+				out.m_ConnectedSecs = third;
+			}
+			else
+			{
+				out.m_ConnectedHours = {};
+				out.m_ConnectedMins = first;
+				out.m_ConnectedSecs = second;
+			}
+
+			if (s.Spaces().empty() || (out.m_Ping = s.Digits()).empty() ||
+				s.Spaces().empty() || (out.m_Loss = s.Digits()).empty() ||
+				s.Spaces().empty() || (out.m_State = s.Word()).empty())
+			{
+				return false;
+			}
+
+			out.m_Address = {};
+			if (s.IsAtEnd())
+				return true;
+
+			if (s.Spaces().empty() || (out.m_Address = s.NonSpaces()).empty())
+				return false;
+
+			return s.IsAtEnd();
+		}
+	}
+
+	// #\s+(\d+)\s+"((?:.|[\r\n])+)"\s+(\[.*\])\s+(?:(\d+):)?(\d+):(\d+)\s+(\d+)\s+(\d+)\s+(\w+)(?:\s+(\S+))?
+	constexpr std::optional<ServerStatusPlayerCaptures> MatchServerStatusPlayerLine(std::string_view text)
+	{
+		ServerStatusPlayerCaptures retVal{};
+
+		TextScanner s(text);
+		if (!s.Char('#') || s.Spaces().empty() || (retVal.m_UserID = s.Digits()).empty() ||
+			s.Spaces().empty() || !s.Char('"'))
+		{
+			return std::nullopt;
+		}
+
+		// The name may contain quotes and is greedy, so the closing quote is the
+		// rightmost one that lets the rest of the line match
+		const size_t nameStart = s.GetPosition();
+		for (size_t quote = text.size(); quote-- > nameStart + 1; )
+		{
+			if (text[quote] != '"')
+				continue;
+
+			TextScanner tail(text.substr(quote + 1));
+			if (tail.Spaces().empty() || !tail.Char('['))
+				continue;
+
+			const size_t open = quote + 1 + tail.GetPosition() - 1;
+			const bool matched = detail::ForEachGreedyBracketClose(text, open, [&](size_t close)
+				{
+					if (!detail::MatchServerStatusPlayerTail(text.substr(close + 1), retVal))
+						return false;
+
+					retVal.m_SteamID = text.substr(open, close - open + 1);
+					return true;
+				});
+
+			if (matched)
+			{
+				retVal.m_Name = text.substr(nameStart, quote - nameStart);
+				return retVal;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	struct LobbyMemberCaptures
+	{
+		std::string_view m_Pending;
+		std::string_view m_Index;
+		std::string_view m_SteamID;
+		std::string_view m_Team;
+		std::string_view m_Type;
+	};
+
+	// \s+(?:(?:Member)|(Pending))\[(\d+)\] (\[.*\])\s+team = (\w+)\s+type = (\w+)
+	constexpr std::optional<LobbyMemberCaptures> MatchLobbyMemberLine(std::string_view text)
+	{
+		LobbyMemberCaptures retVal{};
+
+		TextScanner s(text);
+		if (s.Spaces().empty())
+			return std::nullopt;
+
+		if (!s.Literal("Member"))
+		{
+			const size_t pendingStart = s.GetPosition();
+			if (!s.Literal("Pending"))
+				return std::nullopt;
+
+			retVal.m_Pending = text.substr(pendingStart, s.GetPosition() - pendingStart);
+		}
+
+		if (!s.Char('[') || (retVal.m_Index = s.Digits()).empty() || !s.Literal("] ["))
+			return std::nullopt;
+
+		const size_t open = s.GetPosition() - 1;
+		const bool matched = detail::ForEachGreedyBracketClose(text, open, [&](size_t close)
+			{
+				TextScanner tail(text.substr(close + 1));
+				if (tail.Spaces().empty() || !tail.Literal("team = ") || (retVal.m_Team = tail.Word()).empty() ||
+					tail.Spaces().empty() || !tail.Literal("type = ") || (retVal.m_Type = tail.Word()).empty() ||
+					!tail.IsAtEnd())
+				{
+					return false;
+				}
+
+				retVal.m_SteamID = text.substr(open, close - open + 1);
+				return true;
+			});
+
+		if (!matched)
+			return std::nullopt;
+
+		return retVal;
+	}
+
+	struct KillNotificationCaptures
+	{
+		std::string_view m_AttackerName;
+		std::string_view m_VictimName;
+		std::string_view m_WeaponName;
+		std::string_view m_Crit;
+	};
+
+	// (.*) killed (.*) with (.*)\.( \(crit\))?
+	constexpr std::optional<KillNotificationCaptures> MatchKillNotificationLine(std::string_view text)
+	{
+		constexpr std::string_view KILLED = " killed ";
+		constexpr std::string_view WITH = " with ";
+		constexpr std::string_view CRIT_SUFFIX = ". (crit)";
+
+		for (char c : text)
+		{
+			if (!IsLineChar(c))
+				return std::nullopt;
+		}
+
+		KillNotificationCaptures retVal{};
+		size_t weaponEnd;
+		if (text.ends_with('.'))
+		{
+			weaponEnd = text.size() - 1;
+		}
+		else if (text.ends_with(CRIT_SUFFIX))
+		{
+			weaponEnd = text.size() - CRIT_SUFFIX.size();
+			retVal.m_Crit = text.substr(weaponEnd + 1);
+		}
+		else
+		{
+			return std::nullopt;
+		}
+
+		// Every (.*) is greedy, so each separator is the rightmost one that
+		// still leaves room for the separators after it
+		const auto head = text.substr(0, weaponEnd);
+		const auto withPos = head.rfind(WITH);
+		if (withPos == head.npos)
+			return std::nullopt;
+
+		const auto killedPos = head.substr(0, withPos).rfind(KILLED);
+		if (killedPos == head.npos)
+			return std::nullopt;
+
+		retVal.m_AttackerName = head.substr(0, killedPos);
+		retVal.m_VictimName = head.substr(killedPos + KILLED.size(), withPos - killedPos - KILLED.size());
+		retVal.m_WeaponName = head.substr(withPos + WITH.size());
+		return retVal;
+	}
+
+	struct SplitPacketCaptures
+	{
+		std::string_view m_SocketType;
+		std::string_view m_Index;
+		std::string_view m_Count;
+		std::string_view m_Sequence;
+		std::string_view m_Size;
+		std::string_view m_MTU;
+		std::string_view m_Address;
+	};
+
+	// <-- \[(.{3})\] Split packet +(\d+)\/ +(\d+) seq +(\d+) size +(\d+) mtu +(\d+) from ([0-9.:a-fA-F]+:\d+)
+	constexpr std::optional<SplitPacketCaptures> MatchSplitPacketLine(std::string_view text)
+	{
+		SplitPacketCaptures retVal{};
+
+		TextScanner s(text);
+		if (!s.Literal("<-- [") || (retVal.m_SocketType = s.LineChars(3)).empty() ||
+			!s.Literal("] Split packet") || s.Repeat(' ').empty() || (retVal.m_Index = s.Digits()).empty() ||
+			!s.Char('/') || s.Repeat(' ').empty() || (retVal.m_Count = s.Digits()).empty() ||
+			!s.Literal(" seq") || s.Repeat(' ').empty() || (retVal.m_Sequence = s.Digits()).empty() ||
+			!s.Literal(" size") || s.Repeat(' ').empty() || (retVal.m_Size = s.Digits()).empty() ||
+			!s.Literal(" mtu") || s.Repeat(' ').empty() || (retVal.m_MTU = s.Digits()).empty() ||
+			!s.Literal(" from "))
+		{
+			return std::nullopt;
+		}
+
+		// [0-9.:a-fA-F]+:\d+ has to consume the rest of the line, and since ':' and digits
+		// are both in the leading set, only the last ':' can be the one before the port
+		const auto address = s.GetRemaining();
+		for (char c : address)
+		{
+			if (!IsHexDigitChar(c) && c != '.' && c != ':')
+				return std::nullopt;
+		}
+
+		const auto portSep = address.rfind(':');
+		if (portSep == address.npos || portSep == 0 || portSep == address.size() - 1)
+			return std::nullopt;
+
+		for (char c : address.substr(portSep + 1))
+		{
+			if (!IsDigitChar(c))
+				return std::nullopt;
+		}
+
+		retVal.m_Address = address;
+		return retVal;
+	}
+
+	struct NetStatusConfigCaptures
+	{
+		std::string_view m_PlayerMode;
+		std::string_view m_ServerMode;
+		std::string_view m_ConnectionCount;
+	};
+
+	// - Config: (.*), (.*), (\d+) connections
+	constexpr std::optional<NetStatusConfigCaptures> MatchNetStatusConfigLine(std::string_view text)
+	{
+		constexpr std::string_view PREFIX = "- Config: ";
+		constexpr std::string_view SUFFIX = " connections";
+		constexpr std::string_view SEPARATOR = ", ";
+
+		if (!text.starts_with(PREFIX) || !text.ends_with(SUFFIX) || text.size() < PREFIX.size() + SUFFIX.size())
+			return std::nullopt;
+
+		const auto body = text.substr(PREFIX.size(), text.size() - PREFIX.size() - SUFFIX.size());
+		for (char c : body)
+		{
+			if (!IsLineChar(c))
+				return std::nullopt;
+		}
+
+		// Both (.*) are greedy, so the count follows the last separator and the
+		// player mode ends at the last separator before that
+		const auto countSep = body.rfind(SEPARATOR);
+		if (countSep == body.npos)
+			return std::nullopt;
+
+		NetStatusConfigCaptures retVal{};
+		retVal.m_ConnectionCount = body.substr(countSep + SEPARATOR.size());
+		if (retVal.m_ConnectionCount.empty())
+			return std::nullopt;
+
+		for (char c : retVal.m_ConnectionCount)
+		{
+			if (!IsDigitChar(c))
+				return std::nullopt;
+		}
+
+		const auto modeSep = body.substr(0, countSep).rfind(SEPARATOR);
+		if (modeSep == body.npos)
+			return std::nullopt;
+
+		retVal.m_PlayerMode = body.substr(0, modeSep);
+		retVal.m_ServerMode = body.substr(modeSep + SEPARATOR.size(), countSep - modeSep - SEPARATOR.size());
+		return retVal;
+	}
+
+	// A line of literal text with two decimal captures. In the pattern string,
+	// "{}" stands for (\d+\.\d+) and "{.1}" for (\d+\.\d). The pattern is parsed
+	// at compile time, so a malformed one fails to build rather than to match.
+	class DualDecimalPattern final
+	{
+	public:
+		consteval DualDecimalPattern(std::string_view pattern)
+		{
+			size_t literalStart = 0;
+			for (size_t i = 0; i < 2; i++)
+			{
+				const auto open = pattern.find('{', literalStart);
+				if (open == pattern.npos)
+					throw std::invalid_argument("Expected two placeholders");
+
+				m_Literals[i] = pattern.substr(literalStart, open - literalStart);
+
+				const auto close = pattern.find('}', open);
+				const auto placeholder = pattern.substr(open, close - open + 1);
+				if (placeholder == "{}")
+					m_FractionDigits[i] = 0;
+				else if (placeholder == "{.1}")
+					m_FractionDigits[i] = 1;
+				else
+					throw std::invalid_argument("Unknown placeholder");
+
+				literalStart = close + 1;
+
+				// Decimals are matched greedily without backtracking
+				if (literalStart < pattern.size() && IsDigitChar(pattern[literalStart]))
+					throw std::invalid_argument("A placeholder can't be followed by a digit");
+			}
+
+			m_Literals[2] = pattern.substr(literalStart);
+			if (m_Literals[2].find('{') != m_Literals[2].npos)
+				throw std::invalid_argument("Expected two placeholders");
+		}
+
+		constexpr bool Match(std::string_view text, std::string_view& value0, std::string_view& value1) const
+		{
+			TextScanner s(text);
+			return s.Literal(m_Literals[0]) &&
+				!(value0 = s.Decimal(m_FractionDigits[0])).empty() &&
+				s.Literal(m_Literals[1]) &&
+				!(value1 = s.Decimal(m_FractionDigits[1])).empty() &&
+				s.Literal(m_Literals[2]) &&
+				s.IsAtEnd();
+		}
+
+	private:
+		std::string_view m_Literals[3]{};
+		uint8_t m_FractionDigits[2]{};
+	};
+
+	static_assert(MatchServerStatusPlayerLine(R"(#    348 "a "quoted" name" [U:1:1118537734] 1:00:51  157    0 active)")->m_Name == R"(a "quoted" name)");
+	static_assert(MatchLobbyMemberLine("  Pending[3] [U:1:1] [x]  team = TF_GC_TEAM_INVADERS  type = MATCH_PLAYER")->m_SteamID == "[U:1:1] [x]");
+	static_assert(MatchKillNotificationLine("a killed b with c. (crit)")->m_WeaponName == "c");
+	static_assert(MatchSplitPacketLine("<-- [cl ] Split packet    1/   2 seq  5 size 1260 mtu 1260 from 169.254.0.1:27015")->m_Address == "169.254.0.1:27015");
+	static_assert(MatchNetStatusConfigLine("- Config: Multiplayer, dedicated, 1 connections")->m_ServerMode == "dedicated");
+}
@@ -1,4 +1,5 @@
 #include "ConsoleLines.h"
+#include "ConsoleLineMatchers.h"
 #include "Config/Settings.h"
 #include "GameData/MatchmakingQueue.h"
 #include "GameData/UserMessageType.h"
@@ -221,19 +222,17 @@ LobbyMemberLine::LobbyMemberLine(time_point_t timestamp, const LobbyMember& lobb
 
 std::shared_ptr<IConsoleLine> LobbyMemberLine::TryParse(const std::string_view& text, time_point_t timestamp)
 {
-	static const std::regex s_Regex(R"regex(\s+(?:(?:Member)|(Pending))\[(\d+)\] (\[.*\])\s+team = (\w+)\s+type = (\w+))regex", std::regex::optimize);
-
-	if (svmatch result; std::regex_match(text.begin(), text.end(), result, s_Regex))
+	if (auto result = line_matchers::MatchLobbyMemberLine(text))
 	{
 		LobbyMember member{};
-		member.m_Pending = result[1].matched;
+		member.m_Pending = !result->m_Pending.empty();
 
-		if (!mh::from_chars(std::string_view(&*result[2].first, result[2].length()), member.m_Index))
-			throw std::runtime_error("Failed to parse lobby member regex");
+		if (!mh::from_chars(result->m_Index, member.m_Index))
+			throw std::runtime_error("Failed to parse lobby member index");
 
-		member.m_SteamID = SteamID(std::string_view(&*result[3].first, result[3].length()));
+		member.m_SteamID = SteamID(result->m_SteamID);
 
-		std::string_view teamStr(&*result[4].first, result[4].length());
+		const std::string_view teamStr = result->m_Team;
 
 		if (teamStr == "TF_GC_TEAM_DEFENDERS"sv)
 			member.m_Team = LobbyMemberTeam::Defenders;
@@ -242,7 +241,7 @@ std::shared_ptr<IConsoleLine> LobbyMemberLine::TryParse(const std::string_view&
 		else
 			throw std::runtime_error("Unknown lobby member team");
 
-		std::string_view typeStr(&*result[5].first, result[5].length());
+		const std::string_view typeStr = result->m_Type;
 		if (typeStr == "MATCH_PLAYER"sv)
 			member.m_Type = LobbyMemberType::Player;
 		else if (typeStr == "INVALID_PLAYER"sv)
@@ -328,6 +327,12 @@ void IConsoleLine::AddTypeData(ConsoleLineTypeData data)
 	GetTypeData().push_back(std::move(data));
 }
 
+auto IConsoleLine::GetRegisteredTypes() -> std::vector<ConsoleLineTypeData>
+{
+	const auto& list = GetTypeData();
+	return std::vector<ConsoleLineTypeData>(list.begin(), list.end());
+}
+
 ServerStatusPlayerLine::ServerStatusPlayerLine(time_point_t timestamp, PlayerStatus playerStatus) :
 	BaseClass(timestamp), m_PlayerStatus(std::move(playerStatus))
 {
@@ -335,15 +340,13 @@ ServerStatusPlayerLine::ServerStatusPlayerLine(time_point_t timestamp, PlayerSta
 
 std::shared_ptr<IConsoleLine> ServerStatusPlayerLine::TryParse(const std::string_view& text, time_point_t timestamp)
 {
-	static const std::regex s_Regex(R"regex(#\s+(\d+)\s+"((?:.|[\r\n])+)"\s+(\[.*\])\s+(?:(\d+):)?(\d+):(\d+)\s+(\d+)\s+(\d+)\s+(\w+)(?:\s+(\S+))?)regex", std::regex::optimize);
-
-	if (svmatch result; std::regex_match(text.begin(), text.end(), result, s_Regex))
+	if (auto result = line_matchers::MatchServerStatusPlayerLine(text))
 	{
 		PlayerStatus status{};
 
-		from_chars_throw(result[1], status.m_UserID);
-		status.m_Name = result[2].str();
-		status.m_SteamID = SteamID(std::string_view(&*result[3].first, result[3].length()));
+		from_chars_throw(result->m_UserID, status.m_UserID);
+		status.m_Name = result->m_Name;
+		status.m_SteamID = SteamID(result->m_SteamID);
 
 		// Connected time
 		{
@@ -351,21 +354,21 @@ std::shared_ptr<IConsoleLine> ServerStatusPlayerLine::TryParse(const std::string
 			uint32_t connectedMins;
 			uint32_t connectedSecs;
 
-			if (result[4].matched)
-				from_chars_throw(result[4], connectedHours);
+			if (!result->m_ConnectedHours.empty())
+				from_chars_throw(result->m_ConnectedHours, connectedHours);
 
-			from_chars_throw(result[5], connectedMins);
-			from_chars_throw(result[6], connectedSecs);
+			from_chars_throw(result->m_ConnectedMins, connectedMins);
+			from_chars_throw(result->m_ConnectedSecs, connectedSecs);
 
 			status.m_ConnectionTime = timestamp - ((connectedHours * 1h) + (connectedMins * 1min) + connectedSecs * 1s);
 		}
 
-		from_chars_throw(result[7], status.m_Ping);
-		from_chars_throw(result[8], status.m_Loss);
+		from_chars_throw(result->m_Ping, status.m_Ping);
+		from_chars_throw(result->m_Loss, status.m_Loss);
 
 		// State
 		{
-			const auto state = std::string_view(&*result[9].first, result[9].length());
+			const auto state = result->m_State;
 			if (state == "active"sv)
 				status.m_State = PlayerStatusState::Active;
 			else if (state == "spawning"sv)
@@ -378,7 +381,7 @@ std::shared_ptr<IConsoleLine> ServerStatusPlayerLine::TryParse(const std::string
 				throw std::runtime_error("Unknown player status state "s << std::quoted(state));
 		}
 
-		status.m_Address = result[10].str();
+		status.m_Address = result->m_Address;
 
 		return std::make_shared<ServerStatusPlayerLine>(timestamp, std::move(status));
 	}
@@ -419,12 +422,10 @@ KillNotificationLine::KillNotificationLine(time_point_t timestamp, std::string a
 
 std::shared_ptr<IConsoleLine> KillNotificationLine::TryParse(const std::string_view& text, time_point_t timestamp)
 {
-	static const std::regex s_Regex(R"regex((.*) killed (.*) with (.*)\.( \(crit\))?)regex", std::regex::optimize);
-
-	if (svmatch result; std::regex_match(text.begin(), text.end(), result, s_Regex))
+	if (auto result = line_matchers::MatchKillNotificationLine(text))
 	{
-		return std::make_shared<KillNotificationLine>(timestamp, result[1].str(),
-			result[2].str(), result[3].str(), result[4].matched);
+		return std::make_shared<KillNotificationLine>(timestamp, std::string(result->m_AttackerName),
+			std::string(result->m_VictimName), std::string(result->m_WeaponName), !result->m_Crit.empty());
 	}
 
 	return nullptr;
@@ -490,6 +490,8 @@ namespace tf2_bot_detector
 		void Print(const PrintArgs& args) const override;
 
 		const std::string& GetAddress() const { return m_Address; }
+		bool IsMatchmaking() const { return m_IsMatchmaking; }
+		bool IsRetrying() const { return m_IsRetrying; }
 
 	private:
 		std::string m_Address;
@@ -99,13 +99,8 @@ void ConsoleLogParser::Parse(bool& linesProcessed, bool& snapshotUpdated, bool&
 		readCount = fread(buf, sizeof(buf[0]), std::size(buf), m_File.get());
 		if (readCount > 0)
 		{
-			m_FileLineBuf.append(buf, readCount);
 			ILogManager::GetInstance().LogConsoleOutput(std::string_view(buf, readCount));
-
-			auto parseEnd = m_FileLineBuf.cbegin();
-			ParseChunk(parseEnd, linesProcessed, snapshotUpdated, consoleLinesUpdated);
-
-			m_FileLineBuf.erase(m_FileLineBuf.begin(), parseEnd);
+			AppendAndParse(std::string_view(buf, readCount), linesProcessed, snapshotUpdated, consoleLinesUpdated);
 		}
 
 		if (auto elapsed = clock::now() - startTime; elapsed >= 50ms)
@@ -114,77 +109,91 @@ void ConsoleLogParser::Parse(bool& linesProcessed, bool& snapshotUpdated, bool&
 	} while (readCount > 0);
 }
 
-bool ConsoleLogParser::ParseChatMessage(const std::string_view& lineStr, striter& parseEnd, std::shared_ptr<IConsoleLine>& parsed)
+void ConsoleLogParser::ParseText(const std::string_view& text)
 {
-	for (int i = 0; i < (int)ChatCategory::COUNT; i++)
-	{
-		const auto category = ChatCategory(i);
+	bool snapshotUpdated = false;
+	bool linesProcessed = false;
+	bool consoleLinesUpdated = false;
+	AppendAndParse(text, linesProcessed, snapshotUpdated, consoleLinesUpdated);
 
-		auto& type = m_Settings->m_Unsaved.m_ChatMsgWrappers.value().m_Types[i];
-		if (lineStr.starts_with(type.m_Full.m_Start.m_Narrow))
-		{
-			auto searchBuf = std::string_view(m_FileLineBuf).substr(
-				&*lineStr.begin() - m_FileLineBuf.data() + type.m_Full.m_Start.m_Narrow.size());
+	TrySnapshot(snapshotUpdated);
 
-			if (auto found = searchBuf.find(type.m_Full.m_End.m_Narrow); found != lineStr.npos)
-			{
-				if (found > 512)
-				{
-					LogError("Searched more than 512 characters ("s << found
-						<< ") for the end of the chat msg string, something is terribly wrong!");
-				}
+	if (linesProcessed)
+		m_WorldState->GetConsoleLineListenerBroadcaster().OnConsoleLogChunkParsed(*m_WorldState, consoleLinesUpdated);
+}
 
-				searchBuf = searchBuf.substr(0, found);
+void ConsoleLogParser::AppendAndParse(const std::string_view& text,
+	bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated)
+{
+	m_FileLineBuf.append(text);
+	UpdateChatWrapperMatcher();
 
-				auto nameBegin = searchBuf.find(type.m_Name.m_Start.m_Narrow);
-				auto nameEnd = searchBuf.find(type.m_Name.m_End.m_Narrow);
-				auto msgBegin = searchBuf.find(type.m_Message.m_Start.m_Narrow);
-				auto msgEnd = searchBuf.find(type.m_Message.m_End.m_Narrow);
+	auto parseEnd = m_FileLineBuf.cbegin();
+	ParseChunk(parseEnd, linesProcessed, snapshotUpdated, consoleLinesUpdated);
 
-				if (nameBegin != searchBuf.npos && nameEnd != searchBuf.npos && msgBegin != searchBuf.npos && msgEnd != searchBuf.npos)
-				{
-					const auto name = searchBuf.substr(
-						nameBegin + type.m_Name.m_Start.m_Narrow.size(),
-						nameEnd - nameBegin - type.m_Name.m_Start.m_Narrow.size());
-
-					const auto msg = searchBuf.substr(
-						msgBegin + type.m_Message.m_Start.m_Narrow.size(),
-						msgEnd - msgBegin - type.m_Message.m_Start.m_Narrow.size());
-
-					TeamShareResult teamShareResult = TeamShareResult::Neither;
-					bool isSelf = false;
-					if (auto player = m_WorldState->FindSteamIDForName(name))
-					{
-						teamShareResult = m_WorldState->GetTeamShareResult(*player);
-						isSelf = (player == m_Settings->GetLocalSteamID());
-					}
-
-					parsed = std::make_unique<ChatConsoleLine>(m_WorldState->GetCurrentTime(),
-						std::string(name), std::string(msg), IsDead(category), IsTeam(category), isSelf, teamShareResult);
-				}
-				else
-				{
-					if (nameBegin == searchBuf.npos)
-						LogError("Failed to find name begin sequence in chat message of type "s << category);
-					if (nameEnd == searchBuf.npos)
-						LogError("Failed to find name end sequence in chat message of type "s << category);
-					if (msgBegin == searchBuf.npos)
-						LogError("Failed to find message begin sequence in chat message of type "s << category);
-					if (msgEnd == searchBuf.npos)
-						LogError("Failed to find message end sequence in chat message of type "s << category);
-				}
+	m_FileLineBuf.erase(m_FileLineBuf.begin(), parseEnd);
+}
 
-				parseEnd += type.m_Full.m_Start.m_Narrow.size() + found + type.m_Full.m_End.m_Narrow.size();
-				return true;
-			}
-			else
-			{
-				LogError("Failed to locate chat message wrapper end");
-				return false; // Not enough characters in m_FileLineBuf. Try again later.
-			}
+void ConsoleLogParser::UpdateChatWrapperMatcher()
+{
+	const auto generation = m_Settings->m_Unsaved.GetChatMsgWrappersGeneration();
+	if (generation == m_ChatWrapperMatcherGeneration)
+		return;
+
+	m_ChatWrapperMatcherGeneration = generation;
+	if (const auto& wrappers = m_Settings->m_Unsaved.GetChatMsgWrappers())
+		m_ChatWrapperMatcher.emplace(*wrappers);
+	else
+		m_ChatWrapperMatcher.reset();
+}
+
+bool ConsoleLogParser::ParseChatMessage(const std::string_view& lineStr, striter& parseEnd, std::shared_ptr<IConsoleLine>& parsed)
+{
+	if (!m_ChatWrapperMatcher)
+		return true;
+
+	const auto category = m_ChatWrapperMatcher->MatchStart(lineStr);
+	if (!category)
+		return true;
+
+	// Chat messages may contain newlines, so decode from the rest of the buffer rather than just this line
+	const auto searchBuf = std::string_view(m_FileLineBuf).substr(lineStr.data() - m_FileLineBuf.data());
+
+	ChatWrapperMatcher::DecodedMessage decoded;
+	switch (m_ChatWrapperMatcher->Decode(*category, searchBuf, decoded))
+	{
+	case ChatWrapperMatcher::DecodeResult::Incomplete:
+		LogError("Failed to locate chat message wrapper end");
+		return false; // Not enough characters in m_FileLineBuf. Try again later.
+
+	case ChatWrapperMatcher::DecodeResult::Malformed:
+		LogError("Failed to find name/message wrapper sequences in chat message of type "s << *category);
+		break;
+
+	case ChatWrapperMatcher::DecodeResult::Success:
+	{
+		TeamShareResult teamShareResult = TeamShareResult::Neither;
+		bool isSelf = false;
+		if (auto player = m_WorldState->FindSteamIDForName(decoded.m_Name))
+		{
+			teamShareResult = m_WorldState->GetTeamShareResult(*player);
+			isSelf = (player == m_Settings->GetLocalSteamID());
 		}
+
+		parsed = std::make_unique<ChatConsoleLine>(m_WorldState->GetCurrentTime(),
+			std::string(decoded.m_Name), std::string(decoded.m_Message),
+			IsDead(*category), IsTeam(*category), isSelf, teamShareResult);
+		break;
+	}
+	}
+
+	if (decoded.m_TotalLength > 512)
+	{
+		LogError("Searched more than 512 characters ("s << decoded.m_TotalLength
+			<< ") for the end of the chat msg string, something is terribly wrong!");
 	}
 
+	parseEnd += decoded.m_TotalLength;
 	return true;
 }
 
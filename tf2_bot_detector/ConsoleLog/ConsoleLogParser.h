@@ -1,9 +1,13 @@
 #pragma once
 
 #include "CompensatedTS.h"
+#include "Config/ChatWrappers.h"
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <string_view>
 #include <unordered_set>
 
 namespace tf2_bot_detector
@@ -20,6 +24,9 @@ namespace tf2_bot_detector
 
 		void Update();
 
+		// Parses raw console output as if it had just been appended to the log file
+		void ParseText(const std::string_view& text);
+
 		float GetParseProgress() const { return m_ParseProgress; }
 
 		const CompensatedTS& GetCurrentTimestamp() const { return m_CurrentTimestamp; }
@@ -41,9 +48,15 @@ namespace tf2_bot_detector
 
 		using striter = std::string::const_iterator;
 		void Parse(bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated);
+		void AppendAndParse(const std::string_view& text, bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated);
 		void ParseChunk(striter& parseEnd, bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated);
 		bool ParseChatMessage(const std::string_view& lineStr, striter& parseEnd, std::shared_ptr<IConsoleLine>& parsed);
 
+		// Recompiled whenever the chat wrappers in the settings change
+		void UpdateChatWrapperMatcher();
+		std::optional<ChatWrapperMatcher> m_ChatWrapperMatcher;
+		uint32_t m_ChatWrapperMatcherGeneration = 0;
+
 		struct CustomDeleters
 		{
 			void operator()(FILE*) const;
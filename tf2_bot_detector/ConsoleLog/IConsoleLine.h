@@ -2,9 +2,13 @@
 
 #include "Clock.h"
 
+#include <cstdint>
+#include <initializer_list>
 #include <list>
 #include <memory>
 #include <string_view>
+#include <typeinfo>
+#include <vector>
 
 namespace tf2_bot_detector
 {
@@ -58,6 +62,36 @@ namespace tf2_bot_detector
 		NetChannelChoke,
 		NetChannelFlow,
 		NetChannelTotal,
+
+		COUNT,
+	};
+
+	// Set of ConsoleLineTypes, used to subscribe to only the lines a listener cares about
+	class ConsoleLineTypeMask final
+	{
+	public:
+		constexpr ConsoleLineTypeMask() = default;
+		constexpr ConsoleLineTypeMask(std::initializer_list<ConsoleLineType> types)
+		{
+			for (ConsoleLineType type : types)
+				m_Bits |= GetBit(type);
+		}
+
+		static constexpr ConsoleLineTypeMask All()
+		{
+			ConsoleLineTypeMask retVal;
+			retVal.m_Bits = (uint64_t(1) << size_t(ConsoleLineType::COUNT)) - 1;
+			return retVal;
+		}
+
+		constexpr bool Contains(ConsoleLineType type) const { return (m_Bits & GetBit(type)) != 0; }
+		constexpr bool empty() const { return m_Bits == 0; }
+
+	private:
+		static_assert(size_t(ConsoleLineType::COUNT) < 64);
+		static constexpr uint64_t GetBit(ConsoleLineType type) { return uint64_t(1) << size_t(type); }
+
+		uint64_t m_Bits = 0;
 	};
 
 	enum class ConsoleLineOrdering
@@ -86,7 +120,6 @@ namespace tf2_bot_detector
 
 		time_point_t GetTimestamp() const { return m_Timestamp; }
 
-	protected:
 		using TryParseFunc = std::shared_ptr<IConsoleLine>(*)(const std::string_view& text, time_point_t timestamp);
 		struct ConsoleLineTypeData
 		{
@@ -97,6 +130,10 @@ namespace tf2_bot_detector
 			bool m_AutoParse = true;
 		};
 
+		// A copy of every registered line type, for tests and diagnostics
+		static std::vector<ConsoleLineTypeData> GetRegisteredTypes();
+
+	protected:
 		//static const ConsoleLineTypeData* GetTypeData() { return s_TypeData; }
 		static void AddTypeData(ConsoleLineTypeData data);
 
@@ -1,4 +1,5 @@
 #include "NetworkStatus.h"
+#include "ConsoleLineMatchers.h"
 #include "Util/RegexUtils.h"
 #include "Log.h"
 
@@ -8,9 +9,6 @@ using namespace tf2_bot_detector;
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
-// net_status
-static std::regex s_DataPerClientOut(R"regex(           per client out (\d+\.\d), in (\d+\.\d) kB\/s)regex", std::regex::optimize);
-
 SplitPacketLine::SplitPacketLine(time_point_t timestamp, SplitPacket packet) :
 	BaseClass(timestamp), m_Packet(std::move(packet))
 {
@@ -18,14 +16,12 @@ SplitPacketLine::SplitPacketLine(time_point_t timestamp, SplitPacket packet) :
 
 std::shared_ptr<IConsoleLine> SplitPacketLine::TryParse(const std::string_view& text, time_point_t timestamp)
 {
-	static std::regex s_Regex(R"regex(<-- \[(.{3})\] Split packet +(\d+)\/ +(\d+) seq +(\d+) size +(\d+) mtu +(\d+) from ([0-9.:a-fA-F]+:\d+))regex", std::regex::optimize);
-
-	if (svmatch result; std::regex_match(text.begin(), text.end(), result, s_Regex))
+	if (auto result = line_matchers::MatchSplitPacketLine(text))
 	{
 		SplitPacket packet;
 
 		{
-			auto socket = to_string_view(result[1]);
+			const auto socket = result->m_SocketType;
 			if (socket == "cl "sv)
 				packet.m_SocketType = SocketType::Client;
 			else if (socket == "sv "sv)
@@ -42,16 +38,16 @@ std::shared_ptr<IConsoleLine> SplitPacketLine::TryParse(const std::string_view&
 				throw std::runtime_error("Unknown socket type "s << std::quoted(socket));
 		}
 
-		from_chars_throw(result[2], packet.m_Index);
+		from_chars_throw(result->m_Index, packet.m_Index);
 		assert(packet.m_Index > 0);
 		if (packet.m_Index > 0)
 			packet.m_Index--;
 
-		from_chars_throw(result[3], packet.m_Count);
-		from_chars_throw(result[4], packet.m_Sequence);
-		from_chars_throw(result[5], packet.m_Size);
-		from_chars_throw(result[6], packet.m_MTU);
-		packet.m_Address = result[7].str();
+		from_chars_throw(result->m_Count, packet.m_Count);
+		from_chars_throw(result->m_Sequence, packet.m_Sequence);
+		from_chars_throw(result->m_Size, packet.m_Size);
+		from_chars_throw(result->m_MTU, packet.m_MTU);
+		packet.m_Address = result->m_Address;
 
 		return std::make_shared<SplitPacketLine>(timestamp, std::move(packet));
 	}
@@ -93,11 +89,9 @@ NetStatusConfigLine::NetStatusConfigLine(time_point_t timestamp,
 
 std::shared_ptr<IConsoleLine> NetStatusConfigLine::TryParse(const std::string_view& text, time_point_t timestamp)
 {
-	static const std::regex s_Regex(R"regex(- Config: (.*), (.*), (\d+) connections)regex", std::regex::optimize);
-
-	if (svmatch result; std::regex_match(text.begin(), text.end(), result, s_Regex))
+	if (auto result = line_matchers::MatchNetStatusConfigLine(text))
 	{
-		const std::string_view playerModeStr(&*result[1].first, result[1].length());
+		const std::string_view playerModeStr = result->m_PlayerMode;
 		PlayerMode playerMode;
 		if (playerModeStr == "Multiplayer"sv)
 			playerMode = PlayerMode::Multiplayer;
@@ -109,7 +103,7 @@ std::shared_ptr<IConsoleLine> NetStatusConfigLine::TryParse(const std::string_vi
 			return nullptr;
 		}
 
-		const std::string_view serverModeStr(&*result[2].first, result[2].length());
+		const std::string_view serverModeStr = result->m_ServerMode;
 		ServerMode serverMode;
 		if (serverModeStr == "dedicated"sv)
 			serverMode = ServerMode::Dedicated;
@@ -122,7 +116,7 @@ std::shared_ptr<IConsoleLine> NetStatusConfigLine::TryParse(const std::string_vi
 		}
 
 		unsigned connectionCount;
-		from_chars_throw(result[3], connectionCount);
+		from_chars_throw(result->m_ConnectionCount, connectionCount);
 
 		return std::make_shared<NetStatusConfigLine>(timestamp, playerMode, serverMode, connectionCount);
 	}
@@ -139,14 +133,12 @@ void NetStatusConfigLine::Print(const PrintArgs& args) const
 }
 
 bool NetChannelDualFloatLineBase::TryParse(const std::string_view& text,
-	const std::string_view& pattern, float& f0, float& f1)
+	const line_matchers::DualDecimalPattern& pattern, float& f0, float& f1)
 {
-	const std::regex s_Regex(pattern.data(), pattern.data() + pattern.size());
-
-	if (svmatch result; std::regex_match(text.begin(), text.end(), result, s_Regex))
+	if (std::string_view v0, v1; pattern.Match(text, v0, v1))
 	{
-		from_chars_throw(result[1], f0);
-		from_chars_throw(result[2], f1);
+		from_chars_throw(v0, f0);
+		from_chars_throw(v1, f1);
 		return true;
 	}
 
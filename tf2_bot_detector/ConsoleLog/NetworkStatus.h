@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ConsoleLog/ConsoleLineMatchers.h"
 #include "ConsoleLog/IConsoleLine.h"
 
 #include <string>
@@ -98,7 +99,7 @@ namespace tf2_bot_detector
 		constexpr NetChannelDualFloatLineBase(float f0, float f1) : m_Float0(f0), m_Float1(f1) {}
 
 	protected:
-		static bool TryParse(const std::string_view& text, const std::string_view& pattern, float& f0, float& f1);
+		static bool TryParse(const std::string_view& text, const line_matchers::DualDecimalPattern& pattern, float& f0, float& f1);
 		void Print(const IConsoleLine::PrintArgs& args, const std::string_view& fmtStr) const;
 
 		float GetFloat0() const { return m_Float0; }
@@ -117,7 +118,7 @@ namespace tf2_bot_detector
 	public:
 		static std::shared_ptr<IConsoleLine> TryParse(const std::string_view& text, time_point_t timestamp)
 		{
-			if (float f0, f1; NetChannelDualFloatLineBase::TryParse(text, TSelf::REGEX_PATTERN, f0, f1))
+			if (float f0, f1; NetChannelDualFloatLineBase::TryParse(text, TSelf::MATCH_PATTERN, f0, f1))
 				return std::make_shared<TSelf>(timestamp, f0, f1);
 
 			return nullptr;
@@ -152,7 +153,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetChannelLatencyLoss; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- latency: {.1f}, loss {.2f}";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- latency: (\d+\.\d+), loss (\d+\.\d+))regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- latency: {}, loss {}" };
 	};
 
 	class NetChannelPacketsLine final : public NetChannelDualFloatLine<NetChannelPacketsLine>
@@ -171,7 +172,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetChannelPackets; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- packets: in {.1f}/s, out {.1f}/s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- packets: in (\d+\.\d+)\/s, out (\d+\.\d+)\/s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- packets: in {}/s, out {}/s" };
 	};
 
 	class NetChannelChokeLine final : public NetChannelDualFloatLine<NetChannelChokeLine>
@@ -188,7 +189,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetChannelChoke; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- choke: in {.2f}, out {.2f}";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- choke: in (\d+\.\d+), out (\d+\.\d+))regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- choke: in {}, out {}" };
 	};
 
 	class NetChannelFlowLine final : public NetChannelDualFloatLine<NetChannelFlowLine>
@@ -207,7 +208,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetChannelFlow; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- flow: in {.1f}, out {.1f} KB/s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- flow: in (\d+\.\d+), out (\d+\.\d+) kB\/s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- flow: in {}, out {} kB/s" };
 	};
 
 	class NetChannelTotalLine final : public NetChannelDualFloatLine<NetChannelTotalLine>
@@ -226,7 +227,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetChannelTotal; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- total: in {.1f}, out {.1f} MB";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- total: in (\d+\.\d+), out (\d+\.\d+) MB)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- total: in {}, out {} MB" };
 	};
 
 	class NetLatencyLine final : public NetChannelDualFloatLine<NetLatencyLine>
@@ -245,7 +246,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetLatency; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- Latency: avg out {.2f}s, in {.2f}s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- Latency: avg out (\d+\.\d+)s, in (\d+\.\d+)s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- Latency: avg out {}s, in {}s" };
 	};
 
 	class NetLossLine final : public NetChannelDualFloatLine<NetLossLine>
@@ -264,7 +265,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetLoss; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- Loss:    avg out {.1f}, in {.1f}";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- Loss:    avg out (\d+\.\d+), in (\d+\.\d+))regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- Loss:    avg out {}, in {}" };
 	};
 
 	class NetPacketsTotalLine final : public NetChannelDualFloatLine<NetPacketsTotalLine>
@@ -283,7 +284,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetPacketsTotal; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- Packets: net total out  {.1f}/s, in {.1f}/s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- Packets: net total out  (\d+\.\d)\/s, in (\d+\.\d)\/s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- Packets: net total out  {.1}/s, in {.1}/s" };
 	};
 
 	class NetPacketsPerClientLine final : public NetChannelDualFloatLine<NetPacketsPerClientLine>
@@ -302,7 +303,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetPacketsPerClient; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "           per client out {.1f}/s, in {.1f}/s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(           per client out (\d+\.\d)\/s, in (\d+\.\d)\/s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "           per client out {.1}/s, in {.1}/s" };
 	};
 
 	class NetDataTotalLine final : public NetChannelDualFloatLine<NetDataTotalLine>
@@ -321,7 +322,7 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetDataTotal; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "- Data:    net total out  {.1f}, in {.1f} kB/s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(- Data:    net total out  (\d+\.\d), in (\d+\.\d) kB\/s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "- Data:    net total out  {.1}, in {.1} kB/s" };
 	};
 
 	class NetDataPerClientLine final : public NetChannelDualFloatLine<NetDataPerClientLine>
@@ -340,6 +341,6 @@ namespace tf2_bot_detector
 		ConsoleLineType GetType() const override { return ConsoleLineType::NetDataPerClient; }
 
 		static constexpr std::string_view PRINT_FORMAT_STRING =  "           per client out {.1f}, in {.1f} kB/s";
-		static constexpr std::string_view REGEX_PATTERN = R"regex(           per client out (\d+\.\d), in (\d+\.\d) kB\/s)regex";
+		static constexpr line_matchers::DualDecimalPattern MATCH_PATTERN{ "           per client out {.1}, in {.1} kB/s" };
 	};
 }
@@ -0,0 +1,813 @@
+#include "SessionJournal.h"
+#include "Actions/Actions.h"
+#include "Config/PlayerListJSON.h"
+#include "ConsoleLineListener.h"
+#include "ConsoleLines.h"
+#include "GameData/UserMessageType.h"
+#include "IPlayer.h"
+#include "Log.h"
+#include "WorldEventListener.h"
+#include "WorldState.h"
+
+#include <mh/text/format.hpp>
+#include <mh/text/string_insertion.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	constexpr std::string_view JOURNAL_MAGIC = "TF2BDJNL";
+	constexpr uint64_t JOURNAL_VERSION = 1;
+
+	// Console line types are stored as these tags rather than as ConsoleLineType, so adding
+	// or reordering console line types doesn't change the meaning of journals already on disk.
+	// The values are what ConsoleLineType was when version 1 was written.
+	enum class LineTag : uint8_t
+	{
+		Chat = 1,
+		Ping = 2,
+		LobbyStatusFailed = 3,
+		LobbyChanged = 4,
+		LobbyHeader = 6,
+		LobbyMember = 7,
+		PlayerStatus = 9,
+		PlayerStatusShort = 11,
+		PlayerStatusCount = 12,
+		ClientReachedServerSpawn = 14,
+		KillNotification = 15,
+		SVC_UserMessage = 20,
+		ConfigExec = 21,
+		Connecting = 23,
+		HostNewGame = 24,
+		ServerDroppedPlayer = 29,
+	};
+
+	// Everything else is stored as its underlying value. If one of these fails, add the new
+	// value at the end of its enum instead, or bump JOURNAL_VERSION.
+	static_assert(int(SessionJournalRecordType::ConsoleLine) == 0 && int(SessionJournalRecordType::Votekick) == 5);
+	static_assert(int(LobbyChangeType::Created) == 0 && int(LobbyChangeType::Destroyed) == 2);
+	static_assert(int(LobbyMemberTeam::Invaders) == 0 && int(LobbyMemberTeam::Defenders) == 1);
+	static_assert(int(LobbyMemberType::Player) == 0 && int(LobbyMemberType::InvalidPlayer) == 1);
+	static_assert(int(TeamShareResult::SameTeams) == 0 && int(TeamShareResult::Neither) == 2);
+	static_assert(int(PlayerStatusState::Invalid) == 0 && int(PlayerStatusState::Active) == 4);
+	static_assert(int(PlayerAttribute::Cheater) == 0 && int(PlayerAttribute::Racist) == 3);
+	static_assert(int(KickReason::Other) == 0 && int(KickReason::Scamming) == 3);
+
+	LineTag ToLineTag(ConsoleLineType type)
+	{
+		switch (type)
+		{
+		case ConsoleLineType::Chat:                      return LineTag::Chat;
+		case ConsoleLineType::Ping:                      return LineTag::Ping;
+		case ConsoleLineType::LobbyStatusFailed:         return LineTag::LobbyStatusFailed;
+		case ConsoleLineType::LobbyChanged:              return LineTag::LobbyChanged;
+		case ConsoleLineType::LobbyHeader:               return LineTag::LobbyHeader;
+		case ConsoleLineType::LobbyMember:               return LineTag::LobbyMember;
+		case ConsoleLineType::PlayerStatus:              return LineTag::PlayerStatus;
+		case ConsoleLineType::PlayerStatusShort:         return LineTag::PlayerStatusShort;
+		case ConsoleLineType::PlayerStatusCount:         return LineTag::PlayerStatusCount;
+		case ConsoleLineType::ClientReachedServerSpawn:  return LineTag::ClientReachedServerSpawn;
+		case ConsoleLineType::KillNotification:          return LineTag::KillNotification;
+		case ConsoleLineType::SVC_UserMessage:           return LineTag::SVC_UserMessage;
+		case ConsoleLineType::ConfigExec:                return LineTag::ConfigExec;
+		case ConsoleLineType::Connecting:                return LineTag::Connecting;
+		case ConsoleLineType::HostNewGame:               return LineTag::HostNewGame;
+		case ConsoleLineType::ServerDroppedPlayer:       return LineTag::ServerDroppedPlayer;
+
+		default:
+			throw std::invalid_argument(mh::format("{}: Unexpected ConsoleLineType {}", __FUNCTION__, int(type)));
+		}
+	}
+	ConsoleLineType FromLineTag(LineTag tag)
+	{
+		switch (tag)
+		{
+		case LineTag::Chat:                      return ConsoleLineType::Chat;
+		case LineTag::Ping:                      return ConsoleLineType::Ping;
+		case LineTag::LobbyStatusFailed:         return ConsoleLineType::LobbyStatusFailed;
+		case LineTag::LobbyChanged:              return ConsoleLineType::LobbyChanged;
+		case LineTag::LobbyHeader:               return ConsoleLineType::LobbyHeader;
+		case LineTag::LobbyMember:               return ConsoleLineType::LobbyMember;
+		case LineTag::PlayerStatus:              return ConsoleLineType::PlayerStatus;
+		case LineTag::PlayerStatusShort:         return ConsoleLineType::PlayerStatusShort;
+		case LineTag::PlayerStatusCount:         return ConsoleLineType::PlayerStatusCount;
+		case LineTag::ClientReachedServerSpawn:  return ConsoleLineType::ClientReachedServerSpawn;
+		case LineTag::KillNotification:          return ConsoleLineType::KillNotification;
+		case LineTag::SVC_UserMessage:           return ConsoleLineType::SVC_UserMessage;
+		case LineTag::ConfigExec:                return ConsoleLineType::ConfigExec;
+		case LineTag::Connecting:                return ConsoleLineType::Connecting;
+		case LineTag::HostNewGame:               return ConsoleLineType::HostNewGame;
+		case LineTag::ServerDroppedPlayer:       return ConsoleLineType::ServerDroppedPlayer;
+		}
+
+		throw std::runtime_error(mh::format("Unknown console line tag {} in session journal", int(tag)));
+	}
+
+	// Every individual account on the public universe has these bits set, so storing
+	// the difference keeps most steamids down to the size of their account id.
+	constexpr uint64_t STEAMID_BASE = 76561197960265728;
+
+	int64_t ToMilliseconds(time_point_t time)
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+	}
+	time_point_t FromMilliseconds(int64_t ms)
+	{
+		return time_point_t(std::chrono::duration_cast<duration_t>(std::chrono::milliseconds(ms)));
+	}
+
+	void WriteVarint(std::string& output, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			output += char((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		output += char(value);
+	}
+	void WriteZigzag(std::string& output, int64_t value)
+	{
+		WriteVarint(output, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+	}
+	void WriteByte(std::string& output, uint8_t value)
+	{
+		output += char(value);
+	}
+	void WriteString(std::string& output, const std::string_view& str)
+	{
+		WriteVarint(output, str.size());
+		output.append(str);
+	}
+	void WriteSteamID(std::string& output, const SteamID& id)
+	{
+		WriteVarint(output, id.ID64 ^ STEAMID_BASE);
+	}
+
+	class ByteReader final
+	{
+	public:
+		ByteReader(const std::string_view& data, size_t pos, size_t end) : m_Data(data), m_Pos(pos), m_End(end) {}
+
+		size_t GetPos() const { return m_Pos; }
+
+		uint64_t ReadVarint()
+		{
+			uint64_t value = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				const uint8_t b = ReadByte();
+				value |= uint64_t(b & 0x7F) << shift;
+				if (!(b & 0x80))
+					return value;
+			}
+
+			throw std::runtime_error("Session journal varint is too long");
+		}
+		int64_t ReadZigzag()
+		{
+			const uint64_t value = ReadVarint();
+			return int64_t(value >> 1) ^ -int64_t(value & 1);
+		}
+		uint8_t ReadByte()
+		{
+			if (m_Pos >= m_End)
+				throw std::runtime_error("Unexpected end of session journal block");
+
+			return uint8_t(m_Data[m_Pos++]);
+		}
+		bool ReadBool() { return ReadByte() != 0; }
+		std::string ReadString()
+		{
+			const uint64_t length = ReadVarint();
+			if (length > (m_End - m_Pos))
+				throw std::runtime_error("Session journal string runs past the end of its block");
+
+			std::string retVal(m_Data.substr(m_Pos, size_t(length)));
+			m_Pos += size_t(length);
+			return retVal;
+		}
+		SteamID ReadSteamID() { return SteamID(ReadVarint() ^ STEAMID_BASE); }
+
+	private:
+		std::string_view m_Data;
+		size_t m_Pos;
+		size_t m_End;
+	};
+
+	void EncodeLine(std::string& output, const IConsoleLine& line)
+	{
+		switch (line.GetType())
+		{
+		case ConsoleLineType::LobbyStatusFailed:
+		case ConsoleLineType::HostNewGame:
+		case ConsoleLineType::ClientReachedServerSpawn:
+			break;
+
+		case ConsoleLineType::LobbyHeader:
+		{
+			auto& header = static_cast<const LobbyHeaderLine&>(line);
+			WriteVarint(output, header.GetMemberCount());
+			WriteVarint(output, header.GetPendingCount());
+			break;
+		}
+		case ConsoleLineType::LobbyChanged:
+			WriteByte(output, uint8_t(static_cast<const LobbyChangedLine&>(line).GetChangeType()));
+			break;
+		case ConsoleLineType::LobbyMember:
+		{
+			const auto& member = static_cast<const LobbyMemberLine&>(line).GetLobbyMember();
+			WriteSteamID(output, member.m_SteamID);
+			WriteVarint(output, member.m_Index);
+			WriteByte(output, uint8_t(member.m_Team));
+			WriteByte(output, uint8_t(member.m_Type));
+			WriteByte(output, member.m_Pending);
+			break;
+		}
+		case ConsoleLineType::Connecting:
+		{
+			auto& connecting = static_cast<const ConnectingLine&>(line);
+			WriteString(output, connecting.GetAddress());
+			WriteByte(output, connecting.IsMatchmaking());
+			WriteByte(output, connecting.IsRetrying());
+			break;
+		}
+		case ConsoleLineType::Chat:
+		{
+			auto& chat = static_cast<const ChatConsoleLine&>(line);
+			WriteString(output, chat.GetPlayerName());
+			WriteString(output, chat.GetMessage());
+			WriteByte(output, uint8_t(chat.IsDead() | (chat.IsTeam() << 1) | (chat.IsSelf() << 2)));
+			WriteByte(output, uint8_t(chat.GetTeamShareResult()));
+			break;
+		}
+		case ConsoleLineType::ServerDroppedPlayer:
+		{
+			auto& dropped = static_cast<const ServerDroppedPlayerLine&>(line);
+			WriteString(output, dropped.GetPlayerName());
+			WriteString(output, dropped.GetReason());
+			break;
+		}
+		case ConsoleLineType::ConfigExec:
+		{
+			auto& exec = static_cast<const ConfigExecLine&>(line);
+			WriteString(output, exec.GetConfigFileName());
+			WriteByte(output, exec.IsSuccessful());
+			break;
+		}
+		case ConsoleLineType::Ping:
+		{
+			auto& ping = static_cast<const PingLine&>(line);
+			WriteVarint(output, ping.GetPing());
+			WriteString(output, ping.GetPlayerName());
+			break;
+		}
+		case ConsoleLineType::PlayerStatus:
+		{
+			const auto& status = static_cast<const ServerStatusPlayerLine&>(line).GetPlayerStatus();
+			WriteString(output, status.m_Name);
+			WriteString(output, status.m_Address);
+			WriteSteamID(output, status.m_SteamID);
+			WriteZigzag(output, ToMilliseconds(line.GetTimestamp()) - ToMilliseconds(status.m_ConnectionTime));
+			WriteVarint(output, status.m_UserID);
+			WriteVarint(output, status.m_Ping);
+			WriteByte(output, status.m_Loss);
+			WriteByte(output, uint8_t(status.m_State));
+			break;
+		}
+		case ConsoleLineType::PlayerStatusCount:
+		{
+			auto& count = static_cast<const ServerStatusPlayerCountLine&>(line);
+			WriteByte(output, count.GetPlayerCount());
+			WriteByte(output, count.GetBotCount());
+			WriteByte(output, count.GetMaxPlayerCount());
+			break;
+		}
+		case ConsoleLineType::PlayerStatusShort:
+		{
+			const auto& status = static_cast<const ServerStatusShortPlayerLine&>(line).GetPlayerStatus();
+			WriteString(output, status.m_Name);
+			WriteByte(output, status.m_ClientIndex);
+			break;
+		}
+		case ConsoleLineType::KillNotification:
+		{
+			auto& kill = static_cast<const KillNotificationLine&>(line);
+			WriteString(output, kill.GetAttackerName());
+			WriteString(output, kill.GetVictimName());
+			WriteString(output, kill.GetWeaponName());
+			WriteByte(output, kill.WasCrit());
+			break;
+		}
+		case ConsoleLineType::SVC_UserMessage:
+		{
+			auto& userMsg = static_cast<const SVCUserMessageLine&>(line);
+			WriteString(output, userMsg.GetAddress());
+			WriteVarint(output, uint64_t(userMsg.GetUserMessageType()));
+			WriteVarint(output, userMsg.GetUserMessageBytes());
+			break;
+		}
+
+		default:
+			throw std::invalid_argument(mh::format("{}: Unexpected ConsoleLineType {}", __FUNCTION__, int(line.GetType())));
+		}
+	}
+
+	std::shared_ptr<IConsoleLine> DecodeLine(ByteReader& reader, ConsoleLineType type, time_point_t timestamp)
+	{
+		switch (type)
+		{
+		case ConsoleLineType::LobbyStatusFailed:
+			return std::make_shared<LobbyStatusFailedLine>(timestamp);
+		case ConsoleLineType::HostNewGame:
+			return std::make_shared<HostNewGameLine>(timestamp);
+		case ConsoleLineType::ClientReachedServerSpawn:
+			return std::make_shared<ClientReachedServerSpawnLine>(timestamp);
+
+		case ConsoleLineType::LobbyHeader:
+		{
+			const auto memberCount = unsigned(reader.ReadVarint());
+			const auto pendingCount = unsigned(reader.ReadVarint());
+			return std::make_shared<LobbyHeaderLine>(timestamp, memberCount, pendingCount);
+		}
+		case ConsoleLineType::LobbyChanged:
+			return std::make_shared<LobbyChangedLine>(timestamp, LobbyChangeType(reader.ReadByte()));
+		case ConsoleLineType::LobbyMember:
+		{
+			LobbyMember member{};
+			member.m_SteamID = reader.ReadSteamID();
+			member.m_Index = unsigned(reader.ReadVarint());
+			member.m_Team = LobbyMemberTeam(reader.ReadByte());
+			member.m_Type = LobbyMemberType(reader.ReadByte());
+			member.m_Pending = reader.ReadBool();
+			return std::make_shared<LobbyMemberLine>(timestamp, member);
+		}
+		case ConsoleLineType::Connecting:
+		{
+			auto address = reader.ReadString();
+			const bool isMatchmaking = reader.ReadBool();
+			const bool isRetrying = reader.ReadBool();
+			return std::make_shared<ConnectingLine>(timestamp, std::move(address), isMatchmaking, isRetrying);
+		}
+		case ConsoleLineType::Chat:
+		{
+			auto playerName = reader.ReadString();
+			auto message = reader.ReadString();
+			const uint8_t flags = reader.ReadByte();
+			const auto teamShare = TeamShareResult(reader.ReadByte());
+			return std::make_shared<ChatConsoleLine>(timestamp, std::move(playerName), std::move(message),
+				(flags & 1) != 0, (flags & 2) != 0, (flags & 4) != 0, teamShare);
+		}
+		case ConsoleLineType::ServerDroppedPlayer:
+		{
+			auto playerName = reader.ReadString();
+			auto reason = reader.ReadString();
+			return std::make_shared<ServerDroppedPlayerLine>(timestamp, std::move(playerName), std::move(reason));
+		}
+		case ConsoleLineType::ConfigExec:
+		{
+			auto fileName = reader.ReadString();
+			const bool success = reader.ReadBool();
+			return std::make_shared<ConfigExecLine>(timestamp, std::move(fileName), success);
+		}
+		case ConsoleLineType::Ping:
+		{
+			const auto ping = uint16_t(reader.ReadVarint());
+			return std::make_shared<PingLine>(timestamp, ping, reader.ReadString());
+		}
+		case ConsoleLineType::PlayerStatus:
+		{
+			PlayerStatus status{};
+			status.m_Name = reader.ReadString();
+			status.m_Address = reader.ReadString();
+			status.m_SteamID = reader.ReadSteamID();
+			status.m_ConnectionTime = timestamp - std::chrono::milliseconds(reader.ReadZigzag());
+			status.m_UserID = UserID_t(reader.ReadVarint());
+			status.m_Ping = uint16_t(reader.ReadVarint());
+			status.m_Loss = reader.ReadByte();
+			status.m_State = PlayerStatusState(reader.ReadByte());
+			return std::make_shared<ServerStatusPlayerLine>(timestamp, std::move(status));
+		}
+		case ConsoleLineType::PlayerStatusCount:
+		{
+			const uint8_t playerCount = reader.ReadByte();
+			const uint8_t botCount = reader.ReadByte();
+			const uint8_t maxPlayers = reader.ReadByte();
+			return std::make_shared<ServerStatusPlayerCountLine>(timestamp, playerCount, botCount, maxPlayers);
+		}
+		case ConsoleLineType::PlayerStatusShort:
+		{
+			PlayerStatusShort status{};
+			status.m_Name = reader.ReadString();
+			status.m_ClientIndex = reader.ReadByte();
+			return std::make_shared<ServerStatusShortPlayerLine>(timestamp, std::move(status));
+		}
+		case ConsoleLineType::KillNotification:
+		{
+			auto attackerName = reader.ReadString();
+			auto victimName = reader.ReadString();
+			auto weaponName = reader.ReadString();
+			const bool wasCrit = reader.ReadBool();
+			return std::make_shared<KillNotificationLine>(timestamp, std::move(attackerName),
+				std::move(victimName), std::move(weaponName), wasCrit);
+		}
+		case ConsoleLineType::SVC_UserMessage:
+		{
+			auto address = reader.ReadString();
+			const auto msgType = UserMessageType(reader.ReadVarint());
+			const auto msgBytes = uint16_t(reader.ReadVarint());
+			return std::make_shared<SVCUserMessageLine>(timestamp, std::move(address), msgType, msgBytes);
+		}
+
+		default:
+			throw std::runtime_error(mh::format("Unexpected ConsoleLineType {} in session journal", int(type)));
+		}
+	}
+}
+
+ConsoleLineTypeMask tf2_bot_detector::GetJournaledConsoleLineTypes()
+{
+	return
+	{
+		ConsoleLineType::LobbyHeader,
+		ConsoleLineType::LobbyStatusFailed,
+		ConsoleLineType::LobbyChanged,
+		ConsoleLineType::HostNewGame,
+		ConsoleLineType::Connecting,
+		ConsoleLineType::ClientReachedServerSpawn,
+		ConsoleLineType::Chat,
+		ConsoleLineType::ServerDroppedPlayer,
+		ConsoleLineType::ConfigExec,
+		ConsoleLineType::LobbyMember,
+		ConsoleLineType::Ping,
+		ConsoleLineType::PlayerStatus,
+		ConsoleLineType::PlayerStatusCount,
+		ConsoleLineType::PlayerStatusShort,
+		ConsoleLineType::KillNotification,
+		ConsoleLineType::SVC_UserMessage,
+	};
+}
+
+void SessionJournalEncoder::BeginRecord(SessionJournalRecordType type, time_point_t timestamp)
+{
+	const int64_t ms = ToMilliseconds(timestamp);
+	if (m_BlockRecordCount == 0)
+		m_BlockTime = ms;
+
+	WriteByte(m_Block, uint8_t(type));
+	WriteZigzag(m_Block, ms - m_BlockTime);
+	m_BlockRecordCount++;
+}
+
+bool SessionJournalEncoder::AddConsoleLine(const IConsoleLine& line)
+{
+	if (!GetJournaledConsoleLineTypes().Contains(line.GetType()))
+		return false;
+
+	BeginRecord(SessionJournalRecordType::ConsoleLine, line.GetTimestamp());
+	WriteByte(m_Block, uint8_t(ToLineTag(line.GetType())));
+	EncodeLine(m_Block, line);
+	return true;
+}
+
+void SessionJournalEncoder::AddPlayerJoined(time_point_t timestamp, const SteamID& id, const std::string_view& name)
+{
+	BeginRecord(SessionJournalRecordType::PlayerJoined, timestamp);
+	WriteSteamID(m_Block, id);
+	WriteString(m_Block, name);
+}
+
+void SessionJournalEncoder::AddPlayerLeft(time_point_t timestamp, const SteamID& id, const std::string_view& name)
+{
+	BeginRecord(SessionJournalRecordType::PlayerLeft, timestamp);
+	WriteSteamID(m_Block, id);
+	WriteString(m_Block, name);
+}
+
+void SessionJournalEncoder::AddPlayerMark(time_point_t timestamp, const SteamID& id, PlayerAttribute attribute, bool set)
+{
+	BeginRecord(set ? SessionJournalRecordType::PlayerMarked : SessionJournalRecordType::PlayerUnmarked, timestamp);
+	WriteSteamID(m_Block, id);
+	WriteByte(m_Block, uint8_t(attribute));
+}
+
+void SessionJournalEncoder::AddVotekick(time_point_t timestamp, const SteamID& id, KickReason reason)
+{
+	BeginRecord(SessionJournalRecordType::Votekick, timestamp);
+	WriteSteamID(m_Block, id);
+	WriteByte(m_Block, uint8_t(reason));
+}
+
+void SessionJournalEncoder::Flush(std::string& output)
+{
+	if (!m_HeaderWritten)
+	{
+		output.append(JOURNAL_MAGIC);
+		WriteVarint(output, JOURNAL_VERSION);
+		m_HeaderWritten = true;
+	}
+
+	if (m_BlockRecordCount == 0)
+		return;
+
+	std::string blockHeader;
+	WriteZigzag(blockHeader, m_BlockTime);
+	WriteVarint(blockHeader, m_BlockRecordCount);
+
+	WriteVarint(output, blockHeader.size() + m_Block.size());
+	output.append(blockHeader);
+	output.append(m_Block);
+
+	m_Block.clear();
+	m_BlockRecordCount = 0;
+}
+
+SessionJournalReader::SessionJournalReader(std::string data) :
+	m_Data(std::move(data))
+{
+	if (!std::string_view(m_Data).starts_with(JOURNAL_MAGIC))
+		throw std::runtime_error("Not a session journal");
+
+	ByteReader reader(m_Data, JOURNAL_MAGIC.size(), m_Data.size());
+	if (const auto version = reader.ReadVarint(); version != JOURNAL_VERSION)
+		throw std::runtime_error(mh::format("Unsupported session journal version {}", version));
+
+	m_Pos = m_BlockEnd = reader.GetPos();
+}
+
+SessionJournalReader SessionJournalReader::FromFile(const std::filesystem::path& fileName)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.good())
+		throw std::runtime_error(mh::format("Failed to open {}", fileName));
+
+	std::string data(std::istreambuf_iterator<char>(file), {});
+	return SessionJournalReader(std::move(data));
+}
+
+bool SessionJournalReader::NextBlock()
+{
+	while (m_BlockRecordsLeft == 0)
+	{
+		m_Pos = m_BlockEnd;
+		if (m_Pos >= m_Data.size())
+			return false;
+
+		try
+		{
+			ByteReader reader(m_Data, m_Pos, m_Data.size());
+			const uint64_t blockSize = reader.ReadVarint();
+			if (blockSize > (m_Data.size() - reader.GetPos()))
+				return false; // Truncated final block
+
+			m_BlockEnd = reader.GetPos() + size_t(blockSize);
+
+			reader = ByteReader(m_Data, reader.GetPos(), m_BlockEnd);
+			m_BlockTime = reader.ReadZigzag();
+			m_BlockRecordsLeft = size_t(reader.ReadVarint());
+			m_Pos = reader.GetPos();
+		}
+		catch (const std::runtime_error&)
+		{
+			// Truncated in the middle of a block header
+			m_BlockEnd = m_Data.size();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::optional<time_point_t> SessionJournalReader::PeekTimestamp()
+{
+	if (!NextBlock())
+		return std::nullopt;
+
+	ByteReader reader(m_Data, m_Pos, m_BlockEnd);
+	reader.ReadByte();
+	return FromMilliseconds(m_BlockTime + reader.ReadZigzag());
+}
+
+bool SessionJournalReader::ReadNext(SessionJournalRecord& record)
+{
+	if (!NextBlock())
+		return false;
+
+	ByteReader reader(m_Data, m_Pos, m_BlockEnd);
+	record.m_Type = SessionJournalRecordType(reader.ReadByte());
+	record.m_Timestamp = FromMilliseconds(m_BlockTime + reader.ReadZigzag());
+	record.m_Line.reset();
+	record.m_PlayerName.clear();
+
+	switch (record.m_Type)
+	{
+	case SessionJournalRecordType::ConsoleLine:
+	{
+		const auto lineType = FromLineTag(LineTag(reader.ReadByte()));
+		record.m_Line = DecodeLine(reader, lineType, record.m_Timestamp);
+		break;
+	}
+	case SessionJournalRecordType::PlayerJoined:
+	case SessionJournalRecordType::PlayerLeft:
+		record.m_SteamID = reader.ReadSteamID();
+		record.m_PlayerName = reader.ReadString();
+		break;
+	case SessionJournalRecordType::PlayerMarked:
+	case SessionJournalRecordType::PlayerUnmarked:
+		record.m_SteamID = reader.ReadSteamID();
+		record.m_Attribute = PlayerAttribute(reader.ReadByte());
+		break;
+	case SessionJournalRecordType::Votekick:
+		record.m_SteamID = reader.ReadSteamID();
+		record.m_KickReason = KickReason(reader.ReadByte());
+		break;
+
+	default:
+		throw std::runtime_error(mh::format("Unknown session journal record type {}", int(record.m_Type)));
+	}
+
+	m_Pos = reader.GetPos();
+	m_BlockRecordsLeft--;
+	return true;
+}
+
+SessionJournalReplayer::SessionJournalReplayer(IWorldState& world, SessionJournalReader& reader) :
+	m_World(&world), m_Reader(&reader)
+{
+}
+
+bool SessionJournalReplayer::ReplayUntil(time_point_t time, const EventFunc& onEvent)
+{
+	IConsoleLineListener& listeners = m_World->GetConsoleLineListenerBroadcaster();
+
+	bool linesReplayed = false;
+	bool moreRecords = false;
+	while (true)
+	{
+		const auto nextTime = m_Reader->PeekTimestamp();
+		if (!nextTime)
+			break;
+
+		if (*nextTime > time)
+		{
+			moreRecords = true;
+			break;
+		}
+
+		m_Reader->ReadNext(m_Record);
+		if (m_Record.m_Line)
+		{
+			m_World->UpdateTimestamp(m_Record.m_Timestamp);
+			listeners.OnConsoleLineParsed(*m_World, *m_Record.m_Line);
+			linesReplayed = true;
+		}
+		else if (onEvent)
+		{
+			onEvent(m_Record);
+		}
+	}
+
+	if (linesReplayed)
+		listeners.OnConsoleLogChunkParsed(*m_World, true);
+
+	return moreRecords;
+}
+
+namespace
+{
+	class SessionJournalWriter final : public ISessionJournalWriter, AutoConsoleLineListener, AutoWorldEventListener
+	{
+	public:
+		SessionJournalWriter(IWorldState& world, std::filesystem::path fileName, std::ofstream file);
+		~SessionJournalWriter();
+
+		const std::filesystem::path& GetFileName() const override { return m_FileName; }
+
+		void RecordPlayerMark(const SteamID& id, PlayerAttribute attribute, bool set) override;
+		void RecordVotekick(const SteamID& id, KickReason reason) override;
+
+		void Flush() override;
+
+	private:
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override;
+		void OnConsoleLogChunkParsed(IWorldState& world, bool consoleLinesParsed) override;
+		void OnPlayerJoined(IWorldState& world, IPlayer& player) override;
+		void OnPlayerLeft(IWorldState& world, IPlayer& player) override;
+
+		// Blocks are written once they get big enough, or old enough that
+		// we'd lose more than a few seconds if we crashed.
+		static constexpr size_t MAX_BLOCK_SIZE = 16 * 1024;
+		static constexpr duration_t MAX_BLOCK_AGE = 5s;
+		void FlushIfNeeded();
+
+		IWorldState* m_World = nullptr;
+		std::filesystem::path m_FileName;
+		std::ofstream m_File;
+		SessionJournalEncoder m_Encoder;
+		std::string m_WriteBuffer;
+		time_point_t m_LastFlush{};
+	};
+}
+
+std::unique_ptr<ISessionJournalWriter> ISessionJournalWriter::Create(IWorldState& world)
+{
+	const auto logDir = std::filesystem::path("logs") / "journal";
+
+	std::error_code ec;
+	std::filesystem::create_directories(logDir, ec);
+	if (ec)
+	{
+		LogWarning("Failed to create directory {}. This session will not be journaled.", logDir);
+		return nullptr;
+	}
+
+	const auto t = ToTM(clock_t::now());
+	auto fileName = logDir / mh::format("session_{}.tf2bdj", std::put_time(&t, "%Y-%m-%d_%H-%M-%S"));
+
+	std::ofstream file(fileName, std::ofstream::binary | std::ofstream::trunc);
+	if (!file.good())
+	{
+		LogWarning("Failed to open session journal {}. This session will not be journaled.", fileName);
+		return nullptr;
+	}
+
+	return std::make_unique<SessionJournalWriter>(world, std::move(fileName), std::move(file));
+}
+
+SessionJournalWriter::SessionJournalWriter(IWorldState& world, std::filesystem::path fileName, std::ofstream file) :
+	AutoConsoleLineListener(world, GetJournaledConsoleLineTypes()),
+	AutoWorldEventListener(world),
+	m_World(&world),
+	m_FileName(std::move(fileName)),
+	m_File(std::move(file)),
+	m_LastFlush(clock_t::now())
+{
+	Flush();
+}
+
+SessionJournalWriter::~SessionJournalWriter()
+{
+	Flush();
+}
+
+void SessionJournalWriter::RecordPlayerMark(const SteamID& id, PlayerAttribute attribute, bool set)
+{
+	m_Encoder.AddPlayerMark(m_World->GetCurrentTime(), id, attribute, set);
+	FlushIfNeeded();
+}
+
+void SessionJournalWriter::RecordVotekick(const SteamID& id, KickReason reason)
+{
+	m_Encoder.AddVotekick(m_World->GetCurrentTime(), id, reason);
+	FlushIfNeeded();
+}
+
+void SessionJournalWriter::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
+{
+	m_Encoder.AddConsoleLine(line);
+	if (m_Encoder.GetBlockSize() >= MAX_BLOCK_SIZE)
+		Flush();
+}
+
+void SessionJournalWriter::OnConsoleLogChunkParsed(IWorldState& world, bool consoleLinesParsed)
+{
+	FlushIfNeeded();
+}
+
+void SessionJournalWriter::OnPlayerJoined(IWorldState& world, IPlayer& player)
+{
+	m_Encoder.AddPlayerJoined(world.GetCurrentTime(), player.GetSteamID(), player.GetNameUnsafe());
+}
+
+void SessionJournalWriter::OnPlayerLeft(IWorldState& world, IPlayer& player)
+{
+	m_Encoder.AddPlayerLeft(world.GetCurrentTime(), player.GetSteamID(), player.GetNameUnsafe());
+}
+
+void SessionJournalWriter::FlushIfNeeded()
+{
+	if (m_Encoder.GetBlockSize() >= MAX_BLOCK_SIZE || (clock_t::now() - m_LastFlush) >= MAX_BLOCK_AGE)
+		Flush();
+}
+
+void SessionJournalWriter::Flush()
+{
+	m_LastFlush = clock_t::now();
+
+	m_Encoder.Flush(m_WriteBuffer);
+	if (m_WriteBuffer.empty())
+		return;
+
+	m_File.write(m_WriteBuffer.data(), m_WriteBuffer.size());
+	m_File.flush();
+	m_WriteBuffer.clear();
+
+	if (!m_File.good())
+		LogError(MH_SOURCE_LOCATION_CURRENT(), "Failed to write to session journal {}", m_FileName);
+}
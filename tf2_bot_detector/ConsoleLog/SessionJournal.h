@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Clock.h"
+#include "IConsoleLine.h"
+#include "SteamID.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	enum class KickReason;
+	enum class PlayerAttribute;
+	class IWorldState;
+
+	// A session journal is a compact, append-only binary log of everything WorldState is built
+	// from (plus joins, marks and votekicks), so a session can be rebuilt later without re-parsing
+	// console.log. The file is a header followed by blocks:
+	//   header: "TF2BDJNL", varint version
+	//   block:  varint payload size, zigzag block time (ms since epoch), varint record count, records
+	//   record: u8 SessionJournalRecordType, zigzag ms from the block time, type-specific fields
+	// Integers are LEB128 varints (zigzag encoded if signed), strings are a varint length followed
+	// by the bytes, and steamids are stored relative to the first public individual account.
+	// Stored in journals, so only ever add to the end of this
+	enum class SessionJournalRecordType : uint8_t
+	{
+		ConsoleLine,  // Followed by a u8 tag for the ConsoleLineType
+		PlayerJoined,
+		PlayerLeft,
+		PlayerMarked,
+		PlayerUnmarked,
+		Votekick,
+	};
+
+	struct SessionJournalRecord
+	{
+		SessionJournalRecordType m_Type{};
+		time_point_t m_Timestamp{};
+
+		std::shared_ptr<IConsoleLine> m_Line;  // ConsoleLine
+		SteamID m_SteamID;                      // Everything else
+		std::string m_PlayerName;               // PlayerJoined, PlayerLeft
+		PlayerAttribute m_Attribute{};          // PlayerMarked, PlayerUnmarked
+		KickReason m_KickReason{};              // Votekick
+	};
+
+	// The console line types that are journaled: the ones WorldState consumes
+	ConsoleLineTypeMask GetJournaledConsoleLineTypes();
+
+	class SessionJournalEncoder final
+	{
+	public:
+		// Returns false if this type of line isn't journaled
+		bool AddConsoleLine(const IConsoleLine& line);
+		void AddPlayerJoined(time_point_t timestamp, const SteamID& id, const std::string_view& name);
+		void AddPlayerLeft(time_point_t timestamp, const SteamID& id, const std::string_view& name);
+		void AddPlayerMark(time_point_t timestamp, const SteamID& id, PlayerAttribute attribute, bool set);
+		void AddVotekick(time_point_t timestamp, const SteamID& id, KickReason reason);
+
+		// Closes the current block (if it has any records) and appends everything encoded
+		// since the last call to output. The first call also writes the file header.
+		void Flush(std::string& output);
+
+		size_t GetBlockSize() const { return m_Block.size(); }
+		size_t GetBlockRecordCount() const { return m_BlockRecordCount; }
+
+	private:
+		void BeginRecord(SessionJournalRecordType type, time_point_t timestamp);
+
+		bool m_HeaderWritten = false;
+		std::string m_Block;
+		size_t m_BlockRecordCount = 0;
+		int64_t m_BlockTime = 0;
+	};
+
+	class SessionJournalReader final
+	{
+	public:
+		// Throws std::runtime_error if this isn't a (supported) session journal
+		explicit SessionJournalReader(std::string data);
+		static SessionJournalReader FromFile(const std::filesystem::path& fileName);
+
+		// Decodes the next record, returning false at the end of the journal. A truncated final
+		// block (we were closed mid-write) is treated as the end. Throws on corrupted records.
+		bool ReadNext(SessionJournalRecord& record);
+
+		// Time of the next record, without decoding it
+		std::optional<time_point_t> PeekTimestamp();
+
+	private:
+		bool NextBlock();
+
+		std::string m_Data;
+		size_t m_Pos = 0;
+		size_t m_BlockEnd = 0;
+		size_t m_BlockRecordsLeft = 0;
+		int64_t m_BlockTime = 0;
+	};
+
+	// Rebuilds a WorldState from a journal. Lines go straight to the world's console line listeners,
+	// exactly like ConsoleLogParser would hand them over, with the world's clock set to each line's time.
+	class SessionJournalReplayer final
+	{
+	public:
+		SessionJournalReplayer(IWorldState& world, SessionJournalReader& reader);
+
+		using EventFunc = std::function<void(const SessionJournalRecord& record)>;
+
+		// Replays every record up to and including the given time. Records that aren't console
+		// lines (joins, marks, votekicks) are passed to onEvent. Returns false once the journal is exhausted.
+		bool ReplayUntil(time_point_t time, const EventFunc& onEvent = nullptr);
+		void ReplayAll(const EventFunc& onEvent = nullptr) { ReplayUntil(time_point_t::max(), onEvent); }
+
+	private:
+		IWorldState* m_World = nullptr;
+		SessionJournalReader* m_Reader = nullptr;
+		SessionJournalRecord m_Record;
+	};
+
+	class ISessionJournalWriter
+	{
+	public:
+		virtual ~ISessionJournalWriter() = default;
+
+		// Starts a new journal in logs/journal, recording everything that happens in the world from now on.
+		// Returns nullptr (after logging a warning) if the file can't be created.
+		static std::unique_ptr<ISessionJournalWriter> Create(IWorldState& world);
+
+		virtual const std::filesystem::path& GetFileName() const = 0;
+
+		virtual void RecordPlayerMark(const SteamID& id, PlayerAttribute attribute, bool set) = 0;
+		virtual void RecordVotekick(const SteamID& id, KickReason reason) = 0;
+
+		virtual void Flush() = 0;
+	};
+}
@@ -731,7 +731,22 @@ namespace
 
 DiscordState::DiscordState(const Settings& settings, IWorldState& world) :
 	AutoWorldEventListener(world),
-	AutoConsoleLineListener(world),
+	AutoConsoleLineListener(world,
+		{
+			ConsoleLineType::PlayerStatusMapPosition,
+			ConsoleLineType::PartyHeader,
+			ConsoleLineType::LobbyHeader,
+			ConsoleLineType::LobbyStatusFailed,
+			ConsoleLineType::QueueStateChange,
+			ConsoleLineType::InQueue,
+			ConsoleLineType::LobbyChanged,
+			ConsoleLineType::ServerJoin,
+			ConsoleLineType::HostNewGame,
+			ConsoleLineType::PlayerStatusIP,
+			ConsoleLineType::NetStatusConfig,
+			ConsoleLineType::Connecting,
+			ConsoleLineType::SVC_UserMessage,
+		}),
 	m_Settings(settings),
 	m_WorldState(world),
 	m_GameState(settings, m_DRPInfo),
@@ -1,14 +1,13 @@
 #pragma once
 
 #include "Clock.h"
+#include "PlayerDataStorage.h"
 #include "SteamID.h"
 #include "TFConstants.h"
 
-#include <any>
 #include <cstdint>
 #include <optional>
 #include <ostream>
-#include <typeindex>
 
 namespace tf2_bot_detector
 {
@@ -73,33 +72,23 @@ namespace tf2_bot_detector
 
 		template<typename T> inline T* GetData()
 		{
-			return const_cast<T*>(std::as_const(*this).GetData<T>());
+			return GetDataStorage().Find<T>();
 		}
 		template<typename T, typename... TArgs> inline T& GetOrCreateData(TArgs&&... args)
 		{
-			auto& storage = GetOrCreateDataStorage(typeid(T));
-			if (!storage.has_value())
-				return storage.emplace<T>(std::forward<TArgs>(args)...);
-			else
-				return std::any_cast<T&>(storage);
+			return GetDataStorage().GetOrCreate<T>(std::forward<TArgs>(args)...);
 		}
 		template<typename T> inline const T* GetData() const
 		{
-			return std::any_cast<T>(FindDataStorage(typeid(T)));
+			return GetDataStorage().Find<T>();
 		}
-		template<typename T> inline bool SetData(T&& value)
+		template<typename T> inline T& SetData(T value)
 		{
-			GetOrCreateDataStorage(typeid(T)) = std::move(value);
+			return GetDataStorage().Set<T>(std::move(value));
 		}
 
-		virtual std::any& GetOrCreateDataStorage(const std::type_index& type) = 0;
-
-	protected:
-		virtual const std::any* FindDataStorage(const std::type_index& type) const = 0;
-		virtual std::any* FindDataStorage(const std::type_index& type)
-		{
-			return const_cast<std::any*>(std::as_const(*this).FindDataStorage(type));
-		}
+		virtual PlayerDataStorage& GetDataStorage() = 0;
+		virtual const PlayerDataStorage& GetDataStorage() const = 0;
 	};
 }
 
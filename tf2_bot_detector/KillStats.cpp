@@ -0,0 +1,127 @@
+#include "KillStats.h"
+
+#include <algorithm>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+bool tf2_bot_detector::IsHeadshotWeapon(const std::string_view& weaponName)
+{
+	static constexpr std::string_view HEADSHOT_WEAPONS[] =
+	{
+		"ambassador"sv,
+		"awper_hand"sv,
+		"bazaar_bargain"sv,
+		"festive_ambassador"sv,
+		"festive_huntsman"sv,
+		"festive_sniperrifle"sv,
+		"huntsman"sv,
+		"machina"sv,
+		"player_penetration"sv,
+		"pro_rifle"sv,
+		"shooting_star"sv,
+		"sniperrifle"sv,
+		"tf_projectile_arrow"sv,
+		"the_classic"sv,
+	};
+	static_assert(std::is_sorted(std::begin(HEADSHOT_WEAPONS), std::end(HEADSHOT_WEAPONS)));
+
+	return std::binary_search(std::begin(HEADSHOT_WEAPONS), std::end(HEADSHOT_WEAPONS), weaponName);
+}
+
+void PlayerKillStats::AddKill(time_point_t time, const std::string_view& weaponName, bool wasCrit)
+{
+	// Keep the windows monotonic even if timestamps wobble a bit
+	if (m_End > m_Begin)
+		time = std::max(time, GetEvent(m_End - 1).m_Time);
+
+	if ((m_End - m_Begin) == MAX_EVENTS)
+		PopFront();
+
+	uint8_t flags = 0;
+	if (wasCrit)
+	{
+		flags |= EVENT_CRIT;
+		m_Crits++;
+	}
+	if (IsHeadshotWeapon(weaponName))
+	{
+		flags |= EVENT_HEADSHOT_WEAPON;
+		m_HeadshotWeaponKills++;
+		if (wasCrit)
+			m_Headshots++;
+	}
+
+	m_Events[m_End % MAX_EVENTS] = Event{ time, flags };
+	m_End++;
+	m_TotalKills++;
+
+	while (GetEvent(m_Begin).m_Time < (time - RATIO_WINDOW))
+		PopFront();
+
+	m_RateBegin = SkipOlderThan(std::max(m_RateBegin, m_Begin), time - RATE_WINDOW);
+	m_BurstBegin = SkipOlderThan(std::max(m_BurstBegin, m_Begin), time - BURST_WINDOW);
+	m_MaxBurst = std::max(m_MaxBurst, uint16_t(m_End - m_BurstBegin));
+}
+
+KillStatsSummary PlayerKillStats::GetSummary(time_point_t now) const
+{
+	KillStatsSummary retVal;
+	retVal.m_MaxBurst = m_MaxBurst;
+	retVal.m_TotalKills = m_TotalKills;
+
+	// The counters are as of the last kill, take out anything that has aged out since then
+	uint16_t crits = m_Crits;
+	uint16_t headshotWeaponKills = m_HeadshotWeaponKills;
+	uint16_t headshots = m_Headshots;
+
+	uint64_t begin = m_Begin;
+	for (; begin < m_End && GetEvent(begin).m_Time < (now - RATIO_WINDOW); begin++)
+	{
+		const auto flags = GetEvent(begin).m_Flags;
+		if (flags & EVENT_CRIT)
+			crits--;
+		if (flags & EVENT_HEADSHOT_WEAPON)
+		{
+			headshotWeaponKills--;
+			if (flags & EVENT_CRIT)
+				headshots--;
+		}
+	}
+
+	retVal.m_WindowKills = uint16_t(m_End - begin);
+	retVal.m_HeadshotWeaponKills = headshotWeaponKills;
+	if (retVal.m_WindowKills > 0)
+		retVal.m_CritRatio = float(crits) / retVal.m_WindowKills;
+	if (headshotWeaponKills > 0)
+		retVal.m_HeadshotRatio = float(headshots) / headshotWeaponKills;
+
+	const auto rateKills = m_End - SkipOlderThan(std::max(m_RateBegin, begin), now - RATE_WINDOW);
+	retVal.m_KillsPerMinute = float(rateKills) / std::chrono::duration<float, std::chrono::minutes::period>(RATE_WINDOW).count();
+	retVal.m_CurrentBurst = uint16_t(m_End - SkipOlderThan(std::max(m_BurstBegin, begin), now - BURST_WINDOW));
+
+	return retVal;
+}
+
+uint64_t PlayerKillStats::SkipOlderThan(uint64_t sequence, time_point_t time) const
+{
+	while (sequence < m_End && GetEvent(sequence).m_Time < time)
+		sequence++;
+
+	return sequence;
+}
+
+void PlayerKillStats::PopFront()
+{
+	const auto flags = GetEvent(m_Begin).m_Flags;
+	if (flags & EVENT_CRIT)
+		m_Crits--;
+	if (flags & EVENT_HEADSHOT_WEAPON)
+	{
+		m_HeadshotWeaponKills--;
+		if (flags & EVENT_CRIT)
+			m_Headshots--;
+	}
+
+	m_Begin++;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// Weapons that can land headshots. Headshot kills are reported as crits in the kill feed.
+	bool IsHeadshotWeapon(const std::string_view& weaponName);
+
+	struct KillStatsSummary
+	{
+		uint16_t m_WindowKills = 0;         // Kills within RATIO_WINDOW
+		float m_KillsPerMinute = 0;         // Over RATE_WINDOW
+		float m_CritRatio = 0;              // Crit kills / kills, within RATIO_WINDOW
+		uint16_t m_HeadshotWeaponKills = 0; // Kills with headshot capable weapons, within RATIO_WINDOW
+		float m_HeadshotRatio = 0;          // Headshots / headshot weapon kills, within RATIO_WINDOW
+		uint16_t m_CurrentBurst = 0;        // Kills within the last BURST_WINDOW
+		uint16_t m_MaxBurst = 0;            // Most kills ever seen within a single BURST_WINDOW
+		uint32_t m_TotalKills = 0;
+	};
+
+	// Sliding window statistics over the kills a player has made. Memory use is fixed
+	// no matter how long the session is, and adding a kill is amortized O(1).
+	class PlayerKillStats final
+	{
+	public:
+		static constexpr size_t MAX_EVENTS = 64;
+		static constexpr duration_t RATIO_WINDOW = std::chrono::minutes(5);
+		static constexpr duration_t RATE_WINDOW = std::chrono::minutes(1);
+		static constexpr duration_t BURST_WINDOW = std::chrono::seconds(10);
+
+		void AddKill(time_point_t time, const std::string_view& weaponName, bool wasCrit);
+
+		KillStatsSummary GetSummary(time_point_t now) const;
+		uint32_t GetTotalKills() const { return m_TotalKills; }
+
+	private:
+		enum EventFlags : uint8_t
+		{
+			EVENT_CRIT = (1 << 0),
+			EVENT_HEADSHOT_WEAPON = (1 << 1),
+		};
+
+		struct Event
+		{
+			time_point_t m_Time{};
+			uint8_t m_Flags = 0;
+		};
+
+		// Events are addressed by sequence number, m_Begin <= seq < m_End
+		const Event& GetEvent(uint64_t sequence) const { return m_Events[sequence % MAX_EVENTS]; }
+		uint64_t SkipOlderThan(uint64_t sequence, time_point_t time) const;
+		void PopFront();
+
+		std::array<Event, MAX_EVENTS> m_Events{};
+		uint64_t m_Begin = 0;
+		uint64_t m_End = 0;
+		uint64_t m_RateBegin = 0;
+		uint64_t m_BurstBegin = 0;
+
+		// Counts over [m_Begin, m_End)
+		uint16_t m_Crits = 0;
+		uint16_t m_HeadshotWeaponKills = 0;
+		uint16_t m_Headshots = 0;
+
+		uint16_t m_MaxBurst = 0;
+		uint32_t m_TotalKills = 0;
+	};
+}
@@ -38,7 +38,7 @@ namespace
 		void LogToStream(std::string msg, std::ostream& output, time_point_t timestamp = clock_t::now(), bool skipScrub = false) const;
 
 		const std::filesystem::path& GetFileName() const override { return m_FileName; }
-		cppcoro::generator<const LogMessage&> GetVisibleMsgs() const override;
+		VisibleLogMessages GetVisibleMsgs() const override;
 		void ClearVisibleMsgs() override;
 
 		std::ofstream& GetFile() { return m_File; }
@@ -55,6 +55,7 @@ namespace
 		mutable std::recursive_mutex m_LogMutex;
 		std::deque<LogMessage> m_LogMessages;
 		size_t m_VisibleLogMessagesStart = 0;
+		size_t m_ErasedLogMessages = 0;  // Dropped from the front of m_LogMessages
 
 		struct Secret
 		{
@@ -222,22 +223,31 @@ void LogManager::Log(std::string msg, const LogMessageColor & color,
 
 		if (m_LogMessages.size() > MAX_LOG_MESSAGES)
 		{
-			m_LogMessages.erase(m_LogMessages.begin(),
-				std::next(m_LogMessages.begin(), m_LogMessages.size() - MAX_LOG_MESSAGES));
+			const size_t eraseCount = m_LogMessages.size() - MAX_LOG_MESSAGES;
+			m_LogMessages.erase(m_LogMessages.begin(), std::next(m_LogMessages.begin(), eraseCount));
+			m_ErasedLogMessages += eraseCount;
+			m_VisibleLogMessagesStart -= std::min(m_VisibleLogMessagesStart, eraseCount);
 		}
 	}
 }
 
-cppcoro::generator<const LogMessage&> LogManager::GetVisibleMsgs() const
+VisibleLogMessages LogManager::GetVisibleMsgs() const
 {
-	std::lock_guard lock(m_LogMutex);
+	std::unique_lock lock(m_LogMutex);
 
 	size_t start = m_VisibleLogMessagesStart;
 	if (m_LogMessages.size() > MAX_LOG_MESSAGES)
 		start = std::max(start, m_LogMessages.size() - MAX_LOG_MESSAGES);
 
-	for (size_t i = start; i < m_LogMessages.size(); i++)
-		co_yield m_LogMessages[i];
+	start = std::min(start, m_LogMessages.size());
+	return VisibleLogMessages(std::move(lock), m_LogMessages.begin() + start, m_LogMessages.end(),
+		m_ErasedLogMessages + start);
+}
+
+cppcoro::generator<const LogMessage&> ILogManager::GenerateVisibleMsgs() const
+{
+	for (const LogMessage& msg : GetVisibleMsgs())
+		co_yield msg;
 }
 
 void LogManager::ClearVisibleMsgs()
@@ -265,6 +275,8 @@ void LogManager::CleanupLogFiles() try
 		std::lock_guard lock(m_ConsoleLogMutex);
 		DeleteOldFiles("logs/console", MAX_LOG_LIFETIME);
 	}
+
+	DeleteOldFiles("logs/journal", MAX_LOG_LIFETIME);
 }
 catch (const std::filesystem::filesystem_error& e)
 {
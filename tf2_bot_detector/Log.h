@@ -6,7 +6,9 @@
 #include <mh/text/format.hpp>
 #include <mh/source_location.hpp>
 
+#include <deque>
 #include <filesystem>
+#include <mutex>
 #include <string>
 
 struct ImVec4;
@@ -57,6 +59,34 @@ namespace tf2_bot_detector
 		Error,
 	};
 
+	// Holds the log lock for as long as it is alive, so don't keep it around
+	class VisibleLogMessages final
+	{
+	public:
+		using iterator = std::deque<LogMessage>::const_iterator;
+
+		VisibleLogMessages(std::unique_lock<std::recursive_mutex> lock, iterator begin, iterator end, size_t firstIndex) :
+			m_Lock(std::move(lock)), m_Begin(begin), m_End(end), m_FirstIndex(firstIndex)
+		{
+		}
+
+		iterator begin() const { return m_Begin; }
+		iterator end() const { return m_End; }
+		size_t size() const { return m_End - m_Begin; }
+		bool empty() const { return m_Begin == m_End; }
+		const LogMessage& operator[](size_t i) const { return m_Begin[i]; }
+
+		// How many messages were logged before the first one in here. Stays the same for a
+		// given message, so it can be used to line up per-message data between calls.
+		size_t GetFirstIndex() const { return m_FirstIndex; }
+
+	private:
+		std::unique_lock<std::recursive_mutex> m_Lock;
+		iterator m_Begin;
+		iterator m_End;
+		size_t m_FirstIndex = 0;
+	};
+
 	enum class LogVisibility
 	{
 		Default,
@@ -76,7 +106,8 @@ namespace tf2_bot_detector
 
 		virtual const std::filesystem::path& GetFileName() const = 0;
 
-		virtual cppcoro::generator<const LogMessage&> GetVisibleMsgs() const = 0;
+		virtual VisibleLogMessages GetVisibleMsgs() const = 0;
+		cppcoro::generator<const LogMessage&> GenerateVisibleMsgs() const; // Compatibility shim
 		virtual void ClearVisibleMsgs() = 0;
 
 		virtual void LogConsoleOutput(const std::string_view& consoleOutput) = 0;
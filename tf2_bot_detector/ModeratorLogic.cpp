@@ -5,9 +5,14 @@
 #include "Config/Rules.h"
 #include "Config/Settings.h"
 #include "ConsoleLog/ConsoleLineListener.h"
+#include "ConsoleLog/ConsoleLines.h"
+#include "ConsoleLog/SessionJournal.h"
 #include "IPlayer.h"
+#include "KillStats.h"
 #include "Log.h"
+#include "PlayerNameIndex.h"
 #include "PlayerStatus.h"
+#include "PlayerTable.h"
 #include "WorldEventListener.h"
 #include "WorldState.h"
 
@@ -22,6 +27,7 @@
 #include <locale>
 #include <random>
 #include <regex>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace tf2_bot_detector;
@@ -34,7 +40,8 @@ namespace
 	class ModeratorLogic final : public IModeratorLogic, AutoConsoleLineListener, AutoWorldEventListener
 	{
 	public:
-		ModeratorLogic(IWorldState& world, const Settings& settings, IRCONActionManager& actionManager);
+		ModeratorLogic(IWorldState& world, const Settings& settings, IRCONActionManager& actionManager,
+			ISessionJournalWriter* journal);
 
 		void Update() override;
 
@@ -78,6 +85,7 @@ namespace
 		IWorldState* m_World = nullptr;
 		const Settings* m_Settings = nullptr;
 		IRCONActionManager* m_ActionManager = nullptr;
+		ISessionJournalWriter* m_Journal = nullptr;
 
 		struct PlayerExtraData
 		{
@@ -100,11 +108,37 @@ namespace
 		// Steam IDs of players that we think are running the tool.
 		std::unordered_set<SteamID> m_PlayersRunningTool;
 
+		// Username rules only depend on the player's name, so remember which rules
+		// matched last time and skip re-evaluating them until the name or the rules change.
+		struct RuleVerdict
+		{
+			size_t m_NameHash = 0;
+			std::vector<const ModerationRule*> m_MatchedRules;
+		};
+		std::unordered_map<SteamID, RuleVerdict> m_RuleVerdicts;
+		uint64_t m_RuleVerdictsGeneration = 0;
+		const RuleVerdict& GetUsernameRuleVerdict(const IPlayer& player);
+
+		// What the connected players were last checked against
+		uint64_t m_AppliedRulesGeneration = 0;
+		bool m_AppliedAutoMark = false;
+		void ReapplyPlayerRulesIfChanged();
+
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override;
+
 		void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) override;
+		void OnPlayerLeft(IWorldState& world, IPlayer& player) override;
 		void OnChatMsg(IWorldState& world, IPlayer& player, const std::string_view& msg) override;
 
 		void OnRuleMatch(const ModerationRule& rule, const IPlayer& player);
 
+		// Runs when a player joins or changes (not on every status dump). Rules that were added or
+		// finished loading after that, or auto-mark being turned on, reach them through
+		// ReapplyPlayerRulesIfChanged() instead.
+		void ApplyPlayerRules(IWorldState& world, const IPlayer& player);
+		void ApplyUsernameRules(const IPlayer& player);
+		void ApplyNameCollisionRules(IWorldState& world, const IPlayer& player);
+
 		// How long inbetween accusations
 		static constexpr duration_t CHEATER_WARNING_INTERVAL = std::chrono::seconds(20);
 
@@ -133,9 +167,9 @@ namespace
 }
 
 std::unique_ptr<IModeratorLogic> IModeratorLogic::Create(IWorldState& world,
-	const Settings& settings, IRCONActionManager& actionManager)
+	const Settings& settings, IRCONActionManager& actionManager, ISessionJournalWriter* journal)
 {
-	return std::make_unique<ModeratorLogic>(world, settings, actionManager);
+	return std::make_unique<ModeratorLogic>(world, settings, actionManager, journal);
 }
 
 template<typename CharT, typename Traits>
@@ -165,6 +199,7 @@ static std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, T
 
 void ModeratorLogic::Update()
 {
+	ReapplyPlayerRulesIfChanged();
 	ProcessPlayerActions();
 }
 
@@ -182,21 +217,135 @@ void ModeratorLogic::OnRuleMatch(const ModerationRule& rule, const IPlayer& play
 	}
 }
 
-void ModeratorLogic::OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player)
+auto ModeratorLogic::GetUsernameRuleVerdict(const IPlayer& player) -> const RuleVerdict&
 {
-	const auto name = player.GetNameUnsafe();
-	const auto steamID = player.GetSteamID();
+	// Rule pointers are only valid for the generation they were collected in
+	if (const auto generation = m_Rules.GetGeneration(); generation != m_RuleVerdictsGeneration)
+	{
+		m_RuleVerdicts.clear();
+		m_RuleVerdictsGeneration = generation;
+	}
 
-	if (m_Settings->m_AutoMark)
+	const auto nameHash = std::hash<std::string_view>{}(player.GetNameUnsafe());
+
+	auto [it, inserted] = m_RuleVerdicts.try_emplace(player.GetSteamID());
+	RuleVerdict& verdict = it->second;
+	if (inserted || verdict.m_NameHash != nameHash)
 	{
+		verdict.m_NameHash = nameHash;
+		verdict.m_MatchedRules.clear();
+
 		for (const ModerationRule& rule : m_Rules.GetRules())
 		{
-			if (!rule.Match(player))
+			// These change with every kill/other players joining, not just with the name
+			if (rule.m_Triggers.m_KillStatsMatch || rule.m_Triggers.m_NameCollisionMatch)
 				continue;
 
-			OnRuleMatch(rule, player);
+			if (rule.Match(player))
+				verdict.m_MatchedRules.push_back(&rule);
 		}
 	}
+
+	return verdict;
+}
+
+void ModeratorLogic::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
+{
+	if (line.GetType() != ConsoleLineType::KillNotification)
+		return;
+
+	auto& killLine = static_cast<const KillNotificationLine&>(line);
+	if (killLine.GetAttackerName() == killLine.GetVictimName())
+		return;
+
+	IPlayer* attacker = nullptr;
+	if (auto attackerID = world.FindSteamIDForName(killLine.GetAttackerName()))
+		attacker = world.FindPlayer(*attackerID);
+
+	if (!attacker)
+		return;
+
+	attacker->GetOrCreateData<PlayerKillStats>().AddKill(killLine.GetTimestamp(), killLine.GetWeaponName(), killLine.WasCrit());
+
+	if (m_Settings->m_AutoMark)
+	{
+		for (const ModerationRule& rule : m_Rules.GetRules())
+		{
+			if (rule.m_Triggers.m_KillStatsMatch && rule.Match(*attacker))
+				OnRuleMatch(rule, *attacker);
+		}
+	}
+}
+
+void ModeratorLogic::OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player)
+{
+	ApplyPlayerRules(world, player);
+}
+
+void ModeratorLogic::OnPlayerLeft(IWorldState& world, IPlayer& player)
+{
+	// Don't keep a verdict around for everyone we've ever seen
+	m_RuleVerdicts.erase(player.GetSteamID());
+}
+
+void ModeratorLogic::ApplyPlayerRules(IWorldState& world, const IPlayer& player)
+{
+	if (!m_Settings->m_AutoMark)
+		return;
+
+	ApplyUsernameRules(player);
+
+	// A new/renamed player can turn anyone with the same name into a match, not just themselves
+	for (const SteamID& id : world.GetPlayerNameIndex().GetCollisions(player.GetSteamID()))
+	{
+		if (const IPlayer* collidingPlayer = world.FindPlayer(id))
+			ApplyNameCollisionRules(world, *collidingPlayer);
+	}
+}
+
+void ModeratorLogic::ApplyUsernameRules(const IPlayer& player)
+{
+	// Still re-apply cached matches every time, in case the marks were changed in the meantime
+	for (const ModerationRule* rule : GetUsernameRuleVerdict(player).m_MatchedRules)
+		OnRuleMatch(*rule, player);
+}
+
+void ModeratorLogic::ApplyNameCollisionRules(IWorldState& world, const IPlayer& player)
+{
+	if (!world.GetPlayerNameIndex().HasCollisions(player.GetSteamID()))
+		return;
+
+	for (const ModerationRule& rule : m_Rules.GetRules())
+	{
+		if (rule.m_Triggers.m_NameCollisionMatch && rule.Match(player))
+			OnRuleMatch(rule, player);
+	}
+}
+
+void ModeratorLogic::ReapplyPlayerRulesIfChanged()
+{
+	const auto generation = m_Rules.GetGeneration();
+	const bool autoMarkTurnedOn = m_Settings->m_AutoMark && !m_AppliedAutoMark;
+	m_AppliedAutoMark = m_Settings->m_AutoMark;
+
+	if (generation == m_AppliedRulesGeneration && !autoMarkTurnedOn)
+		return;
+
+	m_AppliedRulesGeneration = generation;
+	if (!m_Settings->m_AutoMark)
+		return;
+
+	// Once per connected player. Everyone in a name collision gets visited on their own,
+	// so there's no need to go through the collisions of each of them.
+	const PlayerNameIndex& nameIndex = m_World->GetPlayerNameIndex();
+	for (const IPlayer& player : m_World->GetPlayers())
+	{
+		if (!nameIndex.FindNormalizedName(player.GetSteamID()))
+			continue;
+
+		ApplyUsernameRules(player);
+		ApplyNameCollisionRules(*m_World, player);
+	}
 }
 
 static bool IsCheaterConnectedWarning(const std::string_view& msg)
@@ -610,6 +759,9 @@ bool ModeratorLogic::SetPlayerAttribute(const IPlayer& player, PlayerAttribute a
 			return ModifyPlayerAction::Modified;
 		});
 
+	if (attributeChanged && m_Journal)
+		m_Journal->RecordPlayerMark(player.GetSteamID(), attribute, set);
+
 	return attributeChanged;
 }
 
@@ -647,19 +799,22 @@ const IPlayer* ModeratorLogic::GetBotLeader() const
 		return nullptr;
 
 	const auto now = m_World->GetCurrentTime();
-	for (const IPlayer& player : m_World->GetPlayers())
+	const auto localSteamID = localPlayer->GetSteamID();
+	const PlayerTable& players = m_World->GetPlayerTable();
+	for (size_t i = 0; i < players.size(); i++)
 	{
-		if (player.GetTimeSinceLastStatusUpdate() > 20s)
+		if ((now - players.m_LastStatusUpdateTimes[i]) > 20s)
 			continue;
 
-		if (player.GetSteamID() == localPlayer->GetSteamID())
+		const SteamID steamID = players.m_SteamIDs[i];
+		if (steamID == localSteamID)
 			continue;
 
-		if (player.GetUserID() >= localUserID)
+		if (const auto userID = players.m_UserIDs[i]; userID > 0 && userID >= localUserID)
 			continue;
 
-		if (IsUserRunningTool(player))
-			return &player;
+		if (IsUserRunningTool(steamID))
+			return players.m_Players[i];
 	}
 
 	return localPlayer;
@@ -691,14 +846,17 @@ void ModeratorLogic::ReloadConfigFiles()
 {
 	m_PlayerList.LoadFiles();
 	m_Rules.LoadFiles();
+	m_RuleVerdicts.clear();
 }
 
-ModeratorLogic::ModeratorLogic(IWorldState& world, const Settings& settings, IRCONActionManager& actionManager) :
-	AutoConsoleLineListener(world),
+ModeratorLogic::ModeratorLogic(IWorldState& world, const Settings& settings, IRCONActionManager& actionManager,
+	ISessionJournalWriter* journal) :
+	AutoConsoleLineListener(world, { ConsoleLineType::KillNotification }),
 	AutoWorldEventListener(world),
 	m_World(&world),
 	m_Settings(&settings),
 	m_ActionManager(&actionManager),
+	m_Journal(journal),
 	m_PlayerList(settings),
 	m_Rules(settings)
 {
@@ -730,6 +888,9 @@ bool ModeratorLogic::InitiateVotekick(const IPlayer& player, KickReason reason,
 			logMsg << ", in playerlist(s)" << *marks;
 
 		Log(std::move(logMsg));
+
+		if (m_Journal)
+			m_Journal->RecordVotekick(player.GetSteamID(), reason);
 	}
 
 	return true;
@@ -14,6 +14,7 @@ namespace tf2_bot_detector
 	struct PlayerAttributesList;
 	struct PlayerMarks;
 	class IRCONActionManager;
+	class ISessionJournalWriter;
 	class Settings;
 	class SteamID;
 	class IWorldState;
@@ -23,7 +24,9 @@ namespace tf2_bot_detector
 	public:
 		virtual ~IModeratorLogic() = default;
 
-		static std::unique_ptr<IModeratorLogic> Create(IWorldState& world, const Settings& settings, IRCONActionManager& actionManager);
+		// Marks and votekicks are recorded in the journal, if there is one
+		static std::unique_ptr<IModeratorLogic> Create(IWorldState& world, const Settings& settings,
+			IRCONActionManager& actionManager, ISessionJournalWriter* journal = nullptr);
 
 		virtual void Update() = 0;
 
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// A request that failed on a reused connection before anything came back most likely failed
+	// because the server closed the connection while it sat in the pool, so it is worth sending
+	// again on a new connection. Anything else is a real failure, and so is a request that
+	// already delivered part of its response.
+	inline bool ShouldRetryOnNewConnection(bool reused, int statusCode, uint64_t bytesReceived)
+	{
+		return reused && statusCode == 0 && bytesReceived == 0;
+	}
+
+	// Idle keep-alive connections to a single host. Not thread safe.
+	// The most recently used connection is handed out first, since it is the least likely to have
+	// been closed by the server. Connections that sat idle for longer than the idle timeout are
+	// closed instead of being handed out.
+	template<typename TConnection>
+	class ConnectionPool final
+	{
+	public:
+		using clock_type = std::chrono::steady_clock;
+
+		ConnectionPool(size_t maxIdleConnections, clock_type::duration idleTimeout) :
+			m_MaxIdleConnections(maxIdleConnections), m_IdleTimeout(idleTimeout)
+		{
+		}
+
+		// Returns nullptr if there is no idle connection that is still usable
+		std::unique_ptr<TConnection> TryAcquire(clock_type::time_point now)
+		{
+			EvictExpired(now);
+			if (m_Idle.empty())
+				return nullptr;
+
+			auto retVal = std::move(m_Idle.back().m_Connection);
+			m_Idle.pop_back();
+			return retVal;
+		}
+
+		// Only for connections whose last request succeeded. Returns false (and closes the
+		// connection) if there are already enough idle connections.
+		bool Release(std::unique_ptr<TConnection> connection, clock_type::time_point now)
+		{
+			if (!connection || m_Idle.size() >= m_MaxIdleConnections)
+				return false;
+
+			m_Idle.push_back({ std::move(connection), now });
+			return true;
+		}
+
+		// Returns the number of connections that were closed
+		size_t EvictExpired(clock_type::time_point now)
+		{
+			// Oldest first, so everything that expired is at the front
+			const auto firstUnexpired = std::find_if(m_Idle.begin(), m_Idle.end(),
+				[&](const IdleConnection& idle) { return (now - idle.m_ReleaseTime) < m_IdleTimeout; });
+
+			const size_t count = size_t(firstUnexpired - m_Idle.begin());
+			m_Idle.erase(m_Idle.begin(), firstUnexpired);
+			m_EvictedCount += count;
+			return count;
+		}
+
+		size_t GetIdleCount() const { return m_Idle.size(); }
+		uint64_t GetEvictedCount() const { return m_EvictedCount; }
+
+	private:
+		struct IdleConnection
+		{
+			std::unique_ptr<TConnection> m_Connection;
+			clock_type::time_point m_ReleaseTime;
+		};
+
+		size_t m_MaxIdleConnections;
+		clock_type::duration m_IdleTimeout;
+		std::vector<IdleConnection> m_Idle;  // Oldest first
+		uint64_t m_EvictedCount = 0;
+	};
+}
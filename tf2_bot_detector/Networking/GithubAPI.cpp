@@ -4,6 +4,7 @@
 #include "Version.h"
 #include "HTTPClient.h"
 #include "HTTPHelpers.h"
+#include "TaskScheduler.h"
 
 #include <cppcoro/generator.hpp>
 #include <mh/text/string_insertion.hpp>
@@ -139,5 +140,5 @@ static const std::shared_future<GithubAPI::NewVersionResult>& GetVersionCheckFut
 
 auto GithubAPI::CheckForNewVersion(const HTTPClient& client) -> std::future<NewVersionResult>
 {
-	return std::async([&] { return GetLatestVersion(client); });
+	return TaskScheduler::Get().Run(TaskPriority::Network, [&] { return GetLatestVersion(client); });
 }
@@ -1,6 +1,7 @@
 #define CPPHTTPLIB_OPENSSL_SUPPORT 1
 
 #include "HTTPClient.h"
+#include "ConnectionPool.h"
 #include "HTTPHelpers.h"
 
 #include <mh/text/string_insertion.hpp>
@@ -12,22 +13,221 @@
 using namespace std::string_literals;
 using namespace tf2_bot_detector;
 
+static const httplib::Headers s_DefaultHeaders =
+{
+	{ "User-Agent", "curl/7.58.0" }
+};
+
+static std::string GetHostKey(const URL& url)
+{
+	return url.m_Host + ':' + std::to_string(url.m_Port);
+}
+
+struct HTTPClient::HostConnectionPool
+{
+	HostConnectionPool(const Options& options) :
+		m_Connections(options.m_MaxIdleConnectionsPerHost, options.m_IdleTimeout)
+	{
+	}
+
+	HTTPHostMetrics GetMetrics() const
+	{
+		auto metrics = m_Metrics;
+		metrics.m_IdleConnections = uint32_t(m_Connections.GetIdleCount());
+		metrics.m_ConnectionsExpired = m_Connections.GetEvictedCount();
+		return metrics;
+	}
+
+	std::mutex m_Mutex;
+	ConnectionPool<httplib::SSLClient> m_Connections;
+	HTTPHostMetrics m_Metrics;
+};
+
+class HTTPClient::PooledConnection final
+{
+public:
+	PooledConnection(HostConnectionPool& pool, std::unique_ptr<httplib::SSLClient> connection, bool reused) :
+		m_Pool(pool), m_Connection(std::move(connection)), m_StartTime(std::chrono::steady_clock::now()), m_Reused(reused)
+	{
+	}
+	PooledConnection(const PooledConnection&) = delete;
+	PooledConnection(PooledConnection&&) = delete;
+	~PooledConnection()
+	{
+		const auto now = std::chrono::steady_clock::now();
+		const auto latency = now - m_StartTime;
+
+		std::lock_guard lock(m_Pool.m_Mutex);
+		auto& metrics = m_Pool.m_Metrics;
+		metrics.m_ActiveRequests--;
+		metrics.m_TotalLatency += latency;
+		metrics.m_MaxLatency = std::max(metrics.m_MaxLatency, latency);
+		metrics.m_BytesReceived += m_BytesReceived;
+
+		// Don't hand out a connection that might be in a bad state
+		if (m_Succeeded)
+			m_Pool.m_Connections.Release(std::move(m_Connection), now);
+	}
+
+	httplib::SSLClient* operator->() const { return m_Connection.get(); }
+
+	bool IsReused() const { return m_Reused; }
+	uint64_t GetBytesReceived() const { return m_BytesReceived; }
+	void AddBytesReceived(size_t bytes) { m_BytesReceived += bytes; }
+	void SetSucceeded() { m_Succeeded = true; }
+
+private:
+	HostConnectionPool& m_Pool;
+	std::unique_ptr<httplib::SSLClient> m_Connection;
+	std::chrono::steady_clock::time_point m_StartTime;
+	uint64_t m_BytesReceived = 0;
+	bool m_Reused = false;
+	bool m_Succeeded = false;
+};
+
+HTTPClient::HTTPClient() :
+	HTTPClient(Options{})
+{
+}
+
+HTTPClient::HTTPClient(Options options) :
+	m_Options(std::move(options))
+{
+}
+
+HTTPClient::~HTTPClient() = default;
+
+auto HTTPClient::GetHostPool(const URL& url) const -> HostConnectionPool&
+{
+	const auto key = GetHostKey(url);
+
+	std::lock_guard lock(m_PoolsMutex);
+	auto& pool = m_Pools[key];
+	if (!pool)
+		pool = std::make_unique<HostConnectionPool>(m_Options);
+
+	return *pool;
+}
+
+auto HTTPClient::AcquireConnection(HostConnectionPool& pool, const URL& url, bool allowReuse) const -> PooledConnection
+{
+	std::unique_ptr<httplib::SSLClient> connection;
+	{
+		std::lock_guard lock(pool.m_Mutex);
+		pool.m_Metrics.m_ActiveRequests++;
+
+		if (allowReuse)
+			connection = pool.m_Connections.TryAcquire(std::chrono::steady_clock::now());
+
+		if (connection)
+			pool.m_Metrics.m_ConnectionsReused++;
+		else
+			pool.m_Metrics.m_ConnectionsCreated++;
+	}
+
+	const bool reused = !!connection;
+	if (!connection)
+	{
+		connection = std::make_unique<httplib::SSLClient>(url.m_Host, url.m_Port);
+		connection->set_follow_location(true);
+		connection->set_keep_alive(true);
+
+		if (!m_Options.m_CACertPath.empty())
+		{
+			connection->set_ca_cert_path(m_Options.m_CACertPath.string().c_str());
+			connection->enable_server_certificate_verification(true);
+		}
+	}
+
+	return PooledConnection(pool, std::move(connection), reused);
+}
+
 std::string HTTPClient::GetString(const URL& url) const
 {
-	httplib::SSLClient client(url.m_Host, url.m_Port);
-	client.set_follow_location(true);
+	std::string retVal;
+	GetStream(url, [&](const std::string_view& data)
+		{
+			retVal.append(data);
+			return true;
+		});
 
-	httplib::Headers headers =
+	return retVal;
+}
+
+void HTTPClient::GetStream(const URL& url, const ContentReceiver& receiver) const
+{
+	auto& pool = GetHostPool(url);
+	const auto AddToMetrics = [&](uint64_t HTTPHostMetrics::* counter)
 	{
-		{ "User-Agent", "curl/7.58.0" }
+		std::lock_guard lock(pool.m_Mutex);
+		(pool.m_Metrics.*counter)++;
 	};
 
-	auto response = client.Get(url.m_Path.c_str(), headers);
-	if (!response)
-		throw http_error("Failed to HTTP GET "s << url);
+	// Retries count towards the request they were retrying, not as requests of their own
+	AddToMetrics(&HTTPHostMetrics::m_RequestCount);
+
+	try
+	{
+		for (bool allowReuse = true; ; allowReuse = false)
+		{
+			auto connection = AcquireConnection(pool, url, allowReuse);
+
+			int statusCode = 0;
+			auto response = connection->Get(url.m_Path.c_str(), s_DefaultHeaders,
+				[&](const httplib::Response& response)
+				{
+					statusCode = response.status;
+					return !(statusCode >= 400 && statusCode < 600);
+				},
+				[&](const char* data, size_t length)
+				{
+					connection.AddBytesReceived(length);
+					return receiver(std::string_view(data, length));
+				});
+
+			if (statusCode >= 400 && statusCode < 600)
+				throw http_error(statusCode);
+
+			if (!response)
+			{
+				if (allowReuse && ShouldRetryOnNewConnection(connection.IsReused(), statusCode, connection.GetBytesReceived()))
+				{
+					AddToMetrics(&HTTPHostMetrics::m_RetriedRequestCount);
+					continue;
+				}
+
+				throw http_error("Failed to HTTP GET "s << url);
+			}
+
+			connection.SetSucceeded();
+			return;
+		}
+	}
+	catch (...)
+	{
+		AddToMetrics(&HTTPHostMetrics::m_FailedRequestCount);
+		throw;
+	}
+}
 
-	if (response->status >= 400 && response->status < 600)
-		throw http_error(response->status);
+HTTPHostMetrics HTTPClient::GetHostMetrics(const URL& url) const
+{
+	auto& pool = GetHostPool(url);
+
+	std::lock_guard lock(pool.m_Mutex);
+	return pool.GetMetrics();
+}
+
+std::map<std::string, HTTPHostMetrics> HTTPClient::GetAllHostMetrics() const
+{
+	std::map<std::string, HTTPHostMetrics> retVal;
+
+	std::lock_guard lock(m_PoolsMutex);
+	for (const auto& [key, pool] : m_Pools)
+	{
+		std::lock_guard poolLock(pool->m_Mutex);
+		retVal[key] = pool->GetMetrics();
+	}
 
-	return response->body;
+	return retVal;
 }
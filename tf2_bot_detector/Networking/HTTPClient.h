@@ -1,16 +1,75 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 
 namespace tf2_bot_detector
 {
 	class URL;
 
+	struct HTTPHostMetrics
+	{
+		uint64_t m_RequestCount = 0;
+		uint64_t m_FailedRequestCount = 0;
+		uint64_t m_RetriedRequestCount = 0;  // Sent again on a new connection after a reused one failed
+		uint64_t m_ConnectionsCreated = 0;
+		uint64_t m_ConnectionsReused = 0;
+		uint64_t m_ConnectionsExpired = 0;  // Closed after sitting idle for too long
+		uint64_t m_BytesReceived = 0;
+		uint32_t m_ActiveRequests = 0;
+		uint32_t m_IdleConnections = 0;
+		std::chrono::steady_clock::duration m_TotalLatency{};
+		std::chrono::steady_clock::duration m_MaxLatency{};
+	};
+
 	// Only intended to be stored if you are doing something async
 	class HTTPClient : public std::enable_shared_from_this<HTTPClient>
 	{
 	public:
+		struct Options
+		{
+			// Maximum number of keep-alive connections kept around per host
+			size_t m_MaxIdleConnectionsPerHost = 4;
+
+			// Idle connections older than this are closed instead of reused. Servers close
+			// keep-alive connections on their end after a while anyway.
+			std::chrono::steady_clock::duration m_IdleTimeout = std::chrono::seconds(30);
+
+			// If set, server certificates are verified against this CA bundle.
+			// Mostly useful for pointing the client at a local TLS server.
+			std::filesystem::path m_CACertPath;
+		};
+
+		HTTPClient();
+		explicit HTTPClient(Options options);
+		~HTTPClient();
+
 		std::string GetString(const URL& url) const;
+
+		// Return false from the receiver to cancel the transfer.
+		using ContentReceiver = std::function<bool(const std::string_view& data)>;
+		void GetStream(const URL& url, const ContentReceiver& receiver) const;
+
+		HTTPHostMetrics GetHostMetrics(const URL& url) const;
+		std::map<std::string, HTTPHostMetrics> GetAllHostMetrics() const;
+
+	private:
+		struct HostConnectionPool;
+		class PooledConnection;
+
+		PooledConnection AcquireConnection(HostConnectionPool& pool, const URL& url, bool allowReuse = true) const;
+		HostConnectionPool& GetHostPool(const URL& url) const;
+
+		Options m_Options;
+
+		mutable std::mutex m_PoolsMutex;
+		mutable std::map<std::string, std::unique_ptr<HostConnectionPool>, std::less<>> m_Pools;
 	};
 }
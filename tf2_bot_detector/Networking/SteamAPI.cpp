@@ -4,8 +4,8 @@
 #include "HTTPClient.h"
 #include "HTTPHelpers.h"
 #include "Log.h"
+#include "TaskScheduler.h"
 
-#include <mh/concurrency/thread_pool.hpp>
 #include <mh/text/fmtstr.hpp>
 #include <mh/text/format.hpp>
 #include <mh/text/string_insertion.hpp>
@@ -13,8 +13,13 @@
 #include <nlohmann/json.hpp>
 #include <stb_image.h>
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <list>
 #include <regex>
+#include <unordered_map>
+#include <vector>
 
 using namespace std::chrono_literals;
 using namespace std::string_literals;
@@ -30,11 +35,10 @@ namespace
 		std::string m_Response;
 	};
 
-	static mh::thread_pool<SteamAPITask> s_SteamAPIThreadPool(2);
 	static std::shared_future<SteamAPITask> SteamAPIGET(const HTTPClient& client, const URL& url)
 	{
 		auto clientPtr = client.shared_from_this();
-		return s_SteamAPIThreadPool.add_task([clientPtr, url]() -> SteamAPITask
+		return TaskScheduler::Get().Run(TaskPriority::Network, [clientPtr, url]() -> SteamAPITask
 			{
 				DebugLog("[SteamAPI] HTTP GET "s << url);
 
@@ -42,7 +46,7 @@ namespace
 				retVal.m_RequestURL = url;
 				retVal.m_Response = clientPtr->GetString(url);
 				return retVal;
-			});
+			}).share();
 	}
 
 	class AvatarCacheManager final
@@ -52,45 +56,161 @@ namespace
 		{
 			m_CacheDir = std::filesystem::temp_directory_path() / "TF2 Bot Detector/Steam Avatar Cache";
 			std::filesystem::create_directories(m_CacheDir);
-			DeleteOldFiles(m_CacheDir, 24h * 7);
+
+			// Nobody needs to wait on this, don't block startup on it
+			m_DeleteOldFilesTask = TaskScheduler::Get().Run(TaskPriority::BackgroundIO, [cacheDir = m_CacheDir]
+				{
+					DeleteOldFiles(cacheDir, 24h * 7);
+				});
 		}
 
 		std::shared_future<Bitmap> GetAvatarBitmap(const HTTPClient* client,
-			const std::string& url, const std::string_view& hash) const
+			const std::string& url, const std::string_view& hash)
 		{
-			const std::filesystem::path cachedPath = m_CacheDir / mh::fmtstr<128>("{}.jpg", hash).view();
+			std::lock_guard lock(m_CacheMutex);
 
-			// See if we're already stored in the cache
+			// See if we're already loaded or loading
+			if (auto found = m_LoadedAvatars.find(url); found != m_LoadedAvatars.end())
 			{
-				std::lock_guard lock(m_CacheMutex);
-				if (std::filesystem::exists(cachedPath))
-					return mh::make_ready_future(Bitmap(cachedPath));
+				if (IsFailedFuture(found->second->m_Bitmap))
+				{
+					// Give it another shot
+					Forget(found->second);
+					m_LoadedAvatars.erase(found);
+				}
+				else
+				{
+					m_LRU.splice(m_LRU.begin(), m_LRU, found->second);
+					return found->second->m_Bitmap;
+				}
 			}
 
+			const std::filesystem::path cachedPath = m_CacheDir / mh::fmtstr<128>("{}.jpg", hash).view();
+
+			std::shared_ptr<const HTTPClient> clientPtr;
 			if (client)
-			{
-				auto dataFuture = SteamAPIGET(*client, url);
-				// We're not stored in the cache, download now
-				return std::async([this, cachedPath, dataFuture]() -> Bitmap
-					{
-						const SteamAPITask& data = dataFuture.get();
+				clientPtr = client->shared_from_this();
 
-						std::lock_guard lock(m_CacheMutex);
+			std::shared_future<Bitmap> bitmap = TaskScheduler::Get().Run(TaskPriority::Network, [clientPtr, url, cachedPath]() -> Bitmap
+				{
+					if (std::filesystem::exists(cachedPath))
+					{
+						try
+						{
+							return Bitmap(cachedPath);
+						}
+						catch (const std::exception& e)
 						{
-							std::ofstream file(cachedPath, std::ios::trunc | std::ios::binary);
-							file << data.m_Response;
+							DebugLogWarning(MH_SOURCE_LOCATION_CURRENT(),
+								"Failed to load cached avatar "s << cachedPath << ": " << e.what());
 						}
-						return Bitmap(cachedPath);
-					});
+					}
+
+					// No HTTPClient and we're not in the cache, so just give up
+					if (!clientPtr)
+						return Bitmap{};
+
+					DebugLog("[SteamAPI] HTTP GET "s << url);
+					const std::string data = clientPtr->GetString(url);
+
+					Bitmap retVal;
+					retVal.LoadFromMemory(data);
+
+					{
+						std::ofstream file(cachedPath, std::ios::trunc | std::ios::binary);
+						file << data;
+					}
+
+					return retVal;
+				}).share();
+
+			m_LRU.push_front({ url, bitmap });
+			m_LoadedAvatars[url] = m_LRU.begin();
+			m_Loading.push_back(m_LRU.begin());
+
+			UpdateLoadedBytes();
+			while (m_LRU.size() > 1 && (m_LoadedBytes > MAX_LOADED_AVATAR_BYTES || m_LRU.size() > MAX_LOADED_AVATARS))
+			{
+				m_LoadedAvatars.erase(m_LRU.back().m_URL);
+				Forget(std::prev(m_LRU.end()));
 			}
 
-			// No HTTPClient and we're not in the cache, so just give up
-			return mh::make_ready_future(Bitmap{});
+			return bitmap;
 		}
 
 	private:
+		// Budgeted by decoded size rather than count, since a large (184x184) avatar takes up
+		// about 8 times the memory of a medium (64x64) one. A couple hundred large avatars.
+		static constexpr size_t MAX_LOADED_AVATAR_BYTES = 32 * 1024 * 1024;
+		// Avatars that failed to load (or are still loading) take up no bytes, so don't let them pile up
+		static constexpr size_t MAX_LOADED_AVATARS = 1024;
+
+		static bool IsFailedFuture(const std::shared_future<Bitmap>& future)
+		{
+			if (!mh::is_future_ready(future))
+				return false;
+
+			try
+			{
+				// Empty if we had no HTTPClient at the time, try again in case we do now
+				return future.get().empty();
+			}
+			catch (...)
+			{
+				return true;
+			}
+		}
+
+		struct LoadedAvatar
+		{
+			std::string m_URL;
+			std::shared_future<Bitmap> m_Bitmap;
+			size_t m_Bytes = 0;  // Decoded size, once it finished loading
+		};
+		using LRUIterator = std::list<LoadedAvatar>::iterator;
+
+		// The size of an avatar is only known once it has been decoded, so only the few that
+		// are still loading need to be checked
+		void UpdateLoadedBytes()
+		{
+			std::erase_if(m_Loading, [&](const LRUIterator& avatar)
+				{
+					if (!mh::is_future_ready(avatar->m_Bitmap))
+						return false;
+
+					try
+					{
+						const Bitmap& bitmap = avatar->m_Bitmap.get();
+						avatar->m_Bytes = size_t(bitmap.GetWidth()) * bitmap.GetHeight() * bitmap.GetChannelCount();
+					}
+					catch (...)
+					{
+						avatar->m_Bytes = 0;
+					}
+
+					m_LoadedBytes += avatar->m_Bytes;
+					return true;
+				});
+		}
+
+		void Forget(LRUIterator avatar)
+		{
+			if (auto loading = std::find(m_Loading.begin(), m_Loading.end(), avatar); loading != m_Loading.end())
+				m_Loading.erase(loading);
+			else
+				m_LoadedBytes -= avatar->m_Bytes;
+
+			m_LRU.erase(avatar);
+		}
+
 		std::filesystem::path m_CacheDir;
-		mutable std::mutex m_CacheMutex;
+		std::future<void> m_DeleteOldFilesTask;
+
+		std::mutex m_CacheMutex;
+		std::list<LoadedAvatar> m_LRU; // Most recently used at the front
+		std::unordered_map<std::string, LRUIterator> m_LoadedAvatars;
+		std::vector<LRUIterator> m_Loading; // Not counted in m_LoadedBytes yet
+		size_t m_LoadedBytes = 0;
 
 	} s_AvatarCacheManager;
 }
@@ -201,9 +321,8 @@ std::future<std::vector<PlayerSummary>> tf2_bot_detector::SteamAPI::GetPlayerSum
 		url << steamIDs[i].ID64;
 	}
 
-	auto data = SteamAPIGET(client, url);
-
-	return std::async([data]
+	return TaskScheduler::Get().ContinueWith(SteamAPIGET(client, url), TaskPriority::Network,
+		[](const std::shared_future<SteamAPITask>& data)
 		{
 			auto json = nlohmann::json::parse(data.get().m_Response);
 			return json.at("response").at("players").get<std::vector<PlayerSummary>>();
@@ -262,9 +381,8 @@ std::shared_future<std::vector<PlayerBans>> tf2_bot_detector::SteamAPI::GetPlaye
 		url << steamIDs[i].ID64;
 	}
 
-	auto data = SteamAPIGET(client, url);
-
-	return std::async([data]
+	return TaskScheduler::Get().ContinueWith(SteamAPIGET(client, url), TaskPriority::Network,
+		[](const std::shared_future<SteamAPITask>& data)
 		{
 			auto json = nlohmann::json::parse(data.get().m_Response);
 			return json.at("players").get<std::vector<PlayerBans>>();
@@ -288,8 +406,8 @@ std::future<TF2PlaytimeResult> tf2_bot_detector::SteamAPI::GetTF2PlaytimeAsync(
 
 	auto url = mh::format("https://api.steampowered.com/IPlayerService/GetOwnedGames/v0001/?key={}&input_json=%7B%22appids_filter%22%3A%5B440%5D,%22include_played_free_games%22%3Atrue,%22steamid%22%3A{}%7D", apikey, steamID.ID64);
 
-	auto data = SteamAPIGET(client, url);
-	return std::async([data, steamID]() -> TF2PlaytimeResult
+	return TaskScheduler::Get().ContinueWith(SteamAPIGET(client, url), TaskPriority::Network,
+		[](const std::shared_future<SteamAPITask>& data) -> TF2PlaytimeResult
 		{
 			std::string responseString;
 			try
@@ -427,8 +545,8 @@ std::future<std::unordered_set<SteamID>> tf2_bot_detector::SteamAPI::GetFriendLi
 
 	auto url = mh::format("https://api.steampowered.com/ISteamUser/GetFriendList/v0001/?key={}&steamid={}", apikey, steamID.ID64);
 
-	auto data = SteamAPIGET(client, url);
-	return std::async([data, steamID]() -> std::unordered_set<SteamID>
+	return TaskScheduler::Get().ContinueWith(SteamAPIGET(client, url), TaskPriority::Network,
+		[](const std::shared_future<SteamAPITask>& data) -> std::unordered_set<SteamID>
 		{
 			const auto json = nlohmann::json::parse(data.get().m_Response);
 
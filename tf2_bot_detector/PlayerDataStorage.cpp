@@ -0,0 +1,40 @@
+#include "PlayerDataStorage.h"
+
+#include <atomic>
+
+using namespace tf2_bot_detector;
+
+auto PlayerDataStorage::AllocateTypeID() -> type_id_t
+{
+	static std::atomic<type_id_t> s_NextTypeID = 0;
+	return s_NextTypeID++;
+}
+
+auto PlayerDataStorage::GetOverflowSlot(type_id_t id) -> Slot&
+{
+	const size_t index = id - FIXED_SLOT_COUNT;
+	if (index >= m_OverflowSlots.size())
+		m_OverflowSlots.resize(index + 1);
+
+	return m_OverflowSlots[index];
+}
+
+void PlayerDataStorage::clear()
+{
+	const auto Destroy = [](Slot& slot)
+	{
+		if (!slot.m_Object)
+			return;
+
+		slot.m_Destroy(slot);
+		slot.m_Object = nullptr;
+		slot.m_Destroy = nullptr;
+	};
+
+	for (Slot& slot : m_Slots)
+		Destroy(slot);
+	for (Slot& slot : m_OverflowSlots)
+		Destroy(slot);
+
+	m_OverflowSlots.clear();
+}
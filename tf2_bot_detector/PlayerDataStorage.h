@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tf2_bot_detector
+{
+	// Per-player storage for arbitrary data attached by other systems (UI, moderator logic, etc).
+	// Every type gets a small integer id the first time it is used, which indexes directly into
+	// a fixed array of slots. Small types are constructed inline in their slot, larger ones are
+	// heap allocated. Ids are handed out at runtime rather than registered up front, so any system
+	// can attach its own data without touching this file; once there are more types than fixed
+	// slots, the rest go into slots that are only allocated for players that use them.
+	class PlayerDataStorage final
+	{
+	public:
+		using type_id_t = uint32_t;
+		static constexpr size_t FIXED_SLOT_COUNT = 16;
+		static constexpr size_t INLINE_SIZE = 48;
+
+		PlayerDataStorage() = default;
+		PlayerDataStorage(const PlayerDataStorage&) = delete;
+		PlayerDataStorage& operator=(const PlayerDataStorage&) = delete;
+		~PlayerDataStorage() { clear(); }
+
+		template<typename T> static type_id_t GetTypeID()
+		{
+			static const type_id_t s_TypeID = AllocateTypeID();
+			return s_TypeID;
+		}
+
+		template<typename T> T* Find()
+		{
+			return const_cast<T*>(std::as_const(*this).Find<T>());
+		}
+		template<typename T> const T* Find() const
+		{
+			const Slot* slot = FindSlot(GetTypeID<T>());
+			return slot ? static_cast<const T*>(slot->m_Object) : nullptr;
+		}
+
+		template<typename T, typename... TArgs> T& GetOrCreate(TArgs&&... args)
+		{
+			Slot& slot = GetSlot(GetTypeID<T>());
+			if (!slot.m_Object)
+				Construct<T>(slot, std::forward<TArgs>(args)...);
+
+			return *static_cast<T*>(slot.m_Object);
+		}
+
+		template<typename T> T& Set(T value)
+		{
+			Slot& slot = GetSlot(GetTypeID<T>());
+			if (slot.m_Object)
+				return *static_cast<T*>(slot.m_Object) = std::move(value);
+
+			return Construct<T>(slot, std::move(value));
+		}
+
+		void clear();
+
+	private:
+		static type_id_t AllocateTypeID();
+
+		template<typename T>
+		static constexpr bool IS_INLINE = sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t);
+
+		struct Slot
+		{
+			alignas(std::max_align_t) std::byte m_Inline[INLINE_SIZE];
+			void* m_Object = nullptr;
+			void(*m_Destroy)(Slot& slot) = nullptr;
+		};
+
+		const Slot* FindSlot(type_id_t id) const
+		{
+			if (id < FIXED_SLOT_COUNT)
+				return &m_Slots[id];
+
+			id -= FIXED_SLOT_COUNT;
+			return id < m_OverflowSlots.size() ? &m_OverflowSlots[id] : nullptr;
+		}
+		Slot& GetSlot(type_id_t id)
+		{
+			return (id < FIXED_SLOT_COUNT) ? m_Slots[id] : GetOverflowSlot(id);
+		}
+		Slot& GetOverflowSlot(type_id_t id);
+
+		template<typename T, typename... TArgs> static T& Construct(Slot& slot, TArgs&&... args)
+		{
+			T* object;
+			if constexpr (IS_INLINE<T>)
+			{
+				object = new (slot.m_Inline) T(std::forward<TArgs>(args)...);
+				slot.m_Destroy = [](Slot& s) { static_cast<T*>(s.m_Object)->~T(); };
+			}
+			else
+			{
+				object = new T(std::forward<TArgs>(args)...);
+				slot.m_Destroy = [](Slot& s) { delete static_cast<T*>(s.m_Object); };
+			}
+
+			slot.m_Object = object;
+			return *object;
+		}
+
+		std::array<Slot, FIXED_SLOT_COUNT> m_Slots{};
+		std::deque<Slot> m_OverflowSlots;  // Never moved once created, objects may live inside them
+	};
+}
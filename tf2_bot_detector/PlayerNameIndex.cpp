@@ -0,0 +1,75 @@
+#include "PlayerNameIndex.h"
+#include "Util/NameNormalization.h"
+
+#include <algorithm>
+
+using namespace tf2_bot_detector;
+
+bool PlayerNameIndex::Update(const SteamID& id, const std::string_view& name)
+{
+	auto [it, inserted] = m_Players.try_emplace(id);
+	PlayerEntry& entry = it->second;
+	if (!inserted && entry.m_Name == name)
+		return false;
+
+	entry.m_Name = name;
+	NormalizePlayerName(name, m_Scratch);
+	if (!inserted && entry.m_NormalizedName == m_Scratch)
+		return false;
+
+	if (!inserted)
+		RemoveFromBucket(id, entry.m_NormalizedName);
+
+	entry.m_NormalizedName = m_Scratch;
+
+	// Names that are nothing but invisible characters don't collide with each other
+	if (!entry.m_NormalizedName.empty())
+		m_Buckets[entry.m_NormalizedName].push_back(id);
+
+	return true;
+}
+
+void PlayerNameIndex::Remove(const SteamID& id)
+{
+	if (auto found = m_Players.find(id); found != m_Players.end())
+	{
+		RemoveFromBucket(id, found->second.m_NormalizedName);
+		m_Players.erase(found);
+	}
+}
+
+void PlayerNameIndex::clear()
+{
+	m_Players.clear();
+	m_Buckets.clear();
+}
+
+std::span<const SteamID> PlayerNameIndex::GetCollisions(const SteamID& id) const
+{
+	if (auto player = m_Players.find(id); player != m_Players.end())
+	{
+		if (auto bucket = m_Buckets.find(player->second.m_NormalizedName); bucket != m_Buckets.end())
+			return bucket->second;
+	}
+
+	return {};
+}
+
+const std::string* PlayerNameIndex::FindNormalizedName(const SteamID& id) const
+{
+	if (auto found = m_Players.find(id); found != m_Players.end())
+		return &found->second.m_NormalizedName;
+
+	return nullptr;
+}
+
+void PlayerNameIndex::RemoveFromBucket(const SteamID& id, const std::string& normalizedName)
+{
+	auto bucket = m_Buckets.find(normalizedName);
+	if (bucket == m_Buckets.end())
+		return;
+
+	std::erase(bucket->second, id);
+	if (bucket->second.empty())
+		m_Buckets.erase(bucket);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "SteamID.h"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Groups the current players by their normalized name (see NormalizePlayerName()), so
+	// impersonators can be found without comparing every pair of players. Updating a player
+	// whose name hasn't changed is a lookup and a string compare.
+	class PlayerNameIndex final
+	{
+	public:
+		// Returns true if the player's normalized name changed
+		bool Update(const SteamID& id, const std::string_view& name);
+		void Remove(const SteamID& id);
+		void clear();
+
+		// Every player (including this one) with the same normalized name
+		std::span<const SteamID> GetCollisions(const SteamID& id) const;
+		bool HasCollisions(const SteamID& id) const { return GetCollisions(id).size() > 1; }
+
+		const std::string* FindNormalizedName(const SteamID& id) const;
+		size_t size() const { return m_Players.size(); }
+
+	private:
+		struct PlayerEntry
+		{
+			std::string m_Name;  // As it came in, so unchanged names can skip normalizing
+			std::string m_NormalizedName;
+		};
+
+		void RemoveFromBucket(const SteamID& id, const std::string& normalizedName);
+
+		std::unordered_map<SteamID, PlayerEntry> m_Players;
+		std::unordered_map<std::string, std::vector<SteamID>> m_Buckets;
+		std::string m_Scratch;
+	};
+}
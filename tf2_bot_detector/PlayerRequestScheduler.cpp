@@ -0,0 +1,151 @@
+#include "PlayerRequestScheduler.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace tf2_bot_detector;
+
+RequestBudget::RequestBudget(uint32_t capacity, duration_t refillInterval) :
+	m_Capacity(capacity), m_RefillInterval(refillInterval)
+{
+	assert(capacity > 0);
+	assert(refillInterval.count() > 0);
+}
+
+bool RequestBudget::TrySpend(time_point_t now)
+{
+	const auto fullTime = std::max(m_FullTime, now);
+	if ((fullTime - now) > (m_RefillInterval * (m_Capacity - 1)))
+		return false;
+
+	m_FullTime = fullTime + m_RefillInterval;
+	return true;
+}
+
+uint32_t RequestBudget::GetAvailable(time_point_t now) const
+{
+	if (m_FullTime <= now)
+		return m_Capacity;
+
+	// Partially refilled requests can't be spent yet
+	const auto missing = (m_FullTime - now + m_RefillInterval - duration_t(1)) / m_RefillInterval;
+	return m_Capacity - std::min<uint32_t>(m_Capacity, uint32_t(missing));
+}
+
+PlayerRequestPriority PlayerRequestScheduler::Entry::GetPriority(time_point_t now) const
+{
+	if ((now - m_PriorityTime) > PRIORITY_LIFETIME)
+		return PlayerRequestPriority::Background;
+
+	return m_Priority;
+}
+
+void PlayerRequestScheduler::Queue(const SteamID& id, PlayerRequestPriority priority, time_point_t now)
+{
+	if (m_Requested.contains(id))
+		return;
+
+	if (auto [it, inserted] = m_Queued.try_emplace(id, Entry{ priority, now, m_NextSequence }); inserted)
+		m_NextSequence++;
+	else
+		Prioritize(id, priority, now);
+}
+
+void PlayerRequestScheduler::Prioritize(const SteamID& id, PlayerRequestPriority priority, time_point_t now)
+{
+	auto found = m_Queued.find(id);
+	if (found == m_Queued.end())
+		return;
+
+	Entry& entry = found->second;
+	if (priority <= entry.GetPriority(now))
+	{
+		entry.m_Priority = priority;
+		entry.m_PriorityTime = now;
+	}
+}
+
+bool PlayerRequestScheduler::Cancel(const SteamID& id)
+{
+	m_Requested.erase(id);
+	return m_Queued.erase(id) > 0;
+}
+
+void PlayerRequestScheduler::OnRequestFailed(const std::vector<SteamID>& ids, time_point_t now)
+{
+	for (const SteamID& id : ids)
+	{
+		auto requested = m_Requested.find(id);
+		if (requested == m_Requested.end())
+			continue; // Cancelled while the request was in flight
+
+		const uint32_t failureCount = requested->second + 1;
+		m_Requested.erase(requested);
+
+		// Doubles with every failure in a row
+		duration_t delay = MIN_RETRY_DELAY;
+		for (uint32_t i = 1; i < failureCount && delay < MAX_RETRY_DELAY; i++)
+			delay *= 2;
+
+		Entry entry{ PlayerRequestPriority::Background, now, m_NextSequence++ };
+		entry.m_FailureCount = failureCount;
+		entry.m_RetryTime = now + std::min(delay, MAX_RETRY_DELAY);
+		m_Queued.insert_or_assign(id, entry);
+	}
+}
+
+void PlayerRequestScheduler::clear()
+{
+	m_Queued.clear();
+	m_Requested.clear();
+}
+
+std::optional<PlayerRequestPriority> PlayerRequestScheduler::GetPriority(const SteamID& id, time_point_t now) const
+{
+	if (auto found = m_Queued.find(id); found != m_Queued.end())
+		return found->second.GetPriority(now);
+
+	return std::nullopt;
+}
+
+std::optional<time_point_t> PlayerRequestScheduler::GetRetryTime(const SteamID& id) const
+{
+	if (auto found = m_Queued.find(id); found != m_Queued.end() && found->second.m_FailureCount > 0)
+		return found->second.m_RetryTime;
+
+	return std::nullopt;
+}
+
+std::vector<SteamID> PlayerRequestScheduler::TakeBatch(size_t maxCount, RequestBudget& budget, time_point_t now)
+{
+	std::vector<SteamID> retVal;
+	if (m_Queued.empty() || maxCount == 0)
+		return retVal;
+
+	m_SortScratch.clear();
+	for (const auto& [id, entry] : m_Queued)
+	{
+		if (entry.m_RetryTime <= now)
+			m_SortScratch.emplace_back((uint64_t(entry.GetPriority(now)) << 56) | entry.m_Sequence, id);
+	}
+
+	if (m_SortScratch.empty() || !budget.TrySpend(now))
+		return retVal;
+
+	const auto count = std::min(maxCount, m_SortScratch.size());
+	std::partial_sort(m_SortScratch.begin(), m_SortScratch.begin() + count, m_SortScratch.end(),
+		[](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+	retVal.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const SteamID& id = m_SortScratch[i].second;
+		retVal.push_back(id);
+
+		auto found = m_Queued.find(id);
+		m_Requested.insert_or_assign(id, found->second.m_FailureCount);
+		m_Queued.erase(found);
+	}
+
+	return retVal;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Clock.h"
+#include "SteamID.h"
+
+#include <mh/future.hpp>
+
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Most important first
+	enum class PlayerRequestPriority : uint8_t
+	{
+		Hovered,     // Tooltip is open
+		Visible,     // Row is on screen in the scoreboard
+		Marked,      // In one of the player lists
+		Background,  // Everyone else
+	};
+
+	// Token bucket for an API with a fixed request quota. Holds up to capacity requests,
+	// and gets one back every refillInterval.
+	class RequestBudget final
+	{
+	public:
+		RequestBudget(uint32_t capacity, duration_t refillInterval);
+
+		bool TrySpend(time_point_t now);
+		uint32_t GetAvailable(time_point_t now) const;
+
+	private:
+		uint32_t m_Capacity;
+		duration_t m_RefillInterval;
+		time_point_t m_FullTime{};  // When the bucket will be full again
+	};
+
+	// Players waiting on one kind of Steam API request. Players are handed out most important
+	// first, then in the order they were queued. A player's priority is the best one it has been
+	// given in the last PRIORITY_LIFETIME, so rows that scroll out of view (or tooltips that close)
+	// stop jumping the queue. Each player is only requested once. If the request fails, they are
+	// queued again, but held back for a while first (longer every time it fails in a row) so an
+	// API outage doesn't turn into a request every second.
+	class PlayerRequestScheduler final
+	{
+	public:
+		static constexpr duration_t PRIORITY_LIFETIME = std::chrono::seconds(2);
+		static constexpr duration_t MIN_RETRY_DELAY = std::chrono::seconds(5);
+		static constexpr duration_t MAX_RETRY_DELAY = std::chrono::minutes(5);
+
+		// Does nothing if the player is already queued or was already requested
+		void Queue(const SteamID& id, PlayerRequestPriority priority, time_point_t now);
+		// Only affects players that are still queued
+		void Prioritize(const SteamID& id, PlayerRequestPriority priority, time_point_t now);
+		// Returns true if the player was still waiting for their request to go out. If it already
+		// went out, it won't be retried should it fail.
+		bool Cancel(const SteamID& id);
+		// Queues players whose request failed again, to be retried after a delay
+		void OnRequestFailed(const std::vector<SteamID>& ids, time_point_t now);
+		void clear();
+
+		bool IsQueued(const SteamID& id) const { return m_Queued.contains(id); }
+		size_t GetQueuedCount() const { return m_Queued.size(); }
+		std::optional<PlayerRequestPriority> GetPriority(const SteamID& id, time_point_t now) const;
+		// When a player that is queued after a failed request can be requested again
+		std::optional<time_point_t> GetRetryTime(const SteamID& id) const;
+
+		// Takes up to maxCount of the most important players, spending one request from the
+		// budget. Returns nothing if there is nobody ready to be requested or the budget is used up.
+		std::vector<SteamID> TakeBatch(size_t maxCount, RequestBudget& budget, time_point_t now);
+
+	private:
+		struct Entry
+		{
+			PlayerRequestPriority m_Priority;
+			time_point_t m_PriorityTime;
+			uint64_t m_Sequence;
+			uint32_t m_FailureCount = 0;  // Failed requests in a row
+			time_point_t m_RetryTime{};   // Not requested before this
+
+			PlayerRequestPriority GetPriority(time_point_t now) const;
+		};
+
+		std::unordered_map<SteamID, Entry> m_Queued;
+		std::unordered_map<SteamID, uint32_t> m_Requested;  // Value is m_FailureCount when it went out
+		uint64_t m_NextSequence = 0;
+
+		std::vector<std::pair<uint64_t, SteamID>> m_SortScratch;  // (priority, sequence) packed into the key
+	};
+
+	// Requests that only cover one player each, with at most a few of them in flight at once
+	template<typename TResult>
+	class SinglePlayerRequests final
+	{
+	public:
+		explicit SinglePlayerRequests(size_t maxInFlight) : m_MaxInFlight(maxInFlight) {}
+
+		// Starts requests for the next players while there is room for them. startRequest(id)
+		// returns an invalid future if the request couldn't be made at all, in which case the
+		// player is dropped instead of taking up a slot that would never be freed.
+		template<typename TFunc>
+		void Start(PlayerRequestScheduler& scheduler, RequestBudget& budget, time_point_t now, TFunc&& startRequest)
+		{
+			while (m_InFlight.size() < m_MaxInFlight)
+			{
+				const auto ids = scheduler.TakeBatch(1, budget, now);
+				if (ids.empty())
+					break;
+
+				std::future<TResult> response = startRequest(ids.front());
+				if (!response.valid())
+				{
+					scheduler.Cancel(ids.front());
+					continue;
+				}
+
+				m_InFlight.push_back({ ids.front(), std::move(response) });
+			}
+		}
+
+		// Calls onFinished(id, future) for every request that finished, and frees their slots
+		template<typename TFunc>
+		void TakeFinished(TFunc&& onFinished)
+		{
+			for (auto it = m_InFlight.begin(); it != m_InFlight.end(); )
+			{
+				if (!mh::is_future_ready(it->m_Response))
+				{
+					++it;
+					continue;
+				}
+
+				onFinished(it->m_SteamID, it->m_Response);
+				it = m_InFlight.erase(it);
+			}
+		}
+
+		size_t GetInFlightCount() const { return m_InFlight.size(); }
+
+	private:
+		struct Request
+		{
+			SteamID m_SteamID;
+			std::future<TResult> m_Response;
+		};
+
+		size_t m_MaxInFlight;
+		std::vector<Request> m_InFlight;
+	};
+}
@@ -0,0 +1,46 @@
+#include "PlayerTable.h"
+
+#include <cassert>
+
+using namespace tf2_bot_detector;
+
+void PlayerTable::clear()
+{
+	m_SteamIDs.clear();
+	m_Teams.clear();
+	m_States.clear();
+	m_Pings.clear();
+	m_UserIDs.clear();
+	m_Scores.clear();
+	m_LastStatusUpdateTimes.clear();
+	m_NamesUnsafe.clear();
+	m_Players.clear();
+	m_Slots.clear();
+}
+
+auto PlayerTable::Add(IPlayer& player, const SteamID& id) -> slot_t
+{
+	assert(!m_Slots.contains(id));
+
+	const auto slot = slot_t(size());
+	m_SteamIDs.push_back(id);
+	m_Teams.push_back(TFTeam::Unknown);
+	m_States.push_back(PlayerStatusState::Invalid);
+	m_Pings.push_back(0);
+	m_UserIDs.push_back(0);
+	m_Scores.emplace_back();
+	m_LastStatusUpdateTimes.emplace_back();
+	m_NamesUnsafe.emplace_back();
+	m_Players.push_back(&player);
+
+	m_Slots.emplace(id, slot);
+	return slot;
+}
+
+auto PlayerTable::FindSlot(const SteamID& id) const -> std::optional<slot_t>
+{
+	if (auto found = m_Slots.find(id); found != m_Slots.end())
+		return found->second;
+
+	return std::nullopt;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Clock.h"
+#include "IPlayer.h"
+#include "PlayerStatus.h"
+#include "SteamID.h"
+#include "TFConstants.h"
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Dense, slot-indexed storage for the per-player fields we scan every frame/tick.
+	// Every column has the same length; slot N in one column refers to the same player
+	// as slot N in every other column. Slots are only ever appended, and are all released
+	// together by clear().
+	class PlayerTable final
+	{
+	public:
+		using slot_t = uint32_t;
+
+		size_t size() const { return m_SteamIDs.size(); }
+		bool empty() const { return m_SteamIDs.empty(); }
+		void clear();
+
+		slot_t Add(IPlayer& player, const SteamID& id);
+		std::optional<slot_t> FindSlot(const SteamID& id) const;
+
+		// Hot columns
+		std::vector<SteamID> m_SteamIDs;
+		std::vector<TFTeam> m_Teams;
+		std::vector<PlayerStatusState> m_States;
+		std::vector<uint16_t> m_Pings;
+		std::vector<UserID_t> m_UserIDs;
+		std::vector<PlayerScores> m_Scores;
+		std::vector<time_point_t> m_LastStatusUpdateTimes;
+		std::vector<std::string> m_NamesUnsafe;
+
+		// Everything else lives behind the IPlayer
+		std::vector<IPlayer*> m_Players;
+
+	private:
+		std::unordered_map<SteamID, slot_t> m_Slots;
+	};
+}
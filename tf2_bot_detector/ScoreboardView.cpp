@@ -0,0 +1,121 @@
+#include "ScoreboardView.h"
+#include "IPlayer.h"
+
+#include <algorithm>
+#include <compare>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+void ScoreboardView::clear()
+{
+	m_Slots.clear();
+	m_Players.clear();
+	m_MembershipDirty = true;
+	m_OrderDirty = true;
+}
+
+void ScoreboardView::Update(const PlayerTable& table, const DerefRange<const IPlayer>& lobbyMembers,
+	time_point_t lastStatusUpdateTime)
+{
+	if (!m_MembershipDirty && !m_OrderDirty)
+		return;
+
+	if (m_MembershipDirty)
+		UpdateMembership(table, lobbyMembers, lastStatusUpdateTime);
+
+	UpdateOrder(table);
+
+	m_Players.clear();
+	for (auto slot : m_Slots)
+		m_Players.push_back(table.m_Players[slot]);
+
+	m_MembershipDirty = false;
+	m_OrderDirty = false;
+}
+
+void ScoreboardView::UpdateMembership(const PlayerTable& table, const DerefRange<const IPlayer>& lobbyMembers,
+	time_point_t lastStatusUpdateTime)
+{
+	m_IsMember.assign(table.size(), false);
+
+	size_t memberCount = 0;
+	for (const IPlayer& member : lobbyMembers)
+	{
+		if (auto slot = table.FindSlot(member.GetSteamID()); slot && !m_IsMember[*slot])
+		{
+			m_IsMember[*slot] = true;
+			memberCount++;
+		}
+	}
+
+	if (memberCount == 0)
+	{
+		// We seem to have either an empty lobby or we're playing on a community server.
+		// Just find the most recent status updates.
+		const auto minUpdateTime = lastStatusUpdateTime - 15s;
+		for (size_t i = 0; i < table.size(); i++)
+		{
+			if (table.m_LastStatusUpdateTimes[i] >= minUpdateTime)
+				m_IsMember[i] = true;
+		}
+	}
+
+	// Keep the survivors in their previous order so the sort below only has to move the newcomers
+	const auto oldEnd = std::remove_if(m_Slots.begin(), m_Slots.end(), [&](PlayerTable::slot_t slot)
+		{
+			if (slot >= m_IsMember.size() || !m_IsMember[slot])
+				return true;
+
+			m_IsMember[slot] = false;  // Already present
+			return false;
+		});
+	m_Slots.erase(oldEnd, m_Slots.end());
+
+	for (size_t i = 0; i < m_IsMember.size(); i++)
+	{
+		if (m_IsMember[i])
+			m_Slots.push_back(PlayerTable::slot_t(i));
+	}
+}
+
+void ScoreboardView::UpdateOrder(const PlayerTable& table)
+{
+	const auto IsBefore = [&](PlayerTable::slot_t lhs, PlayerTable::slot_t rhs) -> bool
+	{
+		const PlayerScores& lhsScores = table.m_Scores[lhs];
+		const PlayerScores& rhsScores = table.m_Scores[rhs];
+
+		// Intentionally reversed, we want descending kill order
+		if (auto killsResult = rhsScores.m_Kills <=> lhsScores.m_Kills; !std::is_eq(killsResult))
+			return std::is_lt(killsResult);
+
+		if (auto deathsResult = lhsScores.m_Deaths <=> rhsScores.m_Deaths; !std::is_eq(deathsResult))
+			return std::is_lt(deathsResult);
+
+		// Sort by ascending userid
+		{
+			auto luid = table.m_UserIDs[lhs];
+			auto ruid = table.m_UserIDs[rhs];
+			if (luid > 0 && ruid > 0)
+			{
+				if (auto result = luid <=> ruid; !std::is_eq(result))
+					return std::is_lt(result);
+			}
+		}
+
+		return false;
+	};
+
+	// Insertion sort: the previous order is almost always nearly correct (a kill moves
+	// one or two rows), so this is linear in practice and keeps ties in a stable order.
+	for (size_t i = 1; i < m_Slots.size(); i++)
+	{
+		const auto slot = m_Slots[i];
+		size_t j = i;
+		for (; j > 0 && IsBefore(slot, m_Slots[j - 1]); j--)
+			m_Slots[j] = m_Slots[j - 1];
+
+		m_Slots[j] = slot;
+	}
+}
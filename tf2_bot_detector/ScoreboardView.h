@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Clock.h"
+#include "PlayerTable.h"
+#include "Util/RangeUtils.h"
+
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	class IPlayer;
+
+	// Scoreboard rows in display order: descending kills, ascending deaths, then ascending userid.
+	// The owner marks it dirty when the relevant console lines arrive, and the order is
+	// repaired incrementally from the previous one instead of being re-sorted every frame.
+	class ScoreboardView final
+	{
+	public:
+		void MarkMembershipDirty() { m_MembershipDirty = true; }
+		void MarkOrderDirty() { m_OrderDirty = true; }
+		void clear();
+
+		// Lobby members are shown if there are any. Otherwise (community servers), everyone
+		// who showed up in the most recent status output is shown instead.
+		void Update(const PlayerTable& table, const DerefRange<const IPlayer>& lobbyMembers,
+			time_point_t lastStatusUpdateTime);
+
+		DerefRange<IPlayer> GetPlayers() const { return m_Players; }
+
+	private:
+		void UpdateMembership(const PlayerTable& table, const DerefRange<const IPlayer>& lobbyMembers,
+			time_point_t lastStatusUpdateTime);
+		void UpdateOrder(const PlayerTable& table);
+
+		std::vector<PlayerTable::slot_t> m_Slots;
+		std::vector<IPlayer*> m_Players;
+		std::vector<bool> m_IsMember;  // Scratch space, indexed by slot
+
+		bool m_MembershipDirty = true;
+		bool m_OrderDirty = true;
+	};
+}
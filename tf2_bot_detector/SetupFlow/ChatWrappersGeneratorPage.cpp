@@ -3,6 +3,7 @@
 #include "UI/ImGui_TF2BotDetector.h"
 #include "Log.h"
 #include "Platform/Platform.h"
+#include "TaskScheduler.h"
 
 #include <mh/future.hpp>
 #include <mh/text/string_insertion.hpp>
@@ -17,7 +18,7 @@ using namespace tf2_bot_detector;
 
 bool ChatWrappersGeneratorPage::ValidateSettings(const Settings& settings) const
 {
-	return settings.m_Unsaved.m_ChatMsgWrappers.has_value();
+	return settings.m_Unsaved.GetChatMsgWrappers().has_value();
 }
 
 auto ChatWrappersGeneratorPage::OnDraw(const DrawState& ds) -> OnDrawResult
@@ -114,7 +115,8 @@ void ChatWrappersGeneratorPage::Init(const Settings& settings)
 
 		DebugLog("Regenerating chat wrappers...");
 		auto progress = m_Progress = std::make_shared<ChatWrappersProgress>();
-		m_ChatWrappersGenerated = std::async([tfDir, progress] { return RandomizeChatWrappers(tfDir, progress.get()); });
+		m_ChatWrappersGenerated = TaskScheduler::Get().Run(TaskPriority::UICritical,
+			[tfDir, progress] { return RandomizeChatWrappers(tfDir, progress.get()); });
 	}
 }
 
@@ -130,14 +132,14 @@ void ChatWrappersGeneratorPage::Commit(Settings& settings)
 	if (m_ChatWrappersGenerated.valid())
 	{
 		assert(mh::is_future_ready(m_ChatWrappersGenerated));
-		settings.m_Unsaved.m_ChatMsgWrappers = m_ChatWrappersGenerated.get();
+		settings.m_Unsaved.SetChatMsgWrappers(m_ChatWrappersGenerated.get());
 
 		// Write chat wrappers
 		{
 			nlohmann::json json;
 			json =
 			{
-				{ "wrappers", settings.m_Unsaved.m_ChatMsgWrappers.value() }
+				{ "wrappers", settings.m_Unsaved.GetChatMsgWrappers().value() }
 			};
 
 			auto jsonFileName = GetSavedChatMsgWrappersFilename(settings.GetTFDir());
@@ -149,7 +151,7 @@ void ChatWrappersGeneratorPage::Commit(Settings& settings)
 	}
 	else
 	{
-		settings.m_Unsaved.m_ChatMsgWrappers = m_ChatWrappersLoaded.value();
+		settings.m_Unsaved.SetChatMsgWrappers(m_ChatWrappersLoaded.value());
 	}
 
 	// Generate a random token that will be used to verify that our
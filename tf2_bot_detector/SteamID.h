@@ -4,9 +4,11 @@
 
 #include <cassert>
 #include <compare>
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
 #include <string_view>
+#include <vector>
 
 namespace tf2_bot_detector
 {
@@ -89,6 +91,295 @@ namespace tf2_bot_detector
 	};
 	static_assert(sizeof(SteamID) == sizeof(uint64_t));
 
+	enum class SteamIDParseError
+	{
+		None,
+		UnknownFormat,
+		UnknownAccountType,
+		OutOfRange,
+	};
+
+	// Parses SteamID3 ("[U:1:123]", "[U:1:123:1]"), SteamID2 ("STEAM_0:1:123")
+	// and SteamID64 strings without allocating or throwing. Usable in constant
+	// expressions, so it only touches SteamID::ID64.
+	constexpr SteamIDParseError TryParseSteamID(const std::string_view& str, SteamID& id);
+
+	struct SteamIDBulkParseResult
+	{
+		size_t m_Parsed = 0;
+		size_t m_Failed = 0;
+	};
+
+	// Parses every whitespace and/or comma separated SteamID in buffer, appending them to ids
+	SteamIDBulkParseResult ParseSteamIDs(const std::string_view& buffer, std::vector<SteamID>& ids);
+
+	// Fixed capacity buffer holding a formatted SteamID
+	class SteamIDText final
+	{
+	public:
+		constexpr std::string_view view() const { return std::string_view(m_Buf, m_Length); }
+		constexpr operator std::string_view() const { return view(); }
+
+		constexpr void Append(char c) { m_Buf[m_Length++] = c; }
+		constexpr void Append(const std::string_view& str)
+		{
+			for (char c : str)
+				Append(c);
+		}
+		constexpr void AppendUInt(uint64_t value)
+		{
+			char digits[20]{};
+			size_t count = 0;
+			do
+			{
+				digits[count++] = char('0' + (value % 10));
+				value /= 10;
+
+			} while (value);
+
+			while (count)
+				Append(digits[--count]);
+		}
+
+	private:
+		char m_Buf[32]{};
+		uint8_t m_Length = 0;
+	};
+
+	constexpr SteamIDText FormatSteamID3(const SteamID& id);  // [U:1:123]
+	constexpr SteamIDText FormatSteamID2(const SteamID& id);  // STEAM_0:1:61
+	constexpr SteamIDText FormatSteamID64(const SteamID& id); // 76561197960265851
+
+	namespace detail::steamid
+	{
+		inline constexpr uint64_t ACCOUNT_ID_MASK = 0xFFFFFFFF;
+		inline constexpr uint64_t INSTANCE_SHIFT = 32;
+		inline constexpr uint64_t INSTANCE_MASK = 0xFFFFF;
+		inline constexpr uint64_t TYPE_SHIFT = 52;
+		inline constexpr uint64_t TYPE_MASK = 0xF;
+		inline constexpr uint64_t UNIVERSE_SHIFT = 56;
+
+		constexpr uint64_t Compose(uint64_t id, SteamAccountType type, uint64_t universe,
+			uint64_t instance = uint64_t(SteamAccountInstance::Desktop))
+		{
+			return (id & ACCOUNT_ID_MASK) |
+				((instance & INSTANCE_MASK) << INSTANCE_SHIFT) |
+				((uint64_t(type) & TYPE_MASK) << TYPE_SHIFT) |
+				((universe & 0xFF) << UNIVERSE_SHIFT);
+		}
+
+		constexpr uint32_t GetAccountID(uint64_t id64) { return uint32_t(id64 & ACCOUNT_ID_MASK); }
+		constexpr SteamAccountType GetType(uint64_t id64) { return SteamAccountType((id64 >> TYPE_SHIFT) & TYPE_MASK); }
+		constexpr uint32_t GetUniverse(uint64_t id64) { return uint32_t(id64 >> UNIVERSE_SHIFT); }
+
+		constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+		// \d+, all of str, no larger than maxValue
+		constexpr SteamIDParseError ParseUInt(const std::string_view& str, uint64_t maxValue, uint64_t& value)
+		{
+			if (str.empty())
+				return SteamIDParseError::UnknownFormat;
+
+			value = 0;
+			for (char c : str)
+			{
+				if (!IsDigit(c))
+					return SteamIDParseError::UnknownFormat;
+
+				const uint64_t digit = uint64_t(c - '0');
+				if (value > (maxValue - digit) / 10)
+					return SteamIDParseError::OutOfRange;
+
+				value = value * 10 + digit;
+			}
+
+			return SteamIDParseError::None;
+		}
+
+		constexpr SteamIDParseError ParseSteamID3(std::string_view str, uint64_t& id64)
+		{
+			// \[([a-zA-Z]):(\d):(\d+)(?::(\d+))?\]
+			if (str.size() < 7 || str.front() != '[' || str.back() != ']' || str[2] != ':' || str[4] != ':' || !IsDigit(str[3]))
+				return SteamIDParseError::UnknownFormat;
+
+			SteamAccountType type{};
+			switch (str[1])
+			{
+			case 'U': type = SteamAccountType::Individual; break;
+			case 'M': type = SteamAccountType::Multiseat; break;
+			case 'G': type = SteamAccountType::GameServer; break;
+			case 'A': type = SteamAccountType::AnonGameServer; break;
+			case 'P': type = SteamAccountType::Pending; break;
+			case 'C': type = SteamAccountType::ContentServer; break;
+			case 'g': type = SteamAccountType::Clan; break;
+			case 'a': type = SteamAccountType::AnonUser; break;
+
+			case 'T':
+			case 'L':
+			case 'c':
+				type = SteamAccountType::Chat; break;
+
+			case 'I':
+				type = SteamAccountType::Invalid; break;
+
+			default:
+				if ((str[1] >= 'a' && str[1] <= 'z') || (str[1] >= 'A' && str[1] <= 'Z'))
+					return SteamIDParseError::UnknownAccountType;
+
+				return SteamIDParseError::UnknownFormat;
+			}
+
+			const uint64_t universe = uint64_t(str[3] - '0');
+
+			str = str.substr(5, str.size() - 6);
+			std::string_view idStr = str;
+			std::string_view instanceStr;
+			if (const auto colon = str.find(':'); colon != str.npos)
+			{
+				idStr = str.substr(0, colon);
+				instanceStr = str.substr(colon + 1);
+				if (instanceStr.empty())
+					return SteamIDParseError::UnknownFormat;
+			}
+
+			uint64_t id = 0;
+			if (auto error = ParseUInt(idStr, 0xFFFFFFFF, id); error != SteamIDParseError::None)
+				return error;
+
+			uint64_t instance = uint64_t(SteamAccountInstance::Desktop);
+			if (!instanceStr.empty())
+			{
+				if (auto error = ParseUInt(instanceStr, 0xFFFFFFFF, instance); error != SteamIDParseError::None)
+					return error;
+			}
+
+			// [I:...] is a valid, but entirely empty, SteamID
+			id64 = (type == SteamAccountType::Invalid) ? 0 : Compose(id, type, universe, instance);
+			return SteamIDParseError::None;
+		}
+
+		constexpr SteamIDParseError ParseSteamID2(std::string_view str, uint64_t& id64)
+		{
+			// STEAM_X:Y:Z, where the account ID is Z * 2 + Y
+			constexpr std::string_view PREFIX = "STEAM_";
+			if (str.size() < PREFIX.size() + 5 || str.substr(0, PREFIX.size()) != PREFIX)
+				return SteamIDParseError::UnknownFormat;
+
+			str = str.substr(PREFIX.size());
+			if (!IsDigit(str[0]) || str[1] != ':' || (str[2] != '0' && str[2] != '1') || str[3] != ':')
+				return SteamIDParseError::UnknownFormat;
+
+			// Old versions of the engine print universe 0 for public accounts
+			uint64_t universe = uint64_t(str[0] - '0');
+			if (universe == 0)
+				universe = uint64_t(SteamAccountUniverse::Public);
+
+			uint64_t z = 0;
+			if (auto error = ParseUInt(str.substr(4), 0x7FFFFFFF, z); error != SteamIDParseError::None)
+				return error;
+
+			id64 = Compose(z * 2 + uint64_t(str[2] - '0'), SteamAccountType::Individual, universe);
+			return SteamIDParseError::None;
+		}
+
+		constexpr bool IsSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+		}
+
+		constexpr SteamIDParseError ParseSteamID64(std::string_view str, uint64_t& id64)
+		{
+			while (!str.empty() && IsSpace(str.front()))
+				str.remove_prefix(1);
+			while (!str.empty() && IsSpace(str.back()))
+				str.remove_suffix(1);
+
+			return ParseUInt(str, UINT64_MAX, id64);
+		}
+
+		constexpr char GetAccountTypeChar(SteamAccountType type)
+		{
+			switch (type)
+			{
+			case SteamAccountType::Individual:     return 'U';
+			case SteamAccountType::Multiseat:      return 'M';
+			case SteamAccountType::GameServer:     return 'G';
+			case SteamAccountType::AnonGameServer: return 'A';
+			case SteamAccountType::Pending:        return 'P';
+			case SteamAccountType::ContentServer:  return 'C';
+			case SteamAccountType::Clan:           return 'g';
+			case SteamAccountType::AnonUser:       return 'a';
+			case SteamAccountType::Chat:           return 'c';
+
+			default:
+				assert(!"Invalid value when serializing SteamID");
+			case SteamAccountType::Invalid:        return 'I';
+			}
+		}
+	}
+
+	constexpr SteamIDParseError TryParseSteamID(const std::string_view& str, SteamID& id)
+	{
+		using namespace detail::steamid;
+
+		uint64_t id64 = 0;
+		SteamIDParseError error = SteamIDParseError::UnknownFormat;
+		if (!str.empty())
+		{
+			// The first character is enough to tell the formats apart
+			if (str.front() == '[')
+				error = ParseSteamID3(str, id64);
+			else if (str.front() == 'S')
+				error = ParseSteamID2(str, id64);
+			else
+				error = ParseSteamID64(str, id64);
+		}
+
+		if (error == SteamIDParseError::None)
+			id = SteamID(id64);
+
+		return error;
+	}
+
+	constexpr SteamIDText FormatSteamID3(const SteamID& id)
+	{
+		using namespace detail::steamid;
+
+		SteamIDText text;
+		text.Append('[');
+		text.Append(GetAccountTypeChar(GetType(id.ID64)));
+		text.Append(':');
+		text.AppendUInt(GetUniverse(id.ID64));
+		text.Append(':');
+		text.AppendUInt(GetAccountID(id.ID64));
+		text.Append(']');
+		return text;
+	}
+
+	constexpr SteamIDText FormatSteamID2(const SteamID& id)
+	{
+		using namespace detail::steamid;
+
+		const auto universe = GetUniverse(id.ID64);
+		const auto accountID = GetAccountID(id.ID64);
+
+		SteamIDText text;
+		text.Append("STEAM_");
+		text.AppendUInt(universe == uint32_t(SteamAccountUniverse::Public) ? 0 : universe);
+		text.Append(':');
+		text.AppendUInt(accountID & 1);
+		text.Append(':');
+		text.AppendUInt(accountID >> 1);
+		return text;
+	}
+
+	constexpr SteamIDText FormatSteamID64(const SteamID& id)
+	{
+		SteamIDText text;
+		text.AppendUInt(id.ID64);
+		return text;
+	}
+
 	void to_json(nlohmann::json& j, const SteamID& d);
 	void from_json(const nlohmann::json& j, SteamID& d);
 }
@@ -108,25 +399,8 @@ namespace std
 template<typename CharT, typename Traits>
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const tf2_bot_detector::SteamID& id)
 {
-	using namespace tf2_bot_detector;
-
-	char c;
-	switch (id.Type)
-	{
-	case SteamAccountType::Individual:     c = 'U'; break;
-	case SteamAccountType::Multiseat:      c = 'M'; break;
-	case SteamAccountType::GameServer:     c = 'G'; break;
-	case SteamAccountType::AnonGameServer: c = 'A'; break;
-	case SteamAccountType::Pending:        c = 'P'; break;
-	case SteamAccountType::ContentServer:  c = 'C'; break;
-	case SteamAccountType::Clan:           c = 'g'; break;
-	case SteamAccountType::AnonUser:       c = 'a'; break;
-	case SteamAccountType::Chat:           c = 'c'; break;
-
-	default:
-		assert(!"Invalid value when serializing SteamID");
-	case SteamAccountType::Invalid:        c = 'I'; break;
-	}
+	for (char c : tf2_bot_detector::FormatSteamID3(id).view())
+		os << c;
 
-	return os << '[' << c << ':' << static_cast<int>(id.Universe) << ':' << id.ID << ']';
+	return os;
 }
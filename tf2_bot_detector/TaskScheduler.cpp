@@ -0,0 +1,326 @@
+#include "TaskScheduler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// Which worker (if any) the current thread is, so tasks posted from a task stay on that worker's queue
+	thread_local const TaskScheduler* t_CurrentScheduler = nullptr;
+	thread_local size_t t_CurrentWorker = 0;
+}
+
+struct TaskScheduler::WorkerQueue
+{
+	std::mutex m_Mutex;
+	std::array<std::deque<Task>, PRIORITY_COUNT> m_Tasks;
+};
+
+TaskScheduler::TaskScheduler(uint32_t threadCount)
+{
+	assert(threadCount > 0);
+
+	m_RunLimits[size_t(TaskPriority::UICritical)] = threadCount;
+	m_RunLimits[size_t(TaskPriority::Network)] = std::max(threadCount - 1, 1u);
+	m_RunLimits[size_t(TaskPriority::BackgroundIO)] = std::max(threadCount / 2, 1u);
+
+	for (uint32_t i = 0; i < threadCount; i++)
+		m_Queues.push_back(std::make_unique<WorkerQueue>());
+
+	// All the threads we'll ever need, up front
+	for (uint32_t i = 0; i < threadCount; i++)
+		m_Workers.emplace_back(&TaskScheduler::WorkerThread, this, size_t(i));
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard lock(m_WakeMutex);
+		m_Stop = true;
+	}
+	m_WakeCV.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+}
+
+TaskScheduler& TaskScheduler::Get()
+{
+	static TaskScheduler s_Instance(std::clamp(std::thread::hardware_concurrency(), 4u, 8u));
+	return s_Instance;
+}
+
+void TaskScheduler::Post(TaskPriority priority, Task task)
+{
+	assert(task);
+	assert(priority < TaskPriority::COUNT);
+
+	const size_t queueIndex = (t_CurrentScheduler == this) ?
+		t_CurrentWorker : (m_NextQueue++ % m_Queues.size());
+
+	// Counted before it's visible, so the counts never go negative
+	m_Queued[size_t(priority)]++;
+	const size_t totalQueued = ++m_TotalQueued;
+	for (size_t peak = m_PeakQueued; peak < totalQueued && !m_PeakQueued.compare_exchange_weak(peak, totalQueued); )
+		;
+
+	{
+		WorkerQueue& queue = *m_Queues[queueIndex];
+		std::lock_guard lock(queue.m_Mutex);
+		queue.m_Tasks[size_t(priority)].push_back(std::move(task));
+	}
+
+	Wake();
+}
+
+void TaskScheduler::AddContinuation(std::function<bool()> isReady, TaskPriority priority, Task task)
+{
+	if (isReady())
+	{
+		Post(priority, std::move(task));
+		return;
+	}
+
+	{
+		std::lock_guard lock(m_ContinuationsMutex);
+		m_Continuations.push_back({ std::move(isReady), priority, std::move(task) });
+		m_ContinuationCount = m_Continuations.size();
+	}
+
+	// The dependency might have finished between the check above and being parked
+	ReleaseReadyContinuations();
+}
+
+void TaskScheduler::ReleaseReadyContinuations()
+{
+	if (m_ContinuationCount == 0)
+		return;
+
+	std::vector<Continuation> ready;
+	{
+		std::lock_guard lock(m_ContinuationsMutex);
+		auto firstReady = std::stable_partition(m_Continuations.begin(), m_Continuations.end(),
+			[](const Continuation& continuation) { return !continuation.m_IsReady(); });
+
+		std::move(firstReady, m_Continuations.end(), std::back_inserter(ready));
+		m_Continuations.erase(firstReady, m_Continuations.end());
+		m_ContinuationCount = m_Continuations.size();
+	}
+
+	for (Continuation& continuation : ready)
+		Post(continuation.m_Priority, std::move(continuation.m_Task));
+}
+
+void TaskScheduler::ParallelFor(TaskPriority priority, size_t count, const std::function<void(size_t)>& func)
+{
+	if (count == 0)
+		return;
+
+	struct State
+	{
+		const std::function<void(size_t)>* m_Func = nullptr;
+		size_t m_Count = 0;
+		std::atomic<size_t> m_NextIndex = 0;
+		std::atomic<size_t> m_Finished = 0;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_FinishedCV;
+		std::exception_ptr m_Exception;
+
+		void RunItems()
+		{
+			// Helpers that only get to run after everything was claimed never touch m_Func,
+			// which is gone by then
+			for (size_t index = m_NextIndex++; index < m_Count; index = m_NextIndex++)
+			{
+				try
+				{
+					(*m_Func)(index);
+				}
+				catch (...)
+				{
+					std::lock_guard lock(m_Mutex);
+					if (!m_Exception)
+						m_Exception = std::current_exception();
+				}
+
+				if (++m_Finished == m_Count)
+				{
+					std::lock_guard lock(m_Mutex);
+					m_FinishedCV.notify_all();
+				}
+			}
+		}
+	};
+
+	auto state = std::make_shared<State>();
+	state->m_Func = &func;
+	state->m_Count = count;
+
+	const size_t helperCount = std::min(count - 1, m_Workers.size());
+	for (size_t i = 0; i < helperCount; i++)
+		Post(priority, [state] { state->RunItems(); });
+
+	// Never just wait: if every worker is busy, we still get through the whole range ourselves
+	state->RunItems();
+
+	std::unique_lock lock(state->m_Mutex);
+	state->m_FinishedCV.wait(lock, [&] { return state->m_Finished == state->m_Count; });
+
+	if (state->m_Exception)
+		std::rethrow_exception(state->m_Exception);
+}
+
+TaskSchedulerStats TaskScheduler::GetStats() const
+{
+	TaskSchedulerStats stats;
+	stats.m_ThreadCount = GetThreadCount();
+	for (size_t i = 0; i < PRIORITY_COUNT; i++)
+	{
+		stats.m_Queued[i] = m_Queued[i];
+		stats.m_Running[i] = m_Running[i];
+	}
+
+	stats.m_PeakQueued = m_PeakQueued;
+	stats.m_WaitingContinuations = m_ContinuationCount;
+	stats.m_Completed = m_Completed;
+	stats.m_Stolen = m_Stolen;
+	return stats;
+}
+
+void TaskScheduler::WorkerThread(size_t workerIndex)
+{
+	t_CurrentScheduler = this;
+	t_CurrentWorker = workerIndex;
+
+	while (true)
+	{
+		if (TryRunTask(workerIndex))
+			continue;
+
+		{
+			std::unique_lock lock(m_WakeMutex);
+			const auto ShouldWake = [&] { return m_Stop || HasRunnableTasks(); };
+
+			// Nothing announces when a future from outside the scheduler becomes ready,
+			// so check back every so often, more often while there are continuations waiting
+			m_WakeCV.wait_for(lock, (m_ContinuationCount > 0) ? 50ms : 1s, ShouldWake);
+
+			if (m_Stop)
+				break;
+		}
+
+		ReleaseReadyContinuations();
+	}
+}
+
+bool TaskScheduler::TryRunTask(size_t queueIndex)
+{
+	for (size_t priority = 0; priority < PRIORITY_COUNT; priority++)
+	{
+		if (m_Queued[priority] == 0 || !TryReserve(TaskPriority(priority)))
+			continue;
+
+		// Our own queue first (oldest task), then steal from everyone else (newest task)
+		Task task;
+		bool stolen = false;
+		for (size_t i = 0; i < m_Queues.size() && !task; i++)
+		{
+			const size_t index = (queueIndex + i) % m_Queues.size();
+			WorkerQueue& queue = *m_Queues[index];
+
+			std::lock_guard lock(queue.m_Mutex);
+			auto& tasks = queue.m_Tasks[priority];
+			if (tasks.empty())
+				continue;
+
+			if (index == queueIndex)
+			{
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			else
+			{
+				task = std::move(tasks.back());
+				tasks.pop_back();
+				stolen = true;
+			}
+		}
+
+		if (!task)
+		{
+			m_Running[priority]--;
+			continue;
+		}
+
+		m_Queued[priority]--;
+		m_TotalQueued--;
+		if (stolen)
+			m_Stolen++;
+
+		try
+		{
+			task();
+		}
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Unhandled exception in background task");
+		}
+		catch (...)
+		{
+			LogError(MH_SOURCE_LOCATION_CURRENT(), "Unhandled exception of unknown type in background task");
+		}
+
+		task = nullptr;
+		m_Running[priority]--;
+		m_Completed++;
+
+		ReleaseReadyContinuations();
+
+		// Tasks held back by a priority's cap might be able to go now
+		if (m_TotalQueued > 0)
+			Wake();
+
+		return true;
+	}
+
+	return false;
+}
+
+bool TaskScheduler::TryReserve(TaskPriority priority)
+{
+	auto& running = m_Running[size_t(priority)];
+	const uint32_t limit = m_RunLimits[size_t(priority)];
+	for (uint32_t current = running; current < limit; )
+	{
+		if (running.compare_exchange_weak(current, current + 1))
+			return true;
+	}
+
+	return false;
+}
+
+bool TaskScheduler::HasRunnableTasks() const
+{
+	for (size_t i = 0; i < PRIORITY_COUNT; i++)
+	{
+		if (m_Queued[i] > 0 && m_Running[i] < m_RunLimits[i])
+			return true;
+	}
+
+	return false;
+}
+
+void TaskScheduler::Wake()
+{
+	// Synchronize with workers checking HasRunnableTasks() before they go to sleep
+	{
+		std::lock_guard lock(m_WakeMutex);
+	}
+	m_WakeCV.notify_one();
+}
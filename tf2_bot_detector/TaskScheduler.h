@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Most important first
+	enum class TaskPriority : uint8_t
+	{
+		UICritical,    // Someone is looking at a progress bar/placeholder until this finishes
+		Network,       // HTTP requests (which block a worker while in flight) and parsing their responses
+		BackgroundIO,  // Disk housekeeping nobody is waiting on
+
+		COUNT,
+	};
+
+	struct TaskSchedulerStats
+	{
+		static constexpr size_t PRIORITY_COUNT = size_t(TaskPriority::COUNT);
+
+		uint32_t m_ThreadCount = 0;
+		std::array<size_t, PRIORITY_COUNT> m_Queued{};
+		std::array<size_t, PRIORITY_COUNT> m_Running{};
+		size_t m_PeakQueued = 0;             // Most tasks ever queued at once, across all priorities
+		size_t m_WaitingContinuations = 0;   // Continuations whose dependency isn't ready yet
+		uint64_t m_Completed = 0;
+		uint64_t m_Stolen = 0;               // Tasks run by a worker other than the one they were queued on
+	};
+
+	// Process-wide, fixed-size pool of worker threads that all background work goes through.
+	// Every worker has a queue per priority and steals from the others once its own run dry.
+	// Network and BackgroundIO tasks are capped below the thread count, so blocking requests
+	// can't occupy every worker and starve UICritical tasks.
+	class TaskScheduler final
+	{
+	public:
+		explicit TaskScheduler(uint32_t threadCount);
+		~TaskScheduler();
+
+		static TaskScheduler& Get();
+
+		using Task = std::function<void()>;
+
+		// Exceptions thrown by task are logged and swallowed
+		void Post(TaskPriority priority, Task task);
+
+		template<typename TFunc>
+		auto Run(TaskPriority priority, TFunc&& func)
+		{
+			using result_t = std::invoke_result_t<TFunc>;
+			auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<TFunc>(func));
+			auto retVal = task->get_future();
+			Post(priority, [task] { (*task)(); });
+			return retVal;
+		}
+
+		// Queues func(dependency) once dependency is ready, instead of tying up a thread waiting on it.
+		// Dependencies are rechecked whenever a task on this scheduler finishes, so they should come
+		// from this scheduler (other futures are still picked up, just less promptly).
+		template<typename T, typename TFunc>
+		auto ContinueWith(std::shared_future<T> dependency, TaskPriority priority, TFunc&& func)
+		{
+			using result_t = std::invoke_result_t<TFunc, const std::shared_future<T>&>;
+			auto task = std::make_shared<std::packaged_task<result_t()>>(
+				[dependency, func = std::forward<TFunc>(func)]() mutable { return func(dependency); });
+			auto retVal = task->get_future();
+
+			AddContinuation(
+				[dependency]
+				{
+					return !dependency.valid() || dependency.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+				},
+				priority, [task] { (*task)(); });
+
+			return retVal;
+		}
+
+		// Calls func on every element in [begin, end) and returns once they're all done. The calling
+		// thread works through the range too, so this is safe to call from inside a task. The first
+		// exception thrown by func is rethrown here.
+		template<typename TIter, typename TFunc>
+		void ParallelForEach(TaskPriority priority, TIter begin, TIter end, TFunc&& func)
+		{
+			const size_t count = size_t(std::distance(begin, end));
+			ParallelFor(priority, count, [&](size_t index) { func(*std::next(begin, index)); });
+		}
+
+		TaskSchedulerStats GetStats() const;
+		uint32_t GetThreadCount() const { return uint32_t(m_Workers.size()); }
+
+	private:
+		static constexpr size_t PRIORITY_COUNT = size_t(TaskPriority::COUNT);
+
+		struct WorkerQueue;
+		struct Continuation
+		{
+			std::function<bool()> m_IsReady;
+			TaskPriority m_Priority;
+			Task m_Task;
+		};
+
+		void ParallelFor(TaskPriority priority, size_t count, const std::function<void(size_t)>& func);
+		void AddContinuation(std::function<bool()> isReady, TaskPriority priority, Task task);
+		void ReleaseReadyContinuations();
+
+		void WorkerThread(size_t workerIndex);
+		bool TryRunTask(size_t queueIndex);
+		bool TryReserve(TaskPriority priority);
+		bool HasRunnableTasks() const;
+		void Wake();
+
+		std::array<uint32_t, PRIORITY_COUNT> m_RunLimits{};
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+		std::atomic<size_t> m_NextQueue = 0;
+
+		std::array<std::atomic<size_t>, PRIORITY_COUNT> m_Queued{};
+		std::array<std::atomic<uint32_t>, PRIORITY_COUNT> m_Running{};
+		std::atomic<size_t> m_TotalQueued = 0;
+		std::atomic<size_t> m_PeakQueued = 0;
+		std::atomic<uint64_t> m_Completed = 0;
+		std::atomic<uint64_t> m_Stolen = 0;
+
+		std::mutex m_ContinuationsMutex;
+		std::vector<Continuation> m_Continuations;
+		std::atomic<size_t> m_ContinuationCount = 0;
+
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCV;
+		bool m_Stop = false;
+	};
+}
@@ -0,0 +1,132 @@
+#include "Config/ChatWrappers.h"
+#include "Config/Settings.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class RandomText final
+	{
+	public:
+		explicit RandomText(uint32_t seed) : m_Random(seed) {}
+
+		uint32_t Next(uint32_t min, uint32_t max) { return std::uniform_int_distribution<uint32_t>(min, max)(m_Random); }
+
+		std::string NextName(size_t maxLength = 32)
+		{
+			constexpr std::string_view CHARS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_ :[]()\""sv;
+
+			std::string retVal(Next(1, uint32_t(maxLength)), ' ');
+			for (char& c : retVal)
+				c = CHARS[Next(0, uint32_t(CHARS.size() - 1))];
+
+			return retVal;
+		}
+
+		// Looks like everything else that shows up in the console
+		std::string NextLine()
+		{
+			switch (Next(0, 4))
+			{
+			default:
+			case 0:
+				return mh::format("#{:>7} \"{}\" [U:1:{}] {:02}:{:02} {:>6} {:>4} active",
+					Next(1, 9999), NextName(), Next(1, 2000000000), Next(0, 59), Next(0, 59), Next(0, 999), Next(0, 100));
+			case 1:
+				return mh::format("{} killed {} with scattergun.", NextName(), NextName());
+			case 2:
+				return mh::format("{:>4} ms : {}", Next(0, 999), NextName());
+			case 3:
+				return mh::format("Dropped {} from server (Disconnect by user.)", NextName());
+			case 4:
+				return NextName(100);
+			}
+		}
+
+	private:
+		std::mt19937 m_Random;
+	};
+}
+
+TEST_CASE("tf2bd_chat_wrapper_matcher")
+{
+	const ChatWrappers wrappers(ChatFmtStrLengths{});
+	const ChatWrapperMatcher matcher(wrappers);
+
+	RandomText random(9);
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < 1000; i++)
+	{
+		lines.push_back(random.NextLine());
+		REQUIRE(!matcher.MatchStart(lines.back()));
+	}
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		const auto category = ChatCategory(random.Next(0, uint32_t(ChatCategory::COUNT) - 1));
+		const auto& type = wrappers.m_Types[size_t(category)];
+		const std::string name = random.NextName();
+		const std::string message = random.NextName(100);
+
+		std::string line = type.m_Full.m_Start.m_Narrow;
+		line += type.m_Name.m_Start.m_Narrow + name + type.m_Name.m_End.m_Narrow;
+		line += " :  ";
+		line += type.m_Message.m_Start.m_Narrow + message + type.m_Message.m_End.m_Narrow;
+		line += type.m_Full.m_End.m_Narrow;
+		const size_t totalLength = line.size();
+		line += "\ntrailing text";
+
+		INFO("line " << i);
+		REQUIRE(matcher.MatchStart(line) == category);
+
+		ChatWrapperMatcher::DecodedMessage decoded;
+		REQUIRE(matcher.Decode(category, line, decoded) == ChatWrapperMatcher::DecodeResult::Success);
+		REQUIRE(decoded.m_Name == name);
+		REQUIRE(decoded.m_Message == message);
+		REQUIRE(decoded.m_TotalLength == totalLength);
+
+		const auto truncated = std::string_view(line).substr(0, totalLength - 1);
+		REQUIRE(matcher.Decode(category, truncated, decoded) == ChatWrapperMatcher::DecodeResult::Incomplete);
+	}
+
+	BENCHMARK("ChatWrapperMatcher::MatchStart (1000 non-chat lines)")
+	{
+		size_t matchCount = 0;
+		for (const auto& line : lines)
+		{
+			if (matcher.MatchStart(line))
+				matchCount++;
+		}
+
+		return matchCount;
+	};
+}
+
+TEST_CASE("tf2bd_chat_wrappers_generation")
+{
+	Settings settings;
+	REQUIRE(!settings.m_Unsaved.GetChatMsgWrappers());
+	const auto initial = settings.m_Unsaved.GetChatMsgWrappersGeneration();
+
+	// Anything compiled from the wrappers only needs to check this, not compare them
+	settings.m_Unsaved.SetChatMsgWrappers(ChatWrappers(ChatFmtStrLengths{}));
+	const auto set = settings.m_Unsaved.GetChatMsgWrappersGeneration();
+	REQUIRE(set != initial);
+	REQUIRE(settings.m_Unsaved.GetChatMsgWrappersGeneration() == set);
+
+	// Even if they happen to be the same as before
+	settings.m_Unsaved.SetChatMsgWrappers(ChatWrappers(ChatFmtStrLengths{}));
+	REQUIRE(settings.m_Unsaved.GetChatMsgWrappersGeneration() != set);
+
+	settings.m_Unsaved.SetChatMsgWrappers(std::nullopt);
+	REQUIRE(!settings.m_Unsaved.GetChatMsgWrappers());
+}
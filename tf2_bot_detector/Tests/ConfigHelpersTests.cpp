@@ -0,0 +1,42 @@
+#include "Config/ConfigHelpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <future>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct TestList
+	{
+		size_t size() const { return 0; }
+	};
+
+	using ThirdPartyList = ConfigFileGroupBase<TestList>::ThirdPartyList;
+}
+
+TEST_CASE("tf2bd_config_third_party_list_reload")
+{
+	auto oldSnapshot = std::make_shared<const TestList>();
+	auto newSnapshot = std::make_shared<const TestList>();
+
+	std::promise<std::shared_ptr<const TestList>> loading;
+
+	ThirdPartyList list;
+	list.m_Previous = oldSnapshot;
+	list.m_Loading = loading.get_future().share();
+
+	// Still serving the old version while the new one loads
+	REQUIRE(!list.IsLoaded());
+	REQUIRE(list.GetSnapshot() == oldSnapshot);
+	REQUIRE(oldSnapshot.use_count() == 2);
+
+	loading.set_value(newSnapshot);
+	REQUIRE(list.IsLoaded());
+	REQUIRE(list.GetSnapshot() == newSnapshot);
+
+	// ...and then lets go of it
+	REQUIRE(oldSnapshot.use_count() == 1);
+	REQUIRE(!list.m_Previous);
+}
@@ -0,0 +1,96 @@
+#include "Networking/ConnectionPool.h"
+
+#include <catch2/catch.hpp>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct TestConnection
+	{
+		int m_ID = 0;
+	};
+
+	using TestPool = ConnectionPool<TestConnection>;
+}
+
+TEST_CASE("tf2bd_connection_pool_reuse")
+{
+	const auto start = TestPool::clock_type::time_point{} + 1h;
+	TestPool pool(2, 30s);
+
+	// Nothing to reuse yet
+	REQUIRE(!pool.TryAcquire(start));
+
+	REQUIRE(pool.Release(std::make_unique<TestConnection>(TestConnection{ 1 }), start));
+	REQUIRE(pool.Release(std::make_unique<TestConnection>(TestConnection{ 2 }), start + 1s));
+
+	// Full, so this one gets closed
+	REQUIRE(!pool.Release(std::make_unique<TestConnection>(TestConnection{ 3 }), start + 2s));
+	REQUIRE(pool.GetIdleCount() == 2);
+
+	// Most recently used first
+	auto connection = pool.TryAcquire(start + 2s);
+	REQUIRE(connection);
+	REQUIRE(connection->m_ID == 2);
+	REQUIRE(pool.GetIdleCount() == 1);
+
+	// A connection whose request failed is never released, so the next request gets a new one
+	connection.reset();
+	REQUIRE(pool.TryAcquire(start + 3s)->m_ID == 1);
+	REQUIRE(!pool.TryAcquire(start + 3s));
+	REQUIRE(pool.GetEvictedCount() == 0);
+}
+
+TEST_CASE("tf2bd_connection_pool_idle_timeout")
+{
+	const auto start = TestPool::clock_type::time_point{} + 1h;
+	TestPool pool(4, 30s);
+
+	pool.Release(std::make_unique<TestConnection>(TestConnection{ 1 }), start);
+	pool.Release(std::make_unique<TestConnection>(TestConnection{ 2 }), start + 10s);
+	pool.Release(std::make_unique<TestConnection>(TestConnection{ 3 }), start + 20s);
+
+	REQUIRE(pool.EvictExpired(start + 29s) == 0);
+	REQUIRE(pool.EvictExpired(start + 30s) == 1);
+	REQUIRE(pool.GetIdleCount() == 2);
+
+	// Likely closed by the server by now, so it's replaced by a new connection instead of reused
+	REQUIRE(!pool.TryAcquire(start + 1min));
+	REQUIRE(pool.GetIdleCount() == 0);
+	REQUIRE(pool.GetEvictedCount() == 3);
+
+	// Releasing a reconnected connection makes it reusable again
+	REQUIRE(pool.Release(std::make_unique<TestConnection>(TestConnection{ 4 }), start + 1min));
+	REQUIRE(pool.TryAcquire(start + 1min + 29s)->m_ID == 4);
+}
+
+TEST_CASE("tf2bd_connection_pool_stale_retry")
+{
+	const auto start = TestPool::clock_type::time_point{} + 1h;
+	TestPool pool(2, 30s);
+
+	REQUIRE(pool.Release(std::make_unique<TestConnection>(TestConnection{ 1 }), start));
+
+	// Closed by the server while it sat in the pool, so the request is sent again...
+	auto connection = pool.TryAcquire(start + 10s);
+	REQUIRE(connection);
+	REQUIRE(ShouldRetryOnNewConnection(true, 0, 0));
+
+	// ...on a new connection, since the broken one is never released
+	connection.reset();
+	REQUIRE(!pool.TryAcquire(start + 10s));
+
+	// A new connection failing too is a real failure, not another retry
+	REQUIRE(!ShouldRetryOnNewConnection(false, 0, 0));
+
+	// Neither is anything the server actually responded to
+	REQUIRE(!ShouldRetryOnNewConnection(true, 503, 0));
+	REQUIRE(!ShouldRetryOnNewConnection(true, 200, 0));
+	REQUIRE(!ShouldRetryOnNewConnection(true, 0, 100));
+
+	// The retry succeeded, so its connection is the one that gets reused next
+	REQUIRE(pool.Release(std::make_unique<TestConnection>(TestConnection{ 2 }), start + 11s));
+	REQUIRE(pool.TryAcquire(start + 12s)->m_ID == 2);
+}
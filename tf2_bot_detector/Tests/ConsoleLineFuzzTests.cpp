@@ -0,0 +1,390 @@
+#include "Config/ChatWrappers.h"
+#include "Config/Settings.h"
+#include "ConsoleLog/ConsoleLineListener.h"
+#include "ConsoleLog/ConsoleLines.h"
+#include "ConsoleLog/ConsoleLogParser.h"
+#include "ConsoleLog/NetworkStatus.h"
+#include "WorldState.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <random>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// Generous enough for unoptimized builds, but far below what catastrophic
+	// backtracking costs on a single long line
+	constexpr std::chrono::steady_clock::duration MAX_LINE_PARSE_TIME = 50ms;
+
+	struct GeneratedLine
+	{
+		std::string m_Text;
+		const std::type_info* m_ExpectedType = nullptr;
+	};
+
+	// Produces lines following the real console grammars. Adversarial names are
+	// built from the separators the grammars themselves look for.
+	class ConsoleGrammar final
+	{
+	public:
+		ConsoleGrammar(uint32_t seed, bool adversarialNames) :
+			m_Random(seed), m_AdversarialNames(adversarialNames)
+		{
+		}
+
+		uint32_t Next(uint32_t min, uint32_t max) { return std::uniform_int_distribution<uint32_t>(min, max)(m_Random); }
+
+		std::string NextName(size_t maxLength = 32, bool allowNewlines = false)
+		{
+			constexpr std::string_view SAFE_CHARS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_ "sv;
+			constexpr std::string_view ADVERSARIAL_TOKENS[] =
+			{
+				"\""sv, "["sv, "]"sv, " killed "sv, " with "sv, "."sv, " :  "sv, " (crit)"sv, "#1 - "sv,
+				"  "sv, "("sv, ")"sv, "[U:1:1]"sv, " 00:00 "sv, "x"sv, "\n"sv,
+			};
+
+			std::string retVal;
+			const size_t length = Next(1, uint32_t(maxLength));
+			while (retVal.size() < length)
+			{
+				if (m_AdversarialNames && Next(0, 1))
+				{
+					const auto token = ADVERSARIAL_TOKENS[Next(0, uint32_t(std::size(ADVERSARIAL_TOKENS) - 1))];
+					if (!allowNewlines && token == "\n"sv)
+						continue;
+
+					retVal += token;
+				}
+				else
+				{
+					retVal += SAFE_CHARS[Next(0, uint32_t(SAFE_CHARS.size() - 1))];
+				}
+			}
+
+			retVal.resize(length);
+			if (!allowNewlines)
+				std::replace(retVal.begin(), retVal.end(), '\n', ' ');
+
+			return retVal;
+		}
+
+		GeneratedLine NextLine()
+		{
+			constexpr std::string_view STATES[] = { "active"sv, "spawning"sv, "connecting"sv, "challenging"sv };
+			constexpr std::string_view SOCKETS[] = { "cl "sv, "sv "sv, "htv"sv, "mat"sv, "lnk"sv, "lan"sv };
+			constexpr std::string_view WEAPONS[] = { "scattergun"sv, "tf_projectile_rocket"sv, "sniperrifle"sv, "world"sv };
+
+			switch (Next(0, 13))
+			{
+			default:
+			case 0:
+			{
+				auto line = mh::format("#{:>7} \"{}\" [U:1:{}] ", Next(1, 9999), NextName(32, true), Next(1, 2000000000));
+				if (Next(0, 1))
+					line += mh::format("{}:", Next(1, 12));
+
+				line += mh::format("{:02}:{:02} {:>6} {:>4} {}", Next(0, 59), Next(0, 59), Next(0, 999), Next(0, 100),
+					STATES[Next(0, uint32_t(std::size(STATES) - 1))]);
+
+				if (Next(0, 1))
+					line += mh::format(" {}.{}.{}.{}:{}", Next(0, 255), Next(0, 255), Next(0, 255), Next(0, 255), Next(1, 65535));
+
+				return { std::move(line), &typeid(ServerStatusPlayerLine) };
+			}
+			case 1:
+				return { mh::format("  {}[{}] [U:1:{}]  team = {}  type = {}", Next(0, 1) ? "Member" : "Pending",
+					Next(0, 31), Next(1, 2000000000), Next(0, 1) ? "TF_GC_TEAM_DEFENDERS" : "TF_GC_TEAM_INVADERS",
+					Next(0, 1) ? "MATCH_PLAYER" : "INVALID_PLAYER"), &typeid(LobbyMemberLine) };
+			case 2:
+				return { mh::format("CTFLobbyShared: ID:{:016x}  {} member(s), {} pending",
+					Next(0, UINT32_MAX), Next(0, 24), Next(0, 24)), &typeid(LobbyHeaderLine) };
+			case 3:
+				return { mh::format("{} killed {} with {}.{}", NextName(), NextName(),
+					WEAPONS[Next(0, uint32_t(std::size(WEAPONS) - 1))], Next(0, 1) ? " (crit)" : ""),
+					&typeid(KillNotificationLine) };
+			case 4:
+				return { mh::format("players : {} humans, {} bots ({} max)", Next(0, 32), Next(0, 32), Next(1, 33)),
+					&typeid(ServerStatusPlayerCountLine) };
+			case 5:
+				return { mh::format("edicts  : {} used of {} max", Next(0, 2048), Next(0, 2048)), &typeid(EdictUsageLine) };
+			case 6:
+				return { mh::format("{:>4} ms : {}", Next(0, 999), NextName()), &typeid(PingLine) };
+			case 7:
+				return { mh::format("<-- [{}] Split packet {:>4}/{:>4} seq {:>5} size {:>4} mtu {:>4} from {}.{}.{}.{}:{}",
+					SOCKETS[Next(0, uint32_t(std::size(SOCKETS) - 1))], Next(1, 255), Next(1, 255), Next(0, 65535),
+					Next(0, 65535), Next(0, 65535), Next(0, 255), Next(0, 255), Next(0, 255), Next(0, 255), Next(1, 65535)),
+					&typeid(SplitPacketLine) };
+			case 8:
+				return { mh::format("- Config: {}, {}, {} connections", Next(0, 1) ? "Multiplayer" : "Singleplayer",
+					Next(0, 1) ? "dedicated" : "listen", Next(0, 64)), &typeid(NetStatusConfigLine) };
+			case 9:
+				return { mh::format("- latency: {}.{:03}, loss {}.{:02}", Next(0, 9), Next(0, 999), Next(0, 1), Next(0, 99)),
+					&typeid(NetChannelLatencyLossLine) };
+			case 10:
+				return { mh::format("- Packets: net total out  {}.{}/s, in {}.{}/s", Next(0, 999), Next(0, 9), Next(0, 999), Next(0, 9)),
+					&typeid(NetPacketsTotalLine) };
+			case 11:
+				return { mh::format("Dropped {} from server ({})", NextName(), Next(0, 1) ? "Disconnect by user." : "Kicked by Console"),
+					&typeid(ServerDroppedPlayerLine) };
+			case 12:
+				return { mh::format("Voice - chan {}, ent {}, bufsize: {}", Next(0, 255), Next(0, 255), Next(0, 65535)),
+					&typeid(VoiceReceiveLine) };
+			case 13:
+				return { mh::format("#{} - {}", Next(1, 33), NextName()), &typeid(ServerStatusShortPlayerLine) };
+			}
+		}
+
+		// A valid line with a long run of grammar tokens spliced into the middle
+		std::string NextAdversarialLine(size_t maxLength)
+		{
+			constexpr std::string_view TOKENS[] =
+			{
+				" : "sv, "  "sv, "\t"sv, " "sv, "a"sv, "1"sv, "-"sv, "."sv, "\""sv, "["sv, "]"sv, "("sv, ")"sv,
+				" killed "sv, " with "sv, ", "sv, ":"sv, "/Match1/Lobby1 "sv, " x, "sv, " from server ("sv,
+				" connections"sv, "\n"sv,
+			};
+
+			std::string line = NextLine().m_Text;
+			const size_t insertPos = Next(0, uint32_t(line.size()));
+
+			std::string soup;
+			const size_t length = Next(0, uint32_t(maxLength));
+			while (soup.size() < length)
+				soup += TOKENS[Next(0, uint32_t(std::size(TOKENS) - 1))];
+
+			line.insert(insertPos, soup);
+			return line;
+		}
+
+	private:
+		std::mt19937 m_Random;
+		bool m_AdversarialNames = false;
+	};
+
+	const IConsoleLine::ConsoleLineTypeData* FindRegisteredType(
+		const std::vector<IConsoleLine::ConsoleLineTypeData>& types, const std::type_info& type)
+	{
+		for (const auto& data : types)
+		{
+			if (*data.m_TypeInfo == type)
+				return &data;
+		}
+
+		return nullptr;
+	}
+
+	std::chrono::steady_clock::duration TimeTryParse(IConsoleLine::TryParseFunc func, const std::string_view& text)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		try
+		{
+			func(text, time_point_t{});
+		}
+		catch (const std::exception&)
+		{
+			// Rejecting malformed values by throwing is allowed, we only care about how long it took
+		}
+
+		return std::chrono::steady_clock::now() - start;
+	}
+
+	class RecordingListener final : public BaseConsoleLineListener
+	{
+	public:
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override
+		{
+			if (auto chat = dynamic_cast<const ChatConsoleLine*>(&line))
+				m_Events.push_back(mh::format("chat {} : {}", chat->GetPlayerName(), chat->GetMessage()));
+			else
+				m_Events.push_back(mh::format("parsed {}", int(line.GetType())));
+		}
+		void OnConsoleLineUnparsed(IWorldState& world, const std::string_view& text) override
+		{
+			m_Events.push_back(mh::format("unparsed {}", text));
+		}
+
+		std::vector<std::string> m_Events;
+	};
+
+	std::vector<std::string> ParseInChunks(const Settings& settings, const std::string_view& log,
+		std::mt19937& random, size_t minChunkSize, size_t maxChunkSize)
+	{
+		auto world = IWorldState::Create(settings);
+		RecordingListener listener;
+		world->AddConsoleLineListener(&listener);
+
+		ConsoleLogParser parser(*world, settings, {});
+		for (size_t pos = 0; pos < log.size(); )
+		{
+			const size_t chunkSize = std::uniform_int_distribution<size_t>(minChunkSize, maxChunkSize)(random);
+			parser.ParseText(log.substr(pos, chunkSize));
+			pos += chunkSize;
+		}
+
+		world->RemoveConsoleLineListener(&listener);
+		return std::move(listener.m_Events);
+	}
+}
+
+TEST_CASE("tf2bd_cl_fuzz_grammar")
+{
+	const auto types = IConsoleLine::GetRegisteredTypes();
+
+	for (bool adversarial : { false, true })
+	{
+		ConsoleGrammar grammar(42, adversarial);
+		for (size_t i = 0; i < 4000; i++)
+		{
+			const auto line = grammar.NextLine();
+			INFO("line = " << line.m_Text);
+			INFO("expected type = " << line.m_ExpectedType->name());
+
+			const auto* expected = FindRegisteredType(types, *line.m_ExpectedType);
+			REQUIRE(expected);
+			REQUIRE(expected->m_TryParseFunc(line.m_Text, time_point_t{}));
+
+			// Other types are allowed to claim it first (a ping line for a player
+			// named "a killed b with c." is also a kill line), but someone has to
+			REQUIRE(IConsoleLine::ParseConsoleLine(line.m_Text, time_point_t{}));
+		}
+	}
+}
+
+TEST_CASE("tf2bd_cl_fuzz_worst_case")
+{
+	std::vector<std::string> lines;
+	{
+		ConsoleGrammar grammar(1337, true);
+		for (size_t i = 0; i < 1000; i++)
+			lines.push_back(grammar.NextLine().m_Text);
+		for (size_t i = 0; i < 500; i++)
+			lines.push_back(grammar.NextAdversarialLine(1024));
+
+		// Longest names the game allows, full of the characters the status grammar backtracks on
+		lines.push_back(mh::format("#      2 \"{}\" [U:1:1] 00:00 0 0 active", std::string(32, '"')));
+		lines.push_back(mh::format("#      2 \"{}\" [U:1:1] 00:00 0 0 active", std::string(1024, '"')));
+		lines.push_back(mh::format("#      2 \"{}", std::string(1024, ']')));
+		lines.push_back(std::string(1024, ' ') + "killed");
+	}
+
+	for (const auto& type : IConsoleLine::GetRegisteredTypes())
+	{
+		if (!type.m_AutoParse)
+			continue;
+
+		std::chrono::steady_clock::duration worstTime{};
+		const std::string* worstLine = nullptr;
+		for (const auto& line : lines)
+		{
+			auto time = TimeTryParse(type.m_TryParseFunc, line);
+			if (time > MAX_LINE_PARSE_TIME)
+			{
+				// Make sure it wasn't just the scheduler
+				time = std::min(time, TimeTryParse(type.m_TryParseFunc, line));
+				time = std::min(time, TimeTryParse(type.m_TryParseFunc, line));
+			}
+
+			if (time > worstTime)
+			{
+				worstTime = time;
+				worstLine = &line;
+			}
+		}
+
+		INFO("type = " << type.m_TypeInfo->name());
+		INFO("worst line = " << (worstLine ? *worstLine : std::string{}));
+		INFO("worst time = " << std::chrono::duration<double, std::milli>(worstTime).count() << "ms");
+		REQUIRE(worstTime <= MAX_LINE_PARSE_TIME);
+	}
+}
+
+TEST_CASE("tf2bd_cl_fuzz_parse_chunk")
+{
+	Settings settings;
+	settings.m_Unsaved.SetChatMsgWrappers(ChatWrappers(ChatFmtStrLengths{}));
+	const auto& wrappers = settings.m_Unsaved.GetChatMsgWrappers().value();
+
+	std::string log = "\n";
+	{
+		ConsoleGrammar grammar(7, false);
+		for (uint32_t i = 0; i < 600; i++)
+		{
+			log += mh::format("10/19/2020 - {:02}:{:02}:{:02}: ", (i / 3600) % 24, (i / 60) % 60, i % 60);
+
+			if (grammar.Next(0, 5) == 0)
+			{
+				const auto& type = wrappers.m_Types[grammar.Next(0, uint32_t(ChatCategory::COUNT) - 1)];
+				std::string message = grammar.NextName(100);
+				if (grammar.Next(0, 3) == 0)
+					message.insert(grammar.Next(0, uint32_t(message.size())), "\n");
+
+				log += type.m_Full.m_Start.m_Narrow;
+				log += type.m_Name.m_Start.m_Narrow + grammar.NextName() + type.m_Name.m_End.m_Narrow;
+				log += " :  ";
+				log += type.m_Message.m_Start.m_Narrow + message + type.m_Message.m_End.m_Narrow;
+				log += type.m_Full.m_End.m_Narrow;
+			}
+			else
+			{
+				log += grammar.NextLine().m_Text;
+			}
+
+			log += '\n';
+		}
+
+		// Lines are only parsed once the next timestamp shows up
+		log += "10/19/2020 - 23:59:59: ";
+	}
+
+	std::mt19937 random(99);
+	const auto expected = ParseInChunks(settings, log, random, log.size(), log.size());
+	REQUIRE(expected.size() == 600);
+
+	for (size_t maxChunkSize : { 1, 7, 64, 4096 })
+	{
+		INFO("max chunk size = " << maxChunkSize);
+		const auto actual = ParseInChunks(settings, log, random, 1, maxChunkSize);
+		REQUIRE(actual.size() == expected.size());
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			INFO("event " << i);
+			REQUIRE(actual[i] == expected[i]);
+		}
+	}
+
+	BENCHMARK("ConsoleLogParser::ParseText (4 KiB chunks)")
+	{
+		return ParseInChunks(settings, log, random, 4096, 4096).size();
+	};
+
+	std::vector<std::string> lines;
+	{
+		ConsoleGrammar grammar(8, false);
+		for (size_t i = 0; i < 1000; i++)
+			lines.push_back(grammar.NextLine().m_Text);
+	}
+
+	BENCHMARK("IConsoleLine::ParseConsoleLine (1000 lines)")
+	{
+		size_t parsedCount = 0;
+		for (const auto& line : lines)
+		{
+			if (IConsoleLine::ParseConsoleLine(line, time_point_t{}))
+				parsedCount++;
+		}
+
+		return parsedCount;
+	};
+}
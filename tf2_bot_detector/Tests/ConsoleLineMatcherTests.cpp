@@ -0,0 +1,302 @@
+#include "ConsoleLog/ConsoleLineMatchers.h"
+#include "ConsoleLog/NetworkStatus.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+using namespace tf2_bot_detector::line_matchers;
+
+namespace
+{
+	// The patterns the matchers replaced, kept as the reference implementation
+	const std::regex s_ServerStatusPlayerRegex(R"regex(#\s+(\d+)\s+"((?:.|[\r\n])+)"\s+(\[.*\])\s+(?:(\d+):)?(\d+):(\d+)\s+(\d+)\s+(\d+)\s+(\w+)(?:\s+(\S+))?)regex", std::regex::optimize);
+	const std::regex s_LobbyMemberRegex(R"regex(\s+(?:(?:Member)|(Pending))\[(\d+)\] (\[.*\])\s+team = (\w+)\s+type = (\w+))regex", std::regex::optimize);
+	const std::regex s_KillNotificationRegex(R"regex((.*) killed (.*) with (.*)\.( \(crit\))?)regex", std::regex::optimize);
+	const std::regex s_SplitPacketRegex(R"regex(<-- \[(.{3})\] Split packet +(\d+)\/ +(\d+) seq +(\d+) size +(\d+) mtu +(\d+) from ([0-9.:a-fA-F]+:\d+))regex", std::regex::optimize);
+	const std::regex s_NetStatusConfigRegex(R"regex(- Config: (.*), (.*), (\d+) connections)regex", std::regex::optimize);
+
+	template<size_t N>
+	using Captures = std::optional<std::array<std::string_view, N>>;
+
+	template<size_t N>
+	Captures<N> RegexCaptures(const std::regex& regex, std::string_view text)
+	{
+		std::match_results<std::string_view::const_iterator> result;
+		if (!std::regex_match(text.begin(), text.end(), result, regex))
+			return std::nullopt;
+
+		std::array<std::string_view, N> retVal{};
+		for (size_t i = 0; i < N; i++)
+		{
+			if (result[i + 1].matched)
+				retVal[i] = std::string_view(&*result[i + 1].first, result[i + 1].length());
+		}
+
+		return retVal;
+	}
+
+	Captures<10> MatcherCaptures(const std::optional<ServerStatusPlayerCaptures>& c)
+	{
+		if (!c)
+			return std::nullopt;
+
+		return std::array{ c->m_UserID, c->m_Name, c->m_SteamID, c->m_ConnectedHours, c->m_ConnectedMins,
+			c->m_ConnectedSecs, c->m_Ping, c->m_Loss, c->m_State, c->m_Address };
+	}
+	Captures<5> MatcherCaptures(const std::optional<LobbyMemberCaptures>& c)
+	{
+		if (!c)
+			return std::nullopt;
+
+		return std::array{ c->m_Pending, c->m_Index, c->m_SteamID, c->m_Team, c->m_Type };
+	}
+	Captures<4> MatcherCaptures(const std::optional<KillNotificationCaptures>& c)
+	{
+		if (!c)
+			return std::nullopt;
+
+		return std::array{ c->m_AttackerName, c->m_VictimName, c->m_WeaponName, c->m_Crit };
+	}
+	Captures<7> MatcherCaptures(const std::optional<SplitPacketCaptures>& c)
+	{
+		if (!c)
+			return std::nullopt;
+
+		return std::array{ c->m_SocketType, c->m_Index, c->m_Count, c->m_Sequence, c->m_Size, c->m_MTU, c->m_Address };
+	}
+	Captures<3> MatcherCaptures(const std::optional<NetStatusConfigCaptures>& c)
+	{
+		if (!c)
+			return std::nullopt;
+
+		return std::array{ c->m_PlayerMode, c->m_ServerMode, c->m_ConnectionCount };
+	}
+	Captures<2> MatcherCaptures(const DualDecimalPattern& pattern, std::string_view text)
+	{
+		if (std::array<std::string_view, 2> retVal; pattern.Match(text, retVal[0], retVal[1]))
+			return retVal;
+
+		return std::nullopt;
+	}
+
+	template<size_t N>
+	void RequireSameCaptures(std::string_view text, const Captures<N>& expected, const Captures<N>& actual)
+	{
+		INFO("text = " << std::string(text));
+		REQUIRE(expected.has_value() == actual.has_value());
+		if (!expected)
+			return;
+
+		for (size_t i = 0; i < N; i++)
+		{
+			INFO("capture " << (i + 1));
+			REQUIRE((*expected)[i] == (*actual)[i]);
+		}
+	}
+
+	// Random single character edits, biased towards the characters the grammars care about
+	std::vector<std::string> MutateLines(const std::vector<std::string_view>& seeds, size_t mutationsPerSeed)
+	{
+		constexpr std::string_view ALPHABET = "  \t\n\"[]:/.,#-()0123456789aFUx_"sv;
+
+		std::mt19937 random(1234);
+		std::vector<std::string> retVal;
+		for (auto seed : seeds)
+		{
+			retVal.emplace_back(seed);
+			for (size_t i = 0; i < mutationsPerSeed; i++)
+			{
+				std::string line(seed);
+				const size_t editCount = 1 + random() % 3;
+				for (size_t e = 0; e < editCount && !line.empty(); e++)
+				{
+					const size_t pos = random() % line.size();
+					const char c = ALPHABET[random() % ALPHABET.size()];
+					switch (random() % 3)
+					{
+					case 0: line[pos] = c; break;
+					case 1: line.insert(line.begin() + pos, c); break;
+					case 2: line.erase(pos, 1); break;
+					}
+				}
+
+				retVal.push_back(std::move(line));
+			}
+		}
+
+		return retVal;
+	}
+
+	constexpr size_t MUTATIONS_PER_SEED = 2000;
+}
+
+TEST_CASE("tf2bd_cl_matcher_status")
+{
+	const std::vector<std::string_view> seeds =
+	{
+		R"(#    348 "2fort closed due to COVID" [U:1:1118537734] 00:51  157    0 active)",
+		"#    348 \"2fort\x0A closed\x0D\" [U:1:1118537734] 00:51  157    0 active",
+		R"(#      2 "a "quoted" name"   [U:1:1001]          1:05:00       50    0 spawning 169.254.0.1:27005)",
+		R"(#      3 "Bravo"             [U:1:1002] [x]      05:00       50    0 challenging)",
+		R"(#   1337 ""]""               [A:1:2:3]           123:45:06   999  100 connecting loopback)",
+	};
+
+	for (const auto& line : MutateLines(seeds, MUTATIONS_PER_SEED))
+	{
+		RequireSameCaptures<10>(line, RegexCaptures<10>(s_ServerStatusPlayerRegex, line),
+			MatcherCaptures(MatchServerStatusPlayerLine(line)));
+	}
+}
+
+TEST_CASE("tf2bd_cl_matcher_lobby_member")
+{
+	const std::vector<std::string_view> seeds =
+	{
+		"  Member[0] [U:1:1000]  team = TF_GC_TEAM_INVADERS  type = MATCH_PLAYER",
+		"  Pending[12] [U:1:1000]  team = TF_GC_TEAM_DEFENDERS  type = INVALID_PLAYER",
+		"\tMember[3] [U:1:1] ] [x]  team = A  type = B",
+	};
+
+	for (const auto& line : MutateLines(seeds, MUTATIONS_PER_SEED))
+	{
+		RequireSameCaptures<5>(line, RegexCaptures<5>(s_LobbyMemberRegex, line),
+			MatcherCaptures(MatchLobbyMemberLine(line)));
+	}
+}
+
+TEST_CASE("tf2bd_cl_matcher_kill_notification")
+{
+	const std::vector<std::string_view> seeds =
+	{
+		"Alpha killed Bravo with scattergun.",
+		"Alpha killed Bravo with tf_projectile_rocket. (crit)",
+		"a killed b with c killed d with e. (crit).",
+		" killed  with .",
+	};
+
+	for (const auto& line : MutateLines(seeds, MUTATIONS_PER_SEED))
+	{
+		RequireSameCaptures<4>(line, RegexCaptures<4>(s_KillNotificationRegex, line),
+			MatcherCaptures(MatchKillNotificationLine(line)));
+	}
+}
+
+TEST_CASE("tf2bd_cl_matcher_net_status")
+{
+	const std::vector<std::string_view> splitPacketSeeds =
+	{
+		"<-- [cl ] Split packet    1/   2 seq  5 size 1260 mtu 1260 from 169.254.0.1:27015",
+		"<-- [mat] Split packet   12/  12 seq 65535 size   80 mtu 1200 from fe80::1:a:27015",
+	};
+
+	for (const auto& line : MutateLines(splitPacketSeeds, MUTATIONS_PER_SEED))
+	{
+		RequireSameCaptures<7>(line, RegexCaptures<7>(s_SplitPacketRegex, line),
+			MatcherCaptures(MatchSplitPacketLine(line)));
+	}
+
+	const std::vector<std::string_view> configSeeds =
+	{
+		"- Config: Multiplayer, dedicated, 1 connections",
+		"- Config: Singleplayer, , 12 connections",
+		"- Config: a, b, c, 3, 4 connections",
+	};
+
+	for (const auto& line : MutateLines(configSeeds, MUTATIONS_PER_SEED))
+	{
+		RequireSameCaptures<3>(line, RegexCaptures<3>(s_NetStatusConfigRegex, line),
+			MatcherCaptures(MatchNetStatusConfigLine(line)));
+	}
+
+	struct DualDecimalTest
+	{
+		std::string_view m_Regex;
+		const DualDecimalPattern& m_Pattern;
+		std::string_view m_Seed;
+	};
+
+	const DualDecimalTest dualDecimalTests[] =
+	{
+		{ R"regex(- latency: (\d+\.\d+), loss (\d+\.\d+))regex", NetChannelLatencyLossLine::MATCH_PATTERN, "- latency: 0.123, loss 0.00" },
+		{ R"regex(- packets: in (\d+\.\d+)\/s, out (\d+\.\d+)\/s)regex", NetChannelPacketsLine::MATCH_PATTERN, "- packets: in 66.7/s, out 66.0/s" },
+		{ R"regex(- choke: in (\d+\.\d+), out (\d+\.\d+))regex", NetChannelChokeLine::MATCH_PATTERN, "- choke: in 0.00, out 0.00" },
+		{ R"regex(- flow: in (\d+\.\d+), out (\d+\.\d+) kB\/s)regex", NetChannelFlowLine::MATCH_PATTERN, "- flow: in 12.5, out 3.1 kB/s" },
+		{ R"regex(- total: in (\d+\.\d+), out (\d+\.\d+) MB)regex", NetChannelTotalLine::MATCH_PATTERN, "- total: in 4.2, out 0.9 MB" },
+		{ R"regex(- Latency: avg out (\d+\.\d+)s, in (\d+\.\d+)s)regex", NetLatencyLine::MATCH_PATTERN, "- Latency: avg out 0.05s, in 0.06s" },
+		{ R"regex(- Loss:    avg out (\d+\.\d+), in (\d+\.\d+))regex", NetLossLine::MATCH_PATTERN, "- Loss:    avg out 0.0, in 0.0" },
+		{ R"regex(- Packets: net total out  (\d+\.\d)\/s, in (\d+\.\d)\/s)regex", NetPacketsTotalLine::MATCH_PATTERN, "- Packets: net total out  66.0/s, in 66.7/s" },
+		{ R"regex(           per client out (\d+\.\d)\/s, in (\d+\.\d)\/s)regex", NetPacketsPerClientLine::MATCH_PATTERN, "           per client out 66.0/s, in 66.7/s" },
+		{ R"regex(- Data:    net total out  (\d+\.\d), in (\d+\.\d) kB\/s)regex", NetDataTotalLine::MATCH_PATTERN, "- Data:    net total out  3.1, in 12.5 kB/s" },
+		{ R"regex(           per client out (\d+\.\d), in (\d+\.\d) kB\/s)regex", NetDataPerClientLine::MATCH_PATTERN, "           per client out 3.1, in 12.5 kB/s" },
+	};
+
+	for (const auto& test : dualDecimalTests)
+	{
+		const std::regex regex(test.m_Regex.begin(), test.m_Regex.end());
+		for (const auto& line : MutateLines({ test.m_Seed }, MUTATIONS_PER_SEED / 4))
+			RequireSameCaptures<2>(line, RegexCaptures<2>(regex, line), MatcherCaptures(test.m_Pattern, line));
+	}
+}
+
+TEST_CASE("tf2bd_cl_matcher_benchmark")
+{
+	constexpr std::string_view STATUS_LINE = R"(#    348 "2fort closed due to COVID" [U:1:1118537734] 1:00:51  157    0 active)";
+	constexpr std::string_view LOBBY_LINE = "  Member[0] [U:1:1000]  team = TF_GC_TEAM_INVADERS  type = MATCH_PLAYER";
+	constexpr std::string_view KILL_LINE = "Alpha killed Bravo with tf_projectile_rocket. (crit)";
+	constexpr std::string_view SPLIT_PACKET_LINE = "<-- [cl ] Split packet    1/   2 seq  5 size 1260 mtu 1260 from 169.254.0.1:27015";
+
+	REQUIRE(RegexCaptures<10>(s_ServerStatusPlayerRegex, STATUS_LINE));
+	REQUIRE(RegexCaptures<5>(s_LobbyMemberRegex, LOBBY_LINE));
+	REQUIRE(RegexCaptures<4>(s_KillNotificationRegex, KILL_LINE));
+	REQUIRE(RegexCaptures<7>(s_SplitPacketRegex, SPLIT_PACKET_LINE));
+
+	BENCHMARK("ServerStatusPlayerLine (std::regex)")
+	{
+		return RegexCaptures<10>(s_ServerStatusPlayerRegex, STATUS_LINE);
+	};
+	BENCHMARK("ServerStatusPlayerLine (matcher)")
+	{
+		return MatchServerStatusPlayerLine(STATUS_LINE);
+	};
+
+	BENCHMARK("LobbyMemberLine (std::regex)")
+	{
+		return RegexCaptures<5>(s_LobbyMemberRegex, LOBBY_LINE);
+	};
+	BENCHMARK("LobbyMemberLine (matcher)")
+	{
+		return MatchLobbyMemberLine(LOBBY_LINE);
+	};
+
+	BENCHMARK("KillNotificationLine (std::regex)")
+	{
+		return RegexCaptures<4>(s_KillNotificationRegex, KILL_LINE);
+	};
+	BENCHMARK("KillNotificationLine (matcher)")
+	{
+		return MatchKillNotificationLine(KILL_LINE);
+	};
+
+	BENCHMARK("SplitPacketLine (std::regex)")
+	{
+		return RegexCaptures<7>(s_SplitPacketRegex, SPLIT_PACKET_LINE);
+	};
+	BENCHMARK("SplitPacketLine (matcher)")
+	{
+		return MatchSplitPacketLine(SPLIT_PACKET_LINE);
+	};
+
+	BENCHMARK("NetChannelLatencyLossLine (matcher)")
+	{
+		return MatcherCaptures(NetChannelLatencyLossLine::MATCH_PATTERN, "- latency: 0.123, loss 0.00");
+	};
+}
@@ -0,0 +1,81 @@
+#include "KillStats.h"
+
+#include <catch2/catch.hpp>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_killstats_windows")
+{
+	REQUIRE(IsHeadshotWeapon("sniperrifle"));
+	REQUIRE(IsHeadshotWeapon("ambassador"));
+	REQUIRE(!IsHeadshotWeapon("scattergun"));
+
+	const time_point_t start = time_point_t{} + 24h;
+	PlayerKillStats stats;
+
+	// A kill every 5 seconds for a minute, every other one a sniper rifle headshot
+	for (int i = 0; i < 12; i++)
+	{
+		const bool sniper = (i % 2) == 0;
+		stats.AddKill(start + i * 5s, sniper ? "sniperrifle" : "scattergun", sniper);
+	}
+
+	auto summary = stats.GetSummary(start + 55s);
+	REQUIRE(summary.m_TotalKills == 12);
+	REQUIRE(summary.m_WindowKills == 12);
+	REQUIRE(summary.m_KillsPerMinute == 12);
+	REQUIRE(summary.m_CritRatio == 0.5f);
+	REQUIRE(summary.m_HeadshotWeaponKills == 6);
+	REQUIRE(summary.m_HeadshotRatio == 1.0f);
+	REQUIRE(summary.m_CurrentBurst == 3);
+	REQUIRE(summary.m_MaxBurst == 3);
+
+	// Nothing new, the rate and burst windows empty out before the ratio window does
+	summary = stats.GetSummary(start + 3min);
+	REQUIRE(summary.m_KillsPerMinute == 0);
+	REQUIRE(summary.m_CurrentBurst == 0);
+	REQUIRE(summary.m_WindowKills == 12);
+	REQUIRE(summary.m_CritRatio == 0.5f);
+
+	summary = stats.GetSummary(start + 10min);
+	REQUIRE(summary.m_WindowKills == 0);
+	REQUIRE(summary.m_HeadshotWeaponKills == 0);
+	REQUIRE(summary.m_CritRatio == 0);
+	REQUIRE(summary.m_TotalKills == 12);
+
+	// Burst of 6 kills in 3 seconds, only scattergun crits
+	for (int i = 0; i < 6; i++)
+		stats.AddKill(start + 10min + i * 500ms, "scattergun", true);
+
+	summary = stats.GetSummary(start + 10min + 3s);
+	REQUIRE(summary.m_WindowKills == 6);
+	REQUIRE(summary.m_CritRatio == 1.0f);
+	REQUIRE(summary.m_HeadshotWeaponKills == 0);
+	REQUIRE(summary.m_CurrentBurst == 6);
+	REQUIRE(summary.m_MaxBurst == 6);
+}
+
+TEST_CASE("tf2bd_killstats_bounded")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	PlayerKillStats stats;
+
+	// Far more kills than fit in the window, out of order timestamps included
+	for (int i = 0; i < 10000; i++)
+		stats.AddKill(start + i * 100ms - ((i % 7) == 0 ? 1s : 0s), (i % 3) ? "sniperrifle" : "minigun", (i % 4) == 0);
+
+	const auto summary = stats.GetSummary(start + 10000 * 100ms);
+	REQUIRE(summary.m_TotalKills == 10000);
+	REQUIRE(summary.m_WindowKills == PlayerKillStats::MAX_EVENTS);
+	REQUIRE(summary.m_MaxBurst == PlayerKillStats::MAX_EVENTS);
+	REQUIRE(summary.m_HeadshotWeaponKills <= summary.m_WindowKills);
+	REQUIRE(summary.m_CritRatio > 0.2f);
+	REQUIRE(summary.m_CritRatio < 0.3f);
+
+	BENCHMARK("PlayerKillStats::AddKill")
+	{
+		stats.AddKill(start + 24h, "sniperrifle", true);
+		return stats.GetTotalKills();
+	};
+}
@@ -0,0 +1,109 @@
+#include "Actions/ActionGenerators.h"
+#include "Actions/Actions.h"
+#include "Actions/RCONActionManager.h"
+#include "Config/PlayerListJSON.h"
+#include "Config/Settings.h"
+#include "IPlayer.h"
+#include "ModeratorLogic.h"
+#include "WorldState.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	class NullActionManager final : public IRCONActionManager
+	{
+	public:
+		void Update() override {}
+		bool QueueAction(std::unique_ptr<IAction>&& action) override { return false; }
+		void AddPeriodicActionGenerator(std::unique_ptr<IPeriodicActionGenerator>&& action) override {}
+	};
+
+	// Settings, rules and playerlists all live in ./cfg, so run against an empty one
+	class ScopedConfigDirectory final
+	{
+	public:
+		ScopedConfigDirectory(const std::string_view& name) :
+			m_PreviousDir(std::filesystem::current_path()),
+			m_Dir(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(m_Dir);
+			std::filesystem::create_directories(m_Dir / "cfg");
+			std::filesystem::current_path(m_Dir);
+		}
+		~ScopedConfigDirectory()
+		{
+			std::filesystem::current_path(m_PreviousDir);
+			std::error_code ec;
+			std::filesystem::remove_all(m_Dir, ec);
+		}
+
+	private:
+		std::filesystem::path m_PreviousDir;
+		std::filesystem::path m_Dir;
+	};
+}
+
+TEST_CASE("tf2bd_modlogic_rules_reach_connected_players")
+{
+	ScopedConfigDirectory cfgDir("tf2bd_modlogic_tests");
+
+	Settings settings;
+	REQUIRE(settings.m_AutoMark);
+
+	auto world = IWorldState::Create(settings);
+	NullActionManager actionManager;
+	auto modLogic = IModeratorLogic::Create(*world, settings, actionManager);
+
+	const SteamID cheaterID(1001, SteamAccountType::Individual, SteamAccountUniverse::Public);
+	const auto StatusDump = [&](int ping)
+	{
+		world->AddConsoleOutputLine("players : 2 humans, 0 bots (24 max)");
+		world->AddConsoleOutputLine(mh::format(R"(#      2 "Innocent"          [U:1:1000]          05:00       {}    0 active)", ping));
+		world->AddConsoleOutputLine(mh::format(R"(#      3 "xX_BadGuy_Xx"      [U:1:1001]          05:00       {}    0 active)", ping));
+	};
+
+	StatusDump(50);
+	StatusDump(55);
+	REQUIRE(!modLogic->GetPlayerAttributes(cheaterID));
+
+	// A rule that only shows up after they've joined...
+	{
+		std::ofstream file("cfg/rules.json");
+		file << R"({
+	"$schema": "https://raw.githubusercontent.com/PazerOP/tf2_bot_detector/master/schemas/v3/rules.schema.json",
+	"rules": [
+		{
+			"description": "test rule",
+			"actions": { "mark": [ "cheater" ] },
+			"triggers": {
+				"username_text_match": { "case_sensitive": false, "mode": "contains", "patterns": [ "badguy" ] }
+			}
+		}
+	]
+})";
+	}
+	modLogic->ReloadConfigFiles();
+	REQUIRE(modLogic->GetRuleCount() == 1);
+
+	// ...still applies once the rules have been reloaded, even though the players haven't changed
+	StatusDump(60);
+	REQUIRE(!modLogic->GetPlayerAttributes(cheaterID));
+	modLogic->Update();
+	REQUIRE(modLogic->GetPlayerAttributes(cheaterID).Has(PlayerAttribute::Cheater));
+	REQUIRE(!modLogic->GetPlayerAttributes(SteamID(1000, SteamAccountType::Individual, SteamAccountUniverse::Public)));
+
+	// Only once per reload, not on every dump
+	IPlayer* cheater = world->FindPlayer(cheaterID);
+	REQUIRE(cheater);
+	REQUIRE(modLogic->SetPlayerAttribute(*cheater, PlayerAttribute::Cheater, false));
+	StatusDump(65);
+	modLogic->Update();
+	REQUIRE(!modLogic->GetPlayerAttributes(cheaterID));
+}
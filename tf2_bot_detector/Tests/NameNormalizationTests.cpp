@@ -0,0 +1,97 @@
+#include "Util/NameNormalization.h"
+#include "Util/TextUtils.h"
+#include "PlayerNameIndex.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_name_normalization")
+{
+	REQUIRE(NormalizePlayerName("") == "");
+	REQUIRE(NormalizePlayerName("Pazer") == "pazer");
+	REQUIRE(NormalizePlayerName(ToMB(u8"  Pa\u200Bzer\u2060  ")) == "pazer");               // Zero width space, word joiner
+	REQUIRE(NormalizePlayerName(ToMB(u8"Pa \u00A0 \u3000zer")) == "pa zer");                // Unicode whitespace
+	REQUIRE(NormalizePlayerName(ToMB(u8"\u0420\u0430z\u0435r")) == "pazer");                // Cyrillic
+	REQUIRE(NormalizePlayerName(ToMB(u8"\u039F\u03BFps")) == "oops");                       // Greek
+	REQUIRE(NormalizePlayerName(ToMB(u8"\uFF30\uFF41\uFF5A\uFF45\uFF52")) == "pazer");      // Full-width
+	REQUIRE(NormalizePlayerName(ToMB(u8"\U0001D40F\U0001D41A\U0001D433er")) == "pazer");    // Mathematical bold
+	REQUIRE(NormalizePlayerName(ToMB(u8"Pa\u0301zer")) == "pazer");                         // Combining acute accent
+	REQUIRE(NormalizePlayerName("Ivl1|") == "lvlll");
+	REQUIRE(NormalizePlayerName("B0B") == "bob");
+	REQUIRE(NormalizePlayerName(ToMB(u8"\u3164\u200B")) == "");
+
+	// Things that aren't lookalikes are left alone
+	REQUIRE(NormalizePlayerName(ToMB(u8"\u65E5\u672C\u8A9E Name")) == ToMB(u8"\u65E5\u672C\u8A9E name"));
+	REQUIRE(NormalizePlayerName("\xFF\xC3(bad \x85utf8") == "\xFF\xC3(bad \x85utf8");
+}
+
+TEST_CASE("tf2bd_player_name_index")
+{
+	const SteamID legit(76561198003911389);
+	const SteamID bot1(1001, SteamAccountType::Individual, SteamAccountUniverse::Public);
+	const SteamID bot2(1002, SteamAccountType::Individual, SteamAccountUniverse::Public);
+
+	PlayerNameIndex index;
+	REQUIRE(index.Update(legit, "Pazer"));
+	REQUIRE(!index.Update(legit, "Pazer"));
+	REQUIRE(!index.HasCollisions(legit));
+
+	REQUIRE(index.Update(bot1, ToMB(u8"Pazer\u200B")));
+	REQUIRE(index.HasCollisions(legit));
+	REQUIRE(index.HasCollisions(bot1));
+	REQUIRE(index.GetCollisions(legit).size() == 2);
+
+	REQUIRE(index.Update(bot2, ToMB(u8"\u0420azer")));
+	REQUIRE(index.GetCollisions(bot2).size() == 3);
+
+	// Renamed, but to something that still normalizes the same
+	REQUIRE(!index.Update(bot2, "PAZER"));
+	REQUIRE(index.GetCollisions(bot2).size() == 3);
+
+	REQUIRE(index.Update(bot2, "Not Pazer"));
+	REQUIRE(index.GetCollisions(legit).size() == 2);
+	REQUIRE(!index.HasCollisions(bot2));
+
+	index.Remove(bot1);
+	REQUIRE(!index.HasCollisions(legit));
+	REQUIRE(index.GetCollisions(bot1).empty());
+	REQUIRE(index.size() == 2);
+
+	// Invisible-only names don't collide
+	index.Update(bot1, ToMB(u8"\u200B"));
+	index.Update(bot2, ToMB(u8"\u3164"));
+	REQUIRE(!index.HasCollisions(bot1));
+
+	// A full server, with several bots joining at once as copies of the same player
+	std::vector<SteamID> ids;
+	std::vector<std::string> names;
+	for (uint32_t i = 0; i < 32; i++)
+	{
+		ids.push_back(SteamID(2000 + i, SteamAccountType::Individual, SteamAccountUniverse::Public));
+		names.push_back(i < 8 ? ("Pazer" + std::string(i, '\x7F')) : mh::format("Player {}", i));
+	}
+
+	BENCHMARK("PlayerNameIndex::Update (32 new players, 8 impersonators)")
+	{
+		index.clear();
+		for (size_t i = 0; i < ids.size(); i++)
+			index.Update(ids[i], names[i]);
+
+		return index.GetCollisions(ids[0]).size();
+	};
+	BENCHMARK("PlayerNameIndex::Update (32 players, unchanged names)")
+	{
+		for (size_t i = 0; i < ids.size(); i++)
+			index.Update(ids[i], names[i]);
+
+		return index.GetCollisions(ids[0]).size();
+	};
+
+	REQUIRE(index.GetCollisions(ids[0]).size() == 8);
+	REQUIRE(!index.HasCollisions(ids[8]));
+}
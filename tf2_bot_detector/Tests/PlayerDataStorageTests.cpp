@@ -0,0 +1,48 @@
+#include "PlayerDataStorage.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <string>
+#include <utility>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	template<size_t N> struct SmallData { int m_Value = int(N); };
+	struct LargeData { std::array<std::string, 8> m_Strings; };
+
+	template<size_t... N>
+	void SetAll(PlayerDataStorage& storage, std::index_sequence<N...>)
+	{
+		(storage.Set(SmallData<N>{ int(N * 10) }), ...);
+	}
+	template<size_t... N>
+	bool CheckAll(const PlayerDataStorage& storage, std::index_sequence<N...>)
+	{
+		return ((storage.Find<SmallData<N>>() && storage.Find<SmallData<N>>()->m_Value == int(N * 10)) && ...);
+	}
+}
+
+TEST_CASE("tf2bd_player_data_storage")
+{
+	PlayerDataStorage storage;
+	REQUIRE(!storage.Find<LargeData>());
+
+	storage.GetOrCreate<LargeData>().m_Strings[7] = "test";
+	REQUIRE(storage.Find<LargeData>()->m_Strings[7] == "test");
+
+	// More types than there are fixed slots
+	constexpr auto TYPES = std::make_index_sequence<PlayerDataStorage::FIXED_SLOT_COUNT + 4>();
+	SetAll(storage, TYPES);
+	REQUIRE(CheckAll(storage, TYPES));
+
+	PlayerDataStorage other;
+	REQUIRE(!other.Find<SmallData<PlayerDataStorage::FIXED_SLOT_COUNT + 3>>());
+	REQUIRE(other.GetOrCreate<SmallData<PlayerDataStorage::FIXED_SLOT_COUNT + 3>>().m_Value == int(PlayerDataStorage::FIXED_SLOT_COUNT + 3));
+
+	storage.clear();
+	REQUIRE(!storage.Find<LargeData>());
+	REQUIRE(!storage.Find<SmallData<PlayerDataStorage::FIXED_SLOT_COUNT + 3>>());
+}
@@ -0,0 +1,228 @@
+#include "PlayerRequestScheduler.h"
+
+#include <catch2/catch.hpp>
+
+#include <future>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_request_budget")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	RequestBudget budget(4, 1s);
+	REQUIRE(budget.GetAvailable(start) == 4);
+
+	for (int i = 0; i < 4; i++)
+		REQUIRE(budget.TrySpend(start));
+
+	REQUIRE(!budget.TrySpend(start));
+	REQUIRE(budget.GetAvailable(start) == 0);
+	REQUIRE(budget.GetAvailable(start + 999ms) == 0);
+	REQUIRE(budget.GetAvailable(start + 1s) == 1);
+
+	REQUIRE(budget.TrySpend(start + 1s));
+	REQUIRE(!budget.TrySpend(start + 1500ms));
+	REQUIRE(budget.TrySpend(start + 2s));
+
+	// Doesn't save up more than its capacity
+	REQUIRE(budget.GetAvailable(start + 1h) == 4);
+	for (int i = 0; i < 4; i++)
+		REQUIRE(budget.TrySpend(start + 1h));
+	REQUIRE(!budget.TrySpend(start + 1h));
+}
+
+TEST_CASE("tf2bd_player_request_scheduler_priority")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	RequestBudget budget(100, 1s);
+	PlayerRequestScheduler scheduler;
+
+	const SteamID ids[] = { SteamID(76561197960265729), SteamID(76561197960265730), SteamID(76561197960265731),
+		SteamID(76561197960265732), SteamID(76561197960265733) };
+
+	for (const auto& id : ids)
+		scheduler.Queue(id, PlayerRequestPriority::Background, start);
+
+	REQUIRE(scheduler.GetQueuedCount() == 5);
+
+	scheduler.Prioritize(ids[3], PlayerRequestPriority::Marked, start);
+	scheduler.Prioritize(ids[4], PlayerRequestPriority::Visible, start);
+	scheduler.Prioritize(ids[2], PlayerRequestPriority::Hovered, start);
+	REQUIRE(scheduler.GetPriority(ids[2], start) == PlayerRequestPriority::Hovered);
+
+	// A less important priority doesn't override a more important one that's still fresh
+	scheduler.Prioritize(ids[2], PlayerRequestPriority::Marked, start + 1s);
+	REQUIRE(scheduler.GetPriority(ids[2], start + 1s) == PlayerRequestPriority::Hovered);
+
+	auto batch = scheduler.TakeBatch(3, budget, start + 1s);
+	REQUIRE(batch == std::vector<SteamID>{ ids[2], ids[4], ids[3] });
+	REQUIRE(scheduler.GetQueuedCount() == 2);
+
+	// Ties go in queue order
+	batch = scheduler.TakeBatch(100, budget, start + 1s);
+	REQUIRE(batch == std::vector<SteamID>{ ids[0], ids[1] });
+	REQUIRE(scheduler.TakeBatch(100, budget, start + 1s).empty());
+}
+
+TEST_CASE("tf2bd_player_request_scheduler_decay")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	RequestBudget budget(100, 1s);
+	PlayerRequestScheduler scheduler;
+
+	const SteamID first(76561197960265729);
+	const SteamID second(76561197960265730);
+	scheduler.Queue(first, PlayerRequestPriority::Background, start);
+	scheduler.Queue(second, PlayerRequestPriority::Visible, start);
+
+	REQUIRE(scheduler.GetPriority(second, start + PlayerRequestScheduler::PRIORITY_LIFETIME) == PlayerRequestPriority::Visible);
+	REQUIRE(scheduler.GetPriority(second, start + 3s) == PlayerRequestPriority::Background);
+
+	// Scrolled out of view, back in line behind the player queued first
+	REQUIRE(scheduler.TakeBatch(1, budget, start + 3s) == std::vector<SteamID>{ first });
+	REQUIRE(scheduler.TakeBatch(1, budget, start + 3s) == std::vector<SteamID>{ second });
+}
+
+TEST_CASE("tf2bd_player_request_scheduler_lifecycle")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	PlayerRequestScheduler scheduler;
+
+	const SteamID left(76561197960265729);
+	const SteamID stayed(76561197960265730);
+	scheduler.Queue(left, PlayerRequestPriority::Background, start);
+	scheduler.Queue(stayed, PlayerRequestPriority::Background, start);
+
+	// Left before their request went out
+	REQUIRE(scheduler.Cancel(left));
+	REQUIRE(!scheduler.Cancel(left));
+	REQUIRE(!scheduler.IsQueued(left));
+
+	// No budget, nothing goes out
+	RequestBudget budget(1, 1min);
+	REQUIRE(budget.TrySpend(start));
+	REQUIRE(scheduler.TakeBatch(100, budget, start).empty());
+	REQUIRE(scheduler.IsQueued(stayed));
+
+	REQUIRE(scheduler.TakeBatch(100, budget, start + 1min) == std::vector<SteamID>{ stayed });
+
+	// Only requested once
+	scheduler.Queue(stayed, PlayerRequestPriority::Hovered, start + 2min);
+	REQUIRE(!scheduler.IsQueued(stayed));
+
+	// ...unless the request failed
+	scheduler.OnRequestFailed({ stayed }, start + 2min);
+	scheduler.Queue(stayed, PlayerRequestPriority::Hovered, start + 2min);
+	REQUIRE(scheduler.IsQueued(stayed));
+	REQUIRE(scheduler.GetPriority(stayed, start + 2min) == PlayerRequestPriority::Hovered);
+
+	scheduler.clear();
+	REQUIRE(scheduler.GetQueuedCount() == 0);
+	REQUIRE(!scheduler.GetPriority(stayed, start + 2min));
+}
+
+TEST_CASE("tf2bd_player_request_scheduler_retry_backoff")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	RequestBudget budget(1000, 1s);
+	PlayerRequestScheduler scheduler;
+
+	const SteamID id(76561197960265729);
+	const SteamID other(76561197960265730);
+	scheduler.Queue(id, PlayerRequestPriority::Background, start);
+	REQUIRE(scheduler.TakeBatch(100, budget, start) == std::vector<SteamID>{ id });
+
+	// Still queued, but held back until the retry time, without spending any budget
+	scheduler.OnRequestFailed({ id }, start);
+	REQUIRE(scheduler.IsQueued(id));
+	REQUIRE(scheduler.GetRetryTime(id) == start + PlayerRequestScheduler::MIN_RETRY_DELAY);
+	REQUIRE(budget.GetAvailable(start) == 999);
+	REQUIRE(scheduler.TakeBatch(100, budget, start + 1s).empty());
+	REQUIRE(budget.GetAvailable(start + 1s) == 1000);
+
+	// Others still go out in the meantime
+	scheduler.Queue(other, PlayerRequestPriority::Background, start + 1s);
+	REQUIRE(scheduler.TakeBatch(100, budget, start + 1s) == std::vector<SteamID>{ other });
+
+	// Each failure in a row doubles the delay, up to the maximum
+	time_point_t now = start + PlayerRequestScheduler::MIN_RETRY_DELAY;
+	duration_t expectedDelay = PlayerRequestScheduler::MIN_RETRY_DELAY;
+	for (int i = 0; i < 10; i++)
+	{
+		REQUIRE(scheduler.TakeBatch(100, budget, now) == std::vector<SteamID>{ id });
+		scheduler.OnRequestFailed({ id }, now);
+
+		expectedDelay = std::min(expectedDelay * 2, PlayerRequestScheduler::MAX_RETRY_DELAY);
+		REQUIRE(scheduler.GetRetryTime(id) == now + expectedDelay);
+		REQUIRE(scheduler.TakeBatch(100, budget, now + expectedDelay - 1s).empty());
+		now += expectedDelay;
+	}
+
+	REQUIRE(expectedDelay == PlayerRequestScheduler::MAX_RETRY_DELAY);
+
+	// Prioritizing doesn't skip the wait
+	scheduler.Prioritize(id, PlayerRequestPriority::Hovered, now - 1s);
+	REQUIRE(scheduler.TakeBatch(100, budget, now - 1s).empty());
+
+	// Left while the retry was in flight, so it isn't retried
+	REQUIRE(scheduler.TakeBatch(100, budget, now) == std::vector<SteamID>{ id });
+	REQUIRE(!scheduler.Cancel(id));
+	scheduler.OnRequestFailed({ id }, now);
+	REQUIRE(!scheduler.IsQueued(id));
+	REQUIRE(!scheduler.GetRetryTime(id));
+}
+
+TEST_CASE("tf2bd_single_player_requests")
+{
+	const time_point_t start = time_point_t{} + 24h;
+	RequestBudget budget(100, 1s);
+	PlayerRequestScheduler scheduler;
+	SinglePlayerRequests<int> requests(2);
+
+	const SteamID invalid(76561197960265729);
+	const SteamID ids[] = { SteamID(76561197960265730), SteamID(76561197960265731), SteamID(76561197960265732) };
+	scheduler.Queue(invalid, PlayerRequestPriority::Hovered, start);
+	for (const SteamID& id : ids)
+		scheduler.Queue(id, PlayerRequestPriority::Background, start);
+
+	std::vector<std::promise<int>> promises;
+	const auto StartRequest = [&](const SteamID& id) -> std::future<int>
+	{
+		if (id == invalid)
+			return {};
+
+		return promises.emplace_back().get_future();
+	};
+
+	// A request that couldn't be made doesn't take up a slot...
+	requests.Start(scheduler, budget, start, StartRequest);
+	REQUIRE(requests.GetInFlightCount() == 2);
+	REQUIRE(promises.size() == 2);
+
+	// ...and isn't tried again
+	REQUIRE(!scheduler.IsQueued(invalid));
+	scheduler.OnRequestFailed({ invalid }, start);
+	REQUIRE(!scheduler.IsQueued(invalid));
+
+	// Full
+	requests.Start(scheduler, budget, start, StartRequest);
+	REQUIRE(promises.size() == 2);
+
+	std::vector<std::pair<SteamID, int>> finished;
+	const auto OnFinished = [&](const SteamID& id, std::future<int>& response) { finished.emplace_back(id, response.get()); };
+	requests.TakeFinished(OnFinished);
+	REQUIRE(finished.empty());
+
+	promises[1].set_value(5);
+	requests.TakeFinished(OnFinished);
+	REQUIRE(finished == std::vector<std::pair<SteamID, int>>{ { ids[1], 5 } });
+	REQUIRE(requests.GetInFlightCount() == 1);
+
+	requests.Start(scheduler, budget, start, StartRequest);
+	REQUIRE(requests.GetInFlightCount() == 2);
+	REQUIRE(promises.size() == 3);
+	REQUIRE(scheduler.GetQueuedCount() == 0);
+}
@@ -0,0 +1,81 @@
+#include "Util/RowHeights.h"
+
+#include <catch2/catch.hpp>
+
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_row_heights_offsets")
+{
+	RowHeights heights;
+	heights.SetDefaultHeight(10);
+
+	for (int i = 0; i < 5; i++)
+		heights.push_back();
+
+	REQUIRE(heights.GetTotalHeight() == 50);
+	REQUIRE(heights.GetTop(3) == 30);
+
+	// Measured rows
+	heights.SetHeight(1, 25);
+	heights.SetHeight(3, 5);
+	REQUIRE(heights.GetTop(2) == 35);
+	REQUIRE(heights.GetTotalHeight() == 60);
+
+	REQUIRE(heights.FindRow(0) == 0);
+	REQUIRE(heights.FindRow(9.5f) == 0);
+	REQUIRE(heights.FindRow(10) == 1);
+	REQUIRE(heights.FindRow(34) == 1);
+	REQUIRE(heights.FindRow(57) == 4);
+	REQUIRE(heights.FindRow(60) == 5);
+	REQUIRE(heights.FindRow(-100) == 0);
+
+	// Unmeasured rows follow the default height
+	heights.SetDefaultHeight(20);
+	REQUIRE(heights.GetTotalHeight() == 90);
+
+	heights.ResetHeights();
+	REQUIRE(heights.GetTotalHeight() == 100);
+	REQUIRE(heights.FindRow(45) == 2);
+}
+
+TEST_CASE("tf2bd_row_heights_eviction")
+{
+	RowHeights heights;
+	heights.SetDefaultHeight(10);
+
+	for (int i = 0; i < 4; i++)
+		heights.push_back(float(i + 1));
+
+	// Offsets are relative to the first row that's still around
+	heights.pop_front(2);
+	REQUIRE(heights.size() == 2);
+	REQUIRE(heights.GetFirstIndex() == 2);
+	REQUIRE(heights.GetHeight(0) == 3);
+	REQUIRE(heights.GetTop(1) == 3);
+	REQUIRE(heights.GetTotalHeight() == 7);
+	REQUIRE(heights.FindRow(2.5f) == 0);
+	REQUIRE(heights.FindRow(3) == 1);
+
+	heights.SetHeight(0, 6);
+	heights.push_back();
+	REQUIRE(heights.GetTotalHeight() == 20);
+
+	// Following a log that dropped 2 more messages and added 3
+	heights.Track(4, 4);
+	REQUIRE(heights.GetFirstIndex() == 4);
+	REQUIRE(heights.size() == 4);
+	REQUIRE(heights.GetHeight(0) == 10);
+	REQUIRE(heights.GetTotalHeight() == 40);
+
+	// Everything we knew about is gone
+	heights.SetHeight(3, 1);
+	heights.Track(100, 2);
+	REQUIRE(heights.GetFirstIndex() == 100);
+	REQUIRE(heights.size() == 2);
+	REQUIRE(heights.GetTotalHeight() == 20);
+
+	heights.clear();
+	REQUIRE(heights.empty());
+	REQUIRE(heights.GetTotalHeight() == 0);
+	REQUIRE(heights.FindRow(5) == 0);
+}
@@ -0,0 +1,222 @@
+#include "Actions/Actions.h"
+#include "Config/PlayerListJSON.h"
+#include "Config/Settings.h"
+#include "ConsoleLog/ConsoleLineListener.h"
+#include "ConsoleLog/ConsoleLines.h"
+#include "ConsoleLog/SessionJournal.h"
+#include "IPlayer.h"
+#include "WorldState.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct JournalingListener final : AutoConsoleLineListener
+	{
+		JournalingListener(IWorldState& world) : AutoConsoleLineListener(world, GetJournaledConsoleLineTypes()) {}
+
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override
+		{
+			REQUIRE(m_Encoder.AddConsoleLine(line));
+		}
+
+		SessionJournalEncoder m_Encoder;
+	};
+
+	std::vector<std::string> GenerateSession(size_t statusDumps)
+	{
+		std::vector<std::string> lines;
+		lines.push_back("CTFLobbyShared: ID:0000000000000001  4 member(s), 0 pending");
+		for (size_t i = 0; i < 4; i++)
+		{
+			lines.push_back(mh::format("  Member[{}] [U:1:{}]  team = {}  type = MATCH_PLAYER",
+				i, 1000 + i, (i % 2) ? "TF_GC_TEAM_DEFENDERS" : "TF_GC_TEAM_INVADERS"));
+		}
+
+		for (size_t dump = 0; dump < statusDumps; dump++)
+		{
+			lines.push_back("players : 4 humans, 0 bots (24 max)");
+			for (size_t i = 0; i < 4; i++)
+			{
+				lines.push_back(mh::format(R"(#      {} "Player {}"          [U:1:{}]          {:02}:00       {}    0 active)",
+					2 + i, i, 1000 + i, 5 + dump, 40 + dump + i));
+			}
+
+			lines.push_back("Player 1 killed Player 2 with scattergun.");
+			lines.push_back("Player 3 killed Player 0 with sniperrifle. (crit)");
+		}
+
+		return lines;
+	}
+}
+
+TEST_CASE("tf2bd_session_journal_roundtrip")
+{
+	Settings settings;
+	auto world = IWorldState::Create(settings);
+	JournalingListener journal(*world);
+
+	const auto lines = GenerateSession(3);
+	for (const auto& line : lines)
+		world->AddConsoleOutputLine(line);
+
+	const auto markTime = time_point_t(1600000000s);
+	journal.m_Encoder.AddPlayerMark(markTime, SteamID(76561197960266730), PlayerAttribute::Cheater, true);
+	journal.m_Encoder.AddVotekick(markTime + 1500ms, SteamID(76561197960266730), KickReason::Cheating);
+
+	std::string data;
+	journal.m_Encoder.Flush(data);
+	REQUIRE(data.size() < (lines.size() * 40));
+
+	// Rebuild the world from the journal
+	auto replayedWorld = IWorldState::Create(settings);
+	{
+		SessionJournalReader reader(data);
+		SessionJournalReplayer replayer(*replayedWorld, reader);
+
+		std::vector<SessionJournalRecord> events;
+		replayer.ReplayAll([&](const SessionJournalRecord& record) { events.push_back(record); });
+
+		REQUIRE(events.size() == 2);
+		REQUIRE(events[0].m_Type == SessionJournalRecordType::PlayerMarked);
+		REQUIRE(events[0].m_Timestamp == markTime);
+		REQUIRE(events[0].m_SteamID == SteamID(76561197960266730));
+		REQUIRE(events[0].m_Attribute == PlayerAttribute::Cheater);
+		REQUIRE(events[1].m_Type == SessionJournalRecordType::Votekick);
+		REQUIRE(events[1].m_Timestamp == markTime + 1500ms);
+		REQUIRE(events[1].m_KickReason == KickReason::Cheating);
+	}
+
+	REQUIRE(replayedWorld->GetPlayerTable().m_Players.size() == world->GetPlayerTable().m_Players.size());
+	for (const IPlayer& player : world->GetPlayers())
+	{
+		const IPlayer* replayed = replayedWorld->FindPlayer(player.GetSteamID());
+		REQUIRE(replayed);
+		REQUIRE(replayed->GetNameUnsafe() == player.GetNameUnsafe());
+		REQUIRE(replayed->GetUserID() == player.GetUserID());
+		REQUIRE(replayed->GetTeam() == player.GetTeam());
+		REQUIRE(replayed->GetScores().m_Kills == player.GetScores().m_Kills);
+		REQUIRE(replayed->GetScores().m_Deaths == player.GetScores().m_Deaths);
+	}
+
+	// Anything cut off mid-write is just the end of the journal
+	{
+		SessionJournalReader reader(data.substr(0, data.size() - 1));
+		SessionJournalRecord record;
+		size_t recordCount = 0;
+		while (reader.ReadNext(record))
+			recordCount++;
+
+		REQUIRE(recordCount == 0);
+	}
+
+	REQUIRE_THROWS(SessionJournalReader("TF2BDLOG"));
+}
+
+TEST_CASE("tf2bd_session_journal_stable_format")
+{
+	// Written by version 1: a Ping line and a PlayerMarked record. Renumbering ConsoleLineType
+	// (or anything else the journal stores) must not change how this reads.
+	using namespace std::string_literals;
+	const auto data = "TF2BDJNL\x01"
+		"\x0E" "\x00\x02"
+		"\x00\x00" "\x02" "\x32" "\x03" "Bob"
+		"\x03\x00" "\x05" "\x01"s;
+
+	SessionJournalReader reader(data);
+	SessionJournalRecord record;
+
+	REQUIRE(reader.ReadNext(record));
+	REQUIRE(record.m_Type == SessionJournalRecordType::ConsoleLine);
+	REQUIRE(record.m_Timestamp == time_point_t{});
+	REQUIRE(record.m_Line);
+	REQUIRE(record.m_Line->GetType() == ConsoleLineType::Ping);
+	const auto& ping = static_cast<const PingLine&>(*record.m_Line);
+	REQUIRE(ping.GetPing() == 50);
+	REQUIRE(ping.GetPlayerName() == "Bob");
+
+	REQUIRE(reader.ReadNext(record));
+	REQUIRE(record.m_Type == SessionJournalRecordType::PlayerMarked);
+	REQUIRE(record.m_SteamID == SteamID(76561197960265733));
+	REQUIRE(record.m_Attribute == PlayerAttribute::Suspicious);
+
+	REQUIRE(!reader.ReadNext(record));
+}
+
+TEST_CASE("tf2bd_session_journal_replay_until")
+{
+	SessionJournalEncoder encoder;
+	const auto start = time_point_t(1600000000s);
+	for (int i = 0; i < 10; i++)
+	{
+		encoder.AddConsoleLine(ServerStatusPlayerCountLine(start + i * 1s, uint8_t(i), 0, 24));
+		if (i == 4)
+		{
+			std::string discard;
+			encoder.Flush(discard); // Split across blocks
+		}
+	}
+
+	// Blocks are self-contained, so the second one can be read without the first
+	std::string data;
+	{
+		SessionJournalEncoder headerOnly;
+		headerOnly.Flush(data);
+	}
+	encoder.Flush(data);
+
+	Settings settings;
+	auto world = IWorldState::Create(settings);
+	SessionJournalReader reader(data);
+	SessionJournalReplayer replayer(*world, reader);
+
+	REQUIRE(reader.PeekTimestamp() == start + 5s);
+	REQUIRE(replayer.ReplayUntil(start + 7s));
+	REQUIRE(world->GetCurrentTime() == start + 7s);
+	REQUIRE(reader.PeekTimestamp() == start + 8s);
+	REQUIRE(!replayer.ReplayUntil(start + 1h));
+	REQUIRE(world->GetCurrentTime() == start + 9s);
+	REQUIRE(!reader.PeekTimestamp());
+}
+
+TEST_CASE("tf2bd_session_journal_performance")
+{
+	Settings settings;
+
+	std::string text;
+	for (const auto& line : GenerateSession(200))
+		text.append(line).append("\n");
+
+	std::string data;
+	{
+		auto world = IWorldState::Create(settings);
+		JournalingListener journal(*world);
+		world->AddConsoleOutputChunk(text);
+		journal.m_Encoder.Flush(data);
+	}
+
+	INFO("Text: " << text.size() << " bytes, journal: " << data.size() << " bytes");
+	REQUIRE(data.size() < text.size() / 2);
+
+	BENCHMARK("Parse console text")
+	{
+		auto world = IWorldState::Create(settings);
+		world->AddConsoleOutputChunk(text);
+		return world->GetPlayerTable().m_Players.size();
+	};
+
+	BENCHMARK("Replay session journal")
+	{
+		auto world = IWorldState::Create(settings);
+		SessionJournalReader reader(data);
+		SessionJournalReplayer(*world, reader).ReplayAll();
+		return world->GetPlayerTable().m_Players.size();
+	};
+}
@@ -0,0 +1,161 @@
+#include "SteamID.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// The SteamID3 pattern the parser replaced, kept as the reference implementation
+	const std::regex s_SteamID3Regex(R"regex(\[([a-zA-Z]):(\d):(\d+)(?::(\d+))?\])regex", std::regex::optimize);
+}
+
+static_assert(FormatSteamID3(SteamID(76561198003911389)).view() == "[U:1:43645661]"sv);
+static_assert(FormatSteamID2(SteamID(76561198003911389)).view() == "STEAM_0:1:21822830"sv);
+static_assert(FormatSteamID64(SteamID(76561198003911389)).view() == "76561198003911389"sv);
+static_assert([]
+	{
+		SteamID id;
+		return TryParseSteamID("[U:1:43645661]", id) == SteamIDParseError::None && id.IsPazer();
+	}());
+
+TEST_CASE("tf2bd_steamid_parse")
+{
+	const SteamID pazer(76561198003911389);
+	REQUIRE(SteamID("[U:1:43645661]") == pazer);
+	REQUIRE(SteamID("[U:1:43645661:1]") == pazer);
+	REQUIRE(SteamID("STEAM_0:1:21822830") == pazer);
+	REQUIRE(SteamID("STEAM_1:1:21822830") == pazer);
+	REQUIRE(SteamID("76561198003911389") == pazer);
+	REQUIRE(SteamID(" 76561198003911389\n") == pazer);
+	REQUIRE(SteamID("[I:0:0]") == SteamID());
+
+	REQUIRE(SteamID("[g:1:4]").Type == SteamAccountType::Clan);
+	REQUIRE(SteamID("[T:1:4]").Type == SteamAccountType::Chat);
+	REQUIRE(SteamID("[A:1:4:1234]").Instance == SteamAccountInstance(1234));
+	REQUIRE(SteamID("[U:1:4294967295]").ID == 4294967295);
+
+	REQUIRE_THROWS_AS(SteamID("[X:1:4]"), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("[U:1:4294967296]"), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("18446744073709551616"), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID(""), std::invalid_argument);
+
+	for (auto invalid : { "[U:1:]", "[U:12:3]", "[U:1:3:]", "[U:1:3", "U:1:3]", "[1:1:3]", "STEAM_0:2:3", "STEAM_0:1:", "7656 1198" })
+	{
+		INFO(invalid);
+		SteamID id;
+		REQUIRE(TryParseSteamID(invalid, id) == SteamIDParseError::UnknownFormat);
+	}
+}
+
+TEST_CASE("tf2bd_steamid_regex_equivalence")
+{
+	std::mt19937 random(41);
+	const auto Next = [&](uint32_t min, uint32_t max) { return std::uniform_int_distribution<uint32_t>(min, max)(random); };
+
+	constexpr std::string_view ALPHABET = "[]:0123456789UgIXS ";
+	for (size_t i = 0; i < 20000; i++)
+	{
+		std::string str;
+		if (Next(0, 1))
+		{
+			str = mh::format("[{}:{}:{}", "UMGAPCgaTLcIX"[Next(0, 12)], Next(0, 9), Next(0, UINT32_MAX));
+			if (Next(0, 1))
+				str += mh::format(":{}", Next(0, 5000));
+
+			str += ']';
+		}
+
+		for (uint32_t m = Next(0, 3); m > 0; m--)
+		{
+			const char c = ALPHABET[Next(0, uint32_t(ALPHABET.size() - 1))];
+			if (!str.empty() && Next(0, 1))
+				str[Next(0, uint32_t(str.size() - 1))] = c;
+			else
+				str.insert(str.begin() + Next(0, uint32_t(str.size())), c);
+		}
+
+		INFO(str);
+
+		std::match_results<std::string::const_iterator> match;
+		if (!std::regex_match(str, match, s_SteamID3Regex))
+		{
+			SteamID id;
+			if (!str.empty() && str.front() == '[')
+				REQUIRE(TryParseSteamID(str, id) != SteamIDParseError::None);
+
+			continue;
+		}
+
+		SteamID id;
+		const auto error = TryParseSteamID(str, id);
+		if (error == SteamIDParseError::None)
+		{
+			REQUIRE(id.str() == (id.Type == SteamAccountType::Invalid ? "[I:0:0]" : mh::format("[{}:{}:{}]",
+				FormatSteamID3(id).view()[1], match[2].str(), std::stoull(match[3].str()))));
+		}
+		else
+		{
+			REQUIRE((error == SteamIDParseError::UnknownAccountType || error == SteamIDParseError::OutOfRange));
+		}
+	}
+}
+
+TEST_CASE("tf2bd_steamid_bulk")
+{
+	std::vector<SteamID> expected;
+	std::string buffer;
+	for (uint32_t i = 1; i <= 1000; i++)
+	{
+		expected.push_back(SteamID(i * 7919, SteamAccountType::Individual, SteamAccountUniverse::Public));
+		switch (i % 3)
+		{
+		case 0: buffer += FormatSteamID3(expected.back()); break;
+		case 1: buffer += FormatSteamID2(expected.back()); break;
+		case 2: buffer += FormatSteamID64(expected.back()); break;
+		}
+
+		buffer += (i % 4) ? ", "sv : "\n"sv;
+	}
+	buffer += "not_a_steamid";
+
+	std::vector<SteamID> ids;
+	const auto result = ParseSteamIDs(buffer, ids);
+	REQUIRE(result.m_Parsed == expected.size());
+	REQUIRE(result.m_Failed == 1);
+	REQUIRE(ids == expected);
+
+	for (const auto& id : expected)
+	{
+		REQUIRE(SteamID(FormatSteamID3(id)) == id);
+		REQUIRE(SteamID(FormatSteamID2(id)) == id);
+		REQUIRE(SteamID(FormatSteamID64(id)) == id);
+	}
+
+	BENCHMARK("ParseSteamIDs (1000 mixed IDs)")
+	{
+		ids.clear();
+		return ParseSteamIDs(buffer, ids).m_Parsed;
+	};
+
+	const std::string steamID3 = "[U:1:43645661]";
+	BENCHMARK("std::regex SteamID3")
+	{
+		std::match_results<std::string::const_iterator> match;
+		return std::regex_match(steamID3, match, s_SteamID3Regex);
+	};
+	BENCHMARK("TryParseSteamID SteamID3")
+	{
+		SteamID id;
+		return TryParseSteamID(steamID3, id);
+	};
+}
@@ -0,0 +1,94 @@
+#include "TaskScheduler.h"
+
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_task_scheduler_run")
+{
+	TaskScheduler scheduler(4);
+
+	auto value = scheduler.Run(TaskPriority::UICritical, [] { return 42; });
+	REQUIRE(value.get() == 42);
+
+	auto failed = scheduler.Run(TaskPriority::Network, []() -> int { throw std::runtime_error("test"); });
+	REQUIRE_THROWS_AS(failed.get(), std::runtime_error);
+
+	// Continuations only run once their dependency is done, and see its exceptions
+	std::promise<void> gate;
+	auto first = scheduler.Run(TaskPriority::Network, [wait = gate.get_future().share()] { wait.wait(); return 2; }).share();
+	auto second = scheduler.ContinueWith(first, TaskPriority::Network,
+		[](const std::shared_future<int>& dep) { return dep.get() * 21; });
+	auto third = scheduler.ContinueWith(std::shared_future<int>{}, TaskPriority::Network,
+		[](const std::shared_future<int>& dep) { return dep.valid(); });
+
+	REQUIRE(second.wait_for(50ms) == std::future_status::timeout);
+	REQUIRE(scheduler.GetStats().m_WaitingContinuations == 1);
+	gate.set_value();
+	REQUIRE(second.get() == 42);
+	REQUIRE(!third.get());
+}
+
+TEST_CASE("tf2bd_task_scheduler_priority_caps")
+{
+	TaskScheduler scheduler(4);
+
+	// Fill every slot network tasks are allowed
+	std::promise<void> gate;
+	std::shared_future<void> wait = gate.get_future().share();
+	std::vector<std::future<void>> blocked;
+	for (int i = 0; i < 8; i++)
+		blocked.push_back(scheduler.Run(TaskPriority::Network, [wait] { wait.wait(); }));
+
+	// There's still a worker left for this
+	auto critical = scheduler.Run(TaskPriority::UICritical, [] { return true; });
+	REQUIRE(critical.wait_for(5s) == std::future_status::ready);
+
+	auto stats = scheduler.GetStats();
+	REQUIRE(stats.m_ThreadCount == 4);
+	REQUIRE(stats.m_Running[size_t(TaskPriority::Network)] == 3);
+	REQUIRE(stats.m_Queued[size_t(TaskPriority::Network)] == 5);
+	REQUIRE(stats.m_PeakQueued >= 5);
+
+	gate.set_value();
+	for (auto& task : blocked)
+		task.get();
+
+	stats = scheduler.GetStats();
+	REQUIRE(stats.m_Queued[size_t(TaskPriority::Network)] == 0);
+	REQUIRE(stats.m_Completed >= 9);
+}
+
+TEST_CASE("tf2bd_task_scheduler_parallel_for_each")
+{
+	TaskScheduler scheduler(4);
+
+	std::vector<int> values(1000);
+	std::iota(values.begin(), values.end(), 0);
+
+	// From inside a task, with the rest of the pool tied up
+	auto sum = scheduler.Run(TaskPriority::UICritical, [&]
+		{
+			std::atomic<int> retVal = 0;
+			scheduler.ParallelForEach(TaskPriority::UICritical, values.begin(), values.end(),
+				[&](int value)
+				{
+					std::atomic<int> nested = 0;
+					scheduler.ParallelForEach(TaskPriority::UICritical, values.begin(), values.begin() + 3,
+						[&](int) { nested++; });
+
+					retVal += value + nested - 3;
+				});
+
+			return retVal.load();
+		});
+
+	REQUIRE(sum.get() == 499500);
+
+	REQUIRE_THROWS_AS(scheduler.ParallelForEach(TaskPriority::BackgroundIO, values.begin(), values.end(),
+		[](int value) { if (value == 500) throw std::runtime_error("test"); }), std::runtime_error);
+}
@@ -0,0 +1,191 @@
+#include "Util/TextUtils.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	std::u8string EncodeU8Reference(char32_t cp)
+	{
+		std::u8string retVal;
+		if (cp < 0x80)
+		{
+			retVal += char8_t(cp);
+		}
+		else if (cp < 0x800)
+		{
+			retVal += char8_t(0xC0 | (cp >> 6));
+			retVal += char8_t(0x80 | (cp & 0x3F));
+		}
+		else if (cp < 0x10000)
+		{
+			retVal += char8_t(0xE0 | (cp >> 12));
+			retVal += char8_t(0x80 | ((cp >> 6) & 0x3F));
+			retVal += char8_t(0x80 | (cp & 0x3F));
+		}
+		else
+		{
+			retVal += char8_t(0xF0 | (cp >> 18));
+			retVal += char8_t(0x80 | ((cp >> 12) & 0x3F));
+			retVal += char8_t(0x80 | ((cp >> 6) & 0x3F));
+			retVal += char8_t(0x80 | (cp & 0x3F));
+		}
+
+		return retVal;
+	}
+
+	// Something shaped like a resource/tf_<language>.txt file: ASCII keys and
+	// markup with mostly non-ASCII values
+	std::u16string GenerateLocalizationFile(size_t approxBytes)
+	{
+		static constexpr std::u16string_view VALUES[] =
+		{
+			u"Вы были убиты %s1 с помощью %s2",
+			u"%s1 が %s2 をキルしました",
+			u"*MORT* %s1 : %s2",
+			u"Ένα παιχνίδι ψηφοφορίας είναι ήδη σε εξέλιξη",
+			u"Die Runde beginnt in %s1 Sekunden",
+			u"\U0001F600 emoji \U0001F47B in names",
+		};
+
+		std::u16string retVal = u"\"lang\"\r\n{\r\n\t\"Language\"\t\"russian\"\r\n\t\"Tokens\"\r\n\t{\r\n";
+		for (size_t i = 0; retVal.size() * sizeof(char16_t) < approxBytes; i++)
+		{
+			const auto key = ToU16("TF_Generated_Token_"s + std::to_string(i));
+			const auto value = VALUES[i % std::size(VALUES)];
+
+			retVal.append(u"\t\t\"").append(key).append(u"\"\t\t\"").append(value).append(u"\"\r\n");
+			retVal.append(u"\t\t\"[english]").append(key).append(u"\"\t\t\"Some english text for token ")
+				.append(ToU16(std::to_string(i))).append(u"\"\r\n");
+		}
+
+		retVal.append(u"\t}\r\n}\r\n");
+		return retVal;
+	}
+}
+
+TEST_CASE("tf2bd_textutils_transcode")
+{
+	REQUIRE(ToU16("") == u"");
+	REQUIRE(ToMB(u""sv) == "");
+	REQUIRE(ToU16("hello world, this is longer than sixteen chars") == u"hello world, this is longer than sixteen chars");
+	REQUIRE(ToU16(u8"Привет, мир! \U0001F600") == u"Привет, мир! \U0001F600");
+	REQUIRE(ToU8(u"Привет, мир! \U0001F600"sv) == u8"Привет, мир! \U0001F600");
+
+	// Every scalar value round trips, at every offset relative to the 16 unit SIMD blocks
+	std::u8string utf8;
+	std::u16string utf16;
+	for (char32_t cp = 0; cp <= 0x10FFFF; cp++)
+	{
+		if (cp >= 0xD800 && cp <= 0xDFFF)
+			continue;
+
+		const auto prefix = std::u8string(cp % 17, u8'a');
+		const auto encoded = prefix + EncodeU8Reference(cp) + prefix;
+
+		REQUIRE(ToU16(encoded, utf16));
+		REQUIRE(ToU8(utf16, utf8));
+		REQUIRE(utf8 == encoded);
+	}
+
+	// Malformed input
+	for (auto invalid : { "\x80"sv, "\xC0\xAF"sv, "\xE0\x80\xAF"sv, "\xED\xA0\x80"sv, "\xF4\x90\x80\x80"sv, "\xF5"sv, "abc\xE2\x82"sv })
+	{
+		INFO(std::string(invalid));
+		REQUIRE(!ToU16(invalid, utf16));
+		REQUIRE(utf16.find(u'\xFFFD') != utf16.npos);
+		REQUIRE_THROWS_AS(ToU16(invalid), std::range_error);
+	}
+
+	for (auto invalid : { u"\xD800"sv, u"\xDC00"sv, u"abc\xD83D"sv, u"\xD83D" u"abcdefghijklmnopqrstuvwxyz"sv })
+	{
+		std::string mb;
+		REQUIRE(!ToMB(invalid, mb));
+		REQUIRE(mb.find("\xEF\xBF\xBD") != mb.npos);
+		REQUIRE_THROWS_AS(ToMB(invalid), std::range_error);
+	}
+}
+
+TEST_CASE("tf2bd_textutils_transcode_random")
+{
+	std::mt19937 random(44);
+	std::uniform_int_distribution<uint32_t> lengthDist(0, 100);
+	std::uniform_int_distribution<uint32_t> unitDist(0, 0xFFFF);
+	std::uniform_int_distribution<uint32_t> asciiDist(0, 0x7F);
+
+	std::u16string utf16;
+	std::u16string roundTrip;
+	std::string utf8;
+	for (size_t i = 0; i < 20000; i++)
+	{
+		// Mostly ASCII with the occasional arbitrary (possibly unpaired surrogate) code unit
+		utf16.resize(lengthDist(random));
+		for (auto& c : utf16)
+			c = char16_t((random() % 8) ? asciiDist(random) : unitDist(random));
+
+		const bool valid = ToMB(utf16, utf8);
+		REQUIRE(ToU16(utf8, roundTrip));
+
+		if (valid)
+		{
+			REQUIRE(roundTrip == utf16);
+		}
+		else
+		{
+			REQUIRE(roundTrip.size() == utf16.size());
+			for (size_t c = 0; c < utf16.size(); c++)
+			{
+				if (utf16[c] < 0xD800 || utf16[c] > 0xDFFF)
+					REQUIRE(roundTrip[c] == utf16[c]);
+			}
+		}
+	}
+}
+
+TEST_CASE("tf2bd_textutils_transcode_benchmarks")
+{
+	// Same ballpark as the larger tf_<language>.txt files shipped with the game
+	const std::u16string localizationFile = GenerateLocalizationFile(4 * 1024 * 1024);
+	const std::string localizationFileMB = ToMB(localizationFile);
+	REQUIRE(ToU16(localizationFileMB) == localizationFile);
+
+	std::u16string u16Buffer;
+	std::string mbBuffer;
+
+	// Reading localization files (ReadWideFile + ToMB)
+	BENCHMARK("ToMB(u16string_view) 4 MiB localization file")
+	{
+		return ToMB(localizationFile).size();
+	};
+	BENCHMARK("ToMB(u16string_view, buffer) 4 MiB localization file")
+	{
+		ToMB(localizationFile, mbBuffer);
+		return mbBuffer.size();
+	};
+
+	// Writing chat wrapper localization files (ToU16 + WriteWideFile)
+	BENCHMARK("ToU16(string_view) 4 MiB localization file")
+	{
+		return ToU16(localizationFileMB).size();
+	};
+	BENCHMARK("ToU16(string_view, buffer) 4 MiB localization file")
+	{
+		ToU16(localizationFileMB, u16Buffer);
+		return u16Buffer.size();
+	};
+
+	// Command lines and paths: short and almost always ASCII
+	const std::u16string commandLine = u"\"C:\\Program Files (x86)\\Steam\\steamapps\\common\\Team Fortress 2\\hl2.exe\" -game tf -steam -novid";
+	BENCHMARK("ToMB(u16string_view) command line")
+	{
+		return ToMB(commandLine).size();
+	};
+}
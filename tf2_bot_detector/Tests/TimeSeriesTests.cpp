@@ -0,0 +1,54 @@
+#include "Util/TimeSeries.h"
+
+#include <catch2/catch.hpp>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_timeseries_aggregates")
+{
+	TimeSeries<uint16_t, 4> series(10s);
+	const time_point_t start = time_point_t{} + 1h;
+
+	series.push_back(start, 50);
+	series.push_back(start + 1s, 20);
+	series.push_back(start + 2s, 80);
+	REQUIRE(series.size() == 3);
+	REQUIRE(series.GetSum() == 150);
+	REQUIRE(series.GetMin() == 20);
+	REQUIRE(series.GetMax() == 80);
+
+	// Capacity eviction
+	series.push_back(start + 3s, 30);
+	series.push_back(start + 4s, 40);
+	REQUIRE(series.size() == 4);
+	REQUIRE(series.front().m_Value == 20);
+	REQUIRE(series.GetSum() == 170);
+
+	// Time window eviction
+	series.push_back(start + 14s, 60);
+	REQUIRE(series.size() == 2);
+	REQUIRE(series.front().m_Value == 40);
+	REQUIRE(series.GetMin() == 40);
+	REQUIRE(series.GetMax() == 60);
+	REQUIRE(series.GetMean() == Approx(50));
+
+	series.clear();
+	REQUIRE(series.empty());
+	series.push_back(start + 20s, 10);
+	REQUIRE(series.GetEWMA() == Approx(10));
+}
+
+TEST_CASE("tf2bd_timeseries_downsampling")
+{
+	MultiResolutionTimeSeries<uint16_t, 8, 4> series(8s, 10s);
+	const time_point_t start = time_point_t{} + 1h;
+
+	for (int i = 0; i < 60; i++)
+		series.push_back(start + std::chrono::seconds(i), uint16_t(i / 10));
+
+	REQUIRE(series.GetFine().size() == 8);
+	REQUIRE(series.GetCoarse().size() == 4);
+	REQUIRE(series.GetCoarse().front().m_Value == Approx(1));
+	REQUIRE(series.GetCoarse().back().m_Value == Approx(4));
+}
@@ -0,0 +1,192 @@
+#include "Config/Settings.h"
+#include "IPlayer.h"
+#include "WorldEventListener.h"
+#include "WorldState.h"
+
+#include <catch2/catch.hpp>
+#include <mh/text/format.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_world_lobby_iteration")
+{
+	constexpr size_t LOBBY_SIZE = 33;
+
+	Settings settings;
+	auto world = IWorldState::Create(settings);
+
+	world->AddConsoleOutputLine(mh::format("CTFLobbyShared: ID:0000000000000001  {} member(s), 0 pending", LOBBY_SIZE));
+	for (size_t i = 0; i < LOBBY_SIZE; i++)
+	{
+		world->AddConsoleOutputLine(mh::format("  Member[{}] [U:1:{}]  team = {}  type = MATCH_PLAYER",
+			i, 1000 + i, (i % 2) ? "TF_GC_TEAM_DEFENDERS" : "TF_GC_TEAM_INVADERS"));
+	}
+
+	const IWorldState& constWorld = *world;
+
+	size_t rangeCount = 0;
+	for (const IPlayer& player : constWorld.GetLobbyMembers())
+	{
+		REQUIRE(player.GetSteamID() == SteamID(uint32_t(1000 + rangeCount), SteamAccountType::Individual, SteamAccountUniverse::Public));
+		rangeCount++;
+	}
+	REQUIRE(rangeCount == LOBBY_SIZE);
+
+	size_t generatorCount = 0;
+	for (const IPlayer& player : constWorld.GenerateLobbyMembers())
+	{
+		REQUIRE(&player == &constWorld.GetLobbyMembers()[generatorCount]);
+		generatorCount++;
+	}
+	REQUIRE(generatorCount == rangeCount);
+
+	BENCHMARK("GetLobbyMembers (range)")
+	{
+		uint32_t total = 0;
+		for (const IPlayer& player : constWorld.GetLobbyMembers())
+			total += uint32_t(player.GetTeam());
+
+		return total;
+	};
+
+	BENCHMARK("GenerateLobbyMembers (cppcoro::generator)")
+	{
+		uint32_t total = 0;
+		for (const IPlayer& player : constWorld.GenerateLobbyMembers())
+			total += uint32_t(player.GetTeam());
+
+		return total;
+	};
+
+	BENCHMARK("GetPlayers (range)")
+	{
+		uint32_t total = 0;
+		for (const IPlayer& player : constWorld.GetPlayers())
+			total += uint32_t(player.GetTeam());
+
+		return total;
+	};
+
+	BENCHMARK("GeneratePlayers (cppcoro::generator)")
+	{
+		uint32_t total = 0;
+		for (const IPlayer& player : constWorld.GeneratePlayers())
+			total += uint32_t(player.GetTeam());
+
+		return total;
+	};
+}
+
+TEST_CASE("tf2bd_world_scoreboard_order")
+{
+	Settings settings;
+	auto world = IWorldState::Create(settings);
+
+	world->AddConsoleOutputLine(R"(#      2 "Alpha"             [U:1:1001]          05:00       50    0 active)");
+	world->AddConsoleOutputLine(R"(#      3 "Bravo"             [U:1:1002]          05:00       50    0 active)");
+	world->AddConsoleOutputLine(R"(#      4 "Charlie"           [U:1:1003]          05:00       50    0 active)");
+
+	const auto GetOrder = [&]
+	{
+		std::vector<UserID_t> order;
+		for (const IPlayer& player : std::as_const(*world).GetScoreboardPlayers())
+			order.push_back(player.GetUserID().value_or(0));
+
+		return order;
+	};
+
+	REQUIRE(GetOrder() == std::vector<UserID_t>{ 2, 3, 4 });
+
+	world->AddConsoleOutputLine("Bravo killed Charlie with scattergun.");
+	world->AddConsoleOutputLine("Bravo killed Charlie with scattergun.");
+	world->AddConsoleOutputLine("Charlie killed Alpha with tf_projectile_rocket.");
+	REQUIRE(GetOrder() == std::vector<UserID_t>{ 3, 4, 2 });
+
+	world->AddConsoleOutputLine("Alpha killed Bravo with sniperrifle.");
+	REQUIRE(GetOrder() == std::vector<UserID_t>{ 3, 2, 4 });
+}
+
+TEST_CASE("tf2bd_world_status_dump_diff")
+{
+	Settings settings;
+	auto world = IWorldState::Create(settings);
+
+	struct Listener final : AutoWorldEventListener
+	{
+		using AutoWorldEventListener::AutoWorldEventListener;
+
+		void OnPlayerStatusUpdate(IWorldState&, const IPlayer&) override { m_StatusUpdates++; }
+		void OnPlayerTelemetryUpdate(IWorldState&, const IPlayer&) override { m_TelemetryUpdates++; }
+		void OnPlayerJoined(IWorldState&, IPlayer&) override { m_Joins++; }
+		void OnPlayerLeft(IWorldState&, IPlayer& player) override { m_Leaves.push_back(player.GetUserID().value_or(0)); }
+		void OnPlayerNameChanged(IWorldState&, IPlayer&, const std::string_view& oldName) override { m_OldNames.emplace_back(oldName); }
+
+		size_t m_StatusUpdates = 0;
+		size_t m_TelemetryUpdates = 0;
+		size_t m_Joins = 0;
+		std::vector<UserID_t> m_Leaves;
+		std::vector<std::string> m_OldNames;
+
+	} listener(*world);
+
+	world->AddConsoleOutputLine("players : 2 humans, 0 bots (24 max)");
+	world->AddConsoleOutputLine(R"(#      2 "Alpha"             [U:1:1001]          05:00       50    0 active)");
+	world->AddConsoleOutputLine(R"(#      3 "Bravo"             [U:1:1002]          05:00       50    0 active)");
+	REQUIRE(listener.m_Joins == 2);
+	REQUIRE(listener.m_StatusUpdates == 2);
+
+	// Only ping and connection time changed
+	world->AddConsoleOutputLine("players : 2 humans, 0 bots (24 max)");
+	world->AddConsoleOutputLine(R"(#      2 "Alpha"             [U:1:1001]          05:05       60    0 active)");
+	world->AddConsoleOutputLine(R"(#      3 "Bravo"             [U:1:1002]          05:05       70    0 active)");
+	REQUIRE(listener.m_Joins == 2);
+	REQUIRE(listener.m_StatusUpdates == 2);
+	REQUIRE(listener.m_TelemetryUpdates == 2);
+	REQUIRE(listener.m_Leaves.empty());
+
+	// Bravo leaves, Alpha renames, Charlie joins
+	world->AddConsoleOutputLine("players : 2 humans, 0 bots (24 max)");
+	world->AddConsoleOutputLine(R"(#      2 "Alpha2"            [U:1:1001]          05:10       60    0 active)");
+	world->AddConsoleOutputLine(R"(#      4 "Charlie"           [U:1:1003]          00:10       80    0 active)");
+	REQUIRE(listener.m_Joins == 3);
+	REQUIRE(listener.m_StatusUpdates == 4);
+	REQUIRE(listener.m_TelemetryUpdates == 2);
+	REQUIRE(listener.m_OldNames == std::vector<std::string>{ "Alpha" });
+	REQUIRE(listener.m_Leaves == std::vector<UserID_t>{ 3 });
+}
+
+TEST_CASE("tf2bd_world_clear_players_leaves")
+{
+	Settings settings;
+	auto world = IWorldState::Create(settings);
+
+	struct Listener final : AutoWorldEventListener
+	{
+		using AutoWorldEventListener::AutoWorldEventListener;
+
+		void OnPlayerLeft(IWorldState&, IPlayer& player) override { m_Leaves.push_back(player.GetUserID().value_or(0)); }
+
+		std::vector<UserID_t> m_Leaves;
+
+	} listener(*world);
+
+	world->AddConsoleOutputLine("players : 2 humans, 0 bots (24 max)");
+	world->AddConsoleOutputLine(R"(#      2 "Alpha"             [U:1:1001]          05:00       50    0 active)");
+	world->AddConsoleOutputLine(R"(#      3 "Bravo"             [U:1:1002]          05:00       50    0 active)");
+
+	// Halfway through the next dump
+	world->AddConsoleOutputLine("players : 2 humans, 0 bots (24 max)");
+	world->AddConsoleOutputLine(R"(#      4 "Charlie"           [U:1:1003]          00:10       80    0 active)");
+	REQUIRE(listener.m_Leaves.empty());
+
+	// Changing servers forgets everyone at once, but they still leave first
+	world->AddConsoleOutputLine("Lobby created");
+	std::sort(listener.m_Leaves.begin(), listener.m_Leaves.end());
+	REQUIRE(listener.m_Leaves == std::vector<UserID_t>{ 2, 3, 4 });
+	REQUIRE(!world->FindPlayer(SteamID(1001, SteamAccountType::Individual, SteamAccountUniverse::Public)));
+}
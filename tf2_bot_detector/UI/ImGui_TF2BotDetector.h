@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Util/RowHeights.h"
+
 #include <imgui_desktop/ImGuiHelpers.h>
 #include <imgui_desktop/ScopeGuards.h>
 #include <imgui.h>
@@ -57,6 +59,38 @@ namespace ImGui
 			}, reinterpret_cast<const void*>(&func));
 	}
 
+	// Like ImGuiListClipper, but rows may have different heights (wrapped text, etc).
+	// Only the visible rows are drawn, and their measured heights are stored back into heights.
+	// heights must have one entry per row.
+	template<typename TDrawFunc>
+	void VariableHeightRows(tf2_bot_detector::RowHeights& heights, const TDrawFunc& drawRow)
+	{
+		heights.SetDefaultHeight(GetTextLineHeightWithSpacing());
+
+		const float startY = GetCursorPosY();
+		const float visibleBegin = GetScrollY() - startY;
+		const float visibleEnd = visibleBegin + GetWindowHeight();
+
+		size_t i = heights.FindRow(visibleBegin);
+		float y = startY + heights.GetTop(i);
+		SetCursorPosY(y);
+		for (; i < heights.size() && (y - startY) < visibleEnd; i++)
+		{
+			drawRow(i);
+
+			const float nextY = GetCursorPosY();
+			heights.SetHeight(i, nextY - y);
+			y = nextY;
+		}
+
+		// Reserve space for the rows we skipped so the scrollbar stays correct
+		if (i < heights.size())
+		{
+			SetCursorPosY(startY + heights.GetTotalHeight());
+			Dummy({ 0, 0 });
+		}
+	}
+
 	void TextRightAligned(const std::string_view& text, float offsetX = -1);
 	void TextRightAlignedF(const char* fmt, ...) IM_FMTARGS(1);
 
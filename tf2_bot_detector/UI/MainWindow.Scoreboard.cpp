@@ -4,7 +4,9 @@
 #include "UI/ImGui_TF2BotDetector.h"
 #include "BaseTextures.h"
 #include "IPlayer.h"
+#include "KillStats.h"
 #include "Networking/SteamAPI.h"
+#include "PlayerRequestScheduler.h"
 #include "TextureManager.h"
 
 #include <mh/math/interpolation.hpp>
@@ -140,7 +142,7 @@ void MainWindow::OnDrawScoreboard()
 				ImGui::Separator();
 			}
 
-			for (IPlayer& player : m_MainState->GeneratePlayerPrintData())
+			for (IPlayer& player : GetWorld().GetScoreboardPlayers())
 				OnDrawScoreboardRow(player);
 		}
 		//ImGui::EndChild();
@@ -171,6 +173,7 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 		buf.fmt("{}", player.GetUserID().value());
 
 	bool shouldDrawPlayerTooltip = false;
+	bool isRowVisible = false;
 
 	// Selectable
 	const auto teamShareResult = GetModLogic().GetTeamShareResult(player);
@@ -211,6 +214,7 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 		ImGui::Selectable(buf.c_str(), true, ImGuiSelectableFlags_SpanAllColumns);
 
 		shouldDrawPlayerTooltip = ImGui::IsItemHovered();
+		isRowVisible = ImGui::IsItemVisible();
 
 		ImGui::NextColumn();
 	}
@@ -368,6 +372,12 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 		else
 			ImGui::TextRightAlignedF("%u", player.GetPing());
 
+		if (const auto& history = player.GetOrCreateData<PlayerExtraData>(player).m_PingHistory; !history.empty())
+		{
+			ImGui::SetHoverTooltip("Average: {:1.0f}\nMin: {}\nMax: {}\nTrend: {:1.0f}",
+				history.GetMean(), history.GetMin(), history.GetMax(), history.GetEWMA());
+		}
+
 		ImGui::NextColumn();
 	}
 
@@ -382,6 +392,14 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 		ImGui::NextColumn();
 	}
 
+	// Done last, so anything requested while drawing this row gets the priority too
+	if (shouldDrawPlayerTooltip)
+		GetWorld().PrioritizeSteamAPIRequests(player.GetSteamID(), PlayerRequestPriority::Hovered);
+	else if (isRowVisible)
+		GetWorld().PrioritizeSteamAPIRequests(player.GetSteamID(), PlayerRequestPriority::Visible);
+	else if (playerAttribs)
+		GetWorld().PrioritizeSteamAPIRequests(player.GetSteamID(), PlayerRequestPriority::Marked);
+
 	if (shouldDrawPlayerTooltip)
 		OnDrawPlayerTooltip(player, teamShareResult, playerAttribs);
 }
@@ -687,6 +705,18 @@ void MainWindow::OnDrawPlayerTooltipBody(IPlayer& player, TeamShareResult teamSh
 		ImGui::TextFmt("  Their Thirst : {}%", int(deaths == 0 ? float(kills) * 100 : float(kills) / deaths * 100));
 	}
 
+	if (const PlayerKillStats* killStats = player.GetData<PlayerKillStats>())
+	{
+		const auto stats = killStats->GetSummary(player.GetWorld().GetCurrentTime());
+		ImGui::TextFmt("     Kills/min : {:1.1f} (best streak: {} in {}s)", stats.m_KillsPerMinute, stats.m_MaxBurst,
+			std::chrono::duration_cast<std::chrono::seconds>(PlayerKillStats::BURST_WINDOW).count());
+
+		if (stats.m_WindowKills > 0)
+			ImGui::TextFmt("    Crit Kills : {}%", int(stats.m_CritRatio * 100));
+		if (stats.m_HeadshotWeaponKills > 0)
+			ImGui::TextFmt("     Headshots : {}% of {}", int(stats.m_HeadshotRatio * 100), stats.m_HeadshotWeaponKills);
+	}
+
 	if (playerAttribs)
 	{
 		ImGui::NewLine();
@@ -10,6 +10,7 @@
 #include "BaseTextures.h"
 #include "Log.h"
 #include "IPlayer.h"
+#include "TaskScheduler.h"
 #include "TextureManager.h"
 #include "Util/PathUtils.h"
 #include "Version.h"
@@ -47,7 +48,7 @@ MainWindow::MainWindow() :
 
 	ILogManager::GetInstance().CleanupLogFiles();
 
-	GetWorld().AddConsoleLineListener(this);
+	GetWorld().AddConsoleLineListener(this);  // All line types: everything printable goes to the chat log
 	GetWorld().AddWorldEventListener(this);
 
 	DebugLog("Debug Info:"s
@@ -123,13 +124,23 @@ void MainWindow::OnDrawChat()
 
 			ImGui::PushTextWrapPos();
 
-			const IConsoleLine::PrintArgs args{ m_Settings };
-			for (auto it = m_MainState->m_PrintingLines.rbegin(); it != m_MainState->m_PrintingLines.rend(); ++it)
+			const auto& lines = m_MainState->m_PrintingLines;
+			auto& heights = m_MainState->m_PrintingLineHeights;
+			if (const float wrapWidth = ImGui::GetContentRegionAvail().x; wrapWidth != m_MainState->m_PrintingLinesWrapWidth)
 			{
-				assert(*it);
-				(*it)->Print(args);
+				heights.ResetHeights();
+				m_MainState->m_PrintingLinesWrapWidth = wrapWidth;
 			}
 
+			assert(heights.size() == lines.size());
+			const IConsoleLine::PrintArgs args{ m_Settings };
+			ImGui::VariableHeightRows(heights,
+				[&](size_t i)
+				{
+					assert(lines[i]);
+					lines[i]->Print(args);
+				});
+
 			ImGui::PopTextWrapPos();
 		});
 }
@@ -140,29 +151,39 @@ void MainWindow::OnDrawAppLog()
 		{
 			ImGui::PushTextWrapPos();
 
-			const void* lastLogMsg = nullptr;
-			for (const LogMessage& msg : ILogManager::GetInstance().GetVisibleMsgs())
+			if (const float wrapWidth = ImGui::GetContentRegionAvail().x; wrapWidth != m_AppLogWrapWidth)
 			{
-				const std::tm timestamp = ToTM(msg.m_Timestamp);
+				m_AppLogHeights.ResetHeights();
+				m_AppLogWrapWidth = wrapWidth;
+			}
 
-				ImGuiDesktop::ScopeGuards::ID id(&msg);
+			const auto msgs = ILogManager::GetInstance().GetVisibleMsgs();
+			m_AppLogHeights.Track(msgs.GetFirstIndex(), msgs.size());
 
-				ImGui::BeginGroup();
-				ImGui::TextColored({ 0.25f, 1.0f, 0.25f, 0.25f }, "[%02i:%02i:%02i]",
-					timestamp.tm_hour, timestamp.tm_min, timestamp.tm_sec);
+			ImGui::VariableHeightRows(m_AppLogHeights,
+				[&](size_t i)
+				{
+					const LogMessage& msg = msgs[i];
+					const std::tm timestamp = ToTM(msg.m_Timestamp);
 
-				ImGui::SameLine();
-				ImGui::TextFmt({ msg.m_Color.r, msg.m_Color.g, msg.m_Color.b, msg.m_Color.a }, msg.m_Text);
-				ImGui::EndGroup();
+					ImGuiDesktop::ScopeGuards::ID id(&msg);
 
-				if (auto scope = ImGui::BeginPopupContextItemScope("AppLogContextMenu"))
-				{
-					if (ImGui::MenuItem("Copy"))
-						ImGui::SetClipboardText(msg.m_Text.c_str());
-				}
+					ImGui::BeginGroup();
+					ImGui::TextColored({ 0.25f, 1.0f, 0.25f, 0.25f }, "[%02i:%02i:%02i]",
+						timestamp.tm_hour, timestamp.tm_min, timestamp.tm_sec);
 
-				lastLogMsg = &msg;
-			}
+					ImGui::SameLine();
+					ImGui::TextFmt({ msg.m_Color.r, msg.m_Color.g, msg.m_Color.b, msg.m_Color.a }, msg.m_Text);
+					ImGui::EndGroup();
+
+					if (auto scope = ImGui::BeginPopupContextItemScope("AppLogContextMenu"))
+					{
+						if (ImGui::MenuItem("Copy"))
+							ImGui::SetClipboardText(msg.m_Text.c_str());
+					}
+				});
+
+			const void* lastLogMsg = msgs.empty() ? nullptr : &msgs[msgs.size() - 1];
 
 			if (m_LastLogMessage != lastLogMsg)
 			{
@@ -555,30 +576,40 @@ void MainWindow::GenerateDebugReport()
 
 void MainWindow::OnDrawServerStats()
 {
+	const auto& edicts = m_EdictUsageSamples;
 	ImGui::PlotLines("Edicts", [&](int idx)
 		{
-			return m_EdictUsageSamples[idx].m_UsedEdicts;
-		}, (int)m_EdictUsageSamples.size(), 0, nullptr, 0, 2048);
+			return edicts[idx].m_Value;
+		}, (int)edicts.size(), 0, nullptr, 0, 2048);
 
-	if (!m_EdictUsageSamples.empty())
+	if (!edicts.empty() && m_MaxEdicts > 0)
 	{
 		ImGui::SameLine(0, 4);
 
-		auto& lastSample = m_EdictUsageSamples.back();
-		const float percent = float(lastSample.m_UsedEdicts) / lastSample.m_MaxEdicts;
+		const auto usedEdicts = edicts.back().m_Value;
+		const float percent = float(usedEdicts) / m_MaxEdicts;
 		ImGui::ProgressBar(percent, { -1, 0 },
-			mh::pfstr<64>("%i (%1.0f%%)", lastSample.m_UsedEdicts, percent * 100).c_str());
+			mh::pfstr<64>("%i (%1.0f%%)", usedEdicts, percent * 100).c_str());
 
-		ImGui::SetHoverTooltip("{} of {} ({:1.1f}%)", lastSample.m_UsedEdicts, lastSample.m_MaxEdicts, percent * 100);
+		ImGui::SetHoverTooltip("{} of {} ({:1.1f}%)\nPeak (5 minutes): {}", usedEdicts, m_MaxEdicts, percent * 100,
+			edicts.GetMax());
 	}
 
-	if (!m_ServerPingSamples.empty())
+	if (const auto& serverPing = m_ServerPingSamples.GetFine(); !serverPing.empty())
 	{
-		ImGui::PlotLines(mh::fmtstr<64>("Average ping: {}", m_ServerPingSamples.back().m_Ping).c_str(),
+		ImGui::PlotLines(mh::fmtstr<64>("Average ping: {}", serverPing.back().m_Value).c_str(),
 			[&](int idx)
 			{
-				return m_ServerPingSamples[idx].m_Ping;
-			}, (int)m_ServerPingSamples.size(), 0, nullptr, 0);
+				return serverPing[idx].m_Value;
+			}, (int)serverPing.size(), 0, nullptr, 0);
+
+		if (const auto& history = m_ServerPingSamples.GetCoarse(); !history.empty())
+		{
+			ImGui::SetHoverTooltip("Last 5 minutes: {} - {}\nLast {} minutes: {:1.0f} - {:1.0f}",
+				serverPing.GetMin(), serverPing.GetMax(),
+				std::chrono::duration_cast<std::chrono::minutes>(history.back().m_Timestamp - history.front().m_Timestamp).count() + 1,
+				history.GetMin(), history.GetMax());
+		}
 	}
 
 	//OnDrawNetGraph();
@@ -651,6 +682,13 @@ void MainWindow::OnDraw()
 		ImGui::TextFmt("FPS: {:1.1f}", GetFPS());
 
 		ImGui::Value("Texture Count", m_TextureManager->GetActiveTextureCount());
+
+		const auto tasks = TaskScheduler::Get().GetStats();
+		ImGui::TextFmt("Tasks (UI/network/IO): {}/{}/{} queued, {}/{}/{} running on {} threads",
+			tasks.m_Queued[0], tasks.m_Queued[1], tasks.m_Queued[2],
+			tasks.m_Running[0], tasks.m_Running[1], tasks.m_Running[2], tasks.m_ThreadCount);
+		ImGui::TextFmt("Tasks: {} completed, {} stolen, {} continuations waiting, peak queue depth {}",
+			tasks.m_Completed, tasks.m_Stolen, tasks.m_WaitingContinuations, tasks.m_PeakQueued);
 	}
 #endif
 
@@ -848,6 +886,16 @@ void MainWindow::HandleUpdateCheck()
 	}
 }
 
+void MainWindow::PostSetupFlowState::AddPrintingLine(std::shared_ptr<const IConsoleLine> line)
+{
+	// Keep the heights lined up with the ring buffer, which is about to drop its oldest line
+	if (m_PrintingLines.full())
+		m_PrintingLineHeights.pop_front();
+
+	m_PrintingLines.push_back(std::move(line));
+	m_PrintingLineHeights.push_back();
+}
+
 void MainWindow::PostSetupFlowState::OnUpdateDiscord()
 {
 #ifdef TF2BD_ENABLE_DISCORD_INTEGRATION
@@ -928,10 +976,7 @@ void MainWindow::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 
 	if (parsed.ShouldPrint() && m_MainState)
 	{
-		while (m_MainState->m_PrintingLines.size() > m_MainState->MAX_PRINTING_LINES)
-			m_MainState->m_PrintingLines.pop_back();
-
-		m_MainState->m_PrintingLines.push_front(parsed.shared_from_this());
+		m_MainState->AddPrintingLine(parsed.shared_from_this());
 	}
 
 	switch (parsed.GetType())
@@ -949,10 +994,8 @@ void MainWindow::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 	case ConsoleLineType::EdictUsage:
 	{
 		auto& usageLine = static_cast<const EdictUsageLine&>(parsed);
-		m_EdictUsageSamples.push_back({ usageLine.GetTimestamp(), usageLine.GetUsedEdicts(), usageLine.GetTotalEdicts() });
-
-		while (m_EdictUsageSamples.front().m_Timestamp < (usageLine.GetTimestamp() - 5min))
-			m_EdictUsageSamples.erase(m_EdictUsageSamples.begin());
+		m_EdictUsageSamples.push_back(usageLine.GetTimestamp(), usageLine.GetUsedEdicts());
+		m_MaxEdicts = usageLine.GetTotalEdicts();
 
 		break;
 	}
@@ -964,102 +1007,30 @@ void MainWindow::OnConsoleLineUnparsed(IWorldState& world, const std::string_vie
 	m_ParsedLineCount++;
 }
 
-cppcoro::generator<IPlayer&> MainWindow::PostSetupFlowState::GeneratePlayerPrintData()
-{
-	IPlayer* printData[33]{};
-	auto begin = std::begin(printData);
-	auto end = std::end(printData);
-	assert(begin <= end);
-	auto& world = m_Parent->m_WorldState;
-	assert(static_cast<size_t>(end - begin) >= world->GetApproxLobbyMemberCount());
-
-	std::fill(begin, end, nullptr);
-
-	{
-		auto* current = begin;
-		for (IPlayer& member : world->GetLobbyMembers())
-		{
-			*current = &member;
-			current++;
-		}
-
-		if (current == begin)
-		{
-			// We seem to have either an empty lobby or we're playing on a community server.
-			// Just find the most recent status updates.
-			for (IPlayer& playerData : world->GetPlayers())
-			{
-				if (playerData.GetLastStatusUpdateTime() >= (world->GetLastStatusUpdateTime() - 15s))
-				{
-					*current = &playerData;
-					current++;
-
-					if (current >= end)
-						break; // This might happen, but we're not in a lobby so everything has to be approximate
-				}
-			}
-		}
-
-		end = current;
-	}
-
-	std::sort(begin, end, [](const IPlayer* lhs, const IPlayer* rhs) -> bool
-		{
-			assert(lhs);
-			assert(rhs);
-			//if (!lhs && !rhs)
-			//	return false;
-			//if (auto result = !!rhs <=> !!lhs; !std::is_eq(result))
-			//	return result < 0;
-
-			// Intentionally reversed, we want descending kill order
-			if (auto killsResult = rhs->GetScores().m_Kills <=> lhs->GetScores().m_Kills; !std::is_eq(killsResult))
-				return std::is_lt(killsResult);
-
-			if (auto deathsResult = lhs->GetScores().m_Deaths <=> rhs->GetScores().m_Deaths; !std::is_eq(deathsResult))
-				return std::is_lt(deathsResult);
-
-			// Sort by ascending userid
-			{
-				auto luid = lhs->GetUserID();
-				auto ruid = rhs->GetUserID();
-				if (luid && ruid)
-				{
-					if (auto result = *luid <=> *ruid; !std::is_eq(result))
-						return std::is_lt(result);
-				}
-			}
-
-			return false;
-		});
-
-	for (auto it = begin; it != end; ++it)
-		co_yield **it;
-}
-
 void MainWindow::UpdateServerPing(time_point_t timestamp)
 {
-	if ((timestamp - m_LastServerPingSample) <= 7s)
-		return;
+	const bool takeServerSample = (timestamp - m_LastServerPingSample) > 7s;
 
 	float totalPing = 0;
 	uint16_t samples = 0;
 
 	for (IPlayer& player : GetWorld().GetPlayers())
 	{
-		if (player.GetLastStatusUpdateTime() < (timestamp - 20s))
+		auto& data = player.GetOrCreateData<PlayerExtraData>(player);
+		data.UpdatePingHistory();
+
+		if (!takeServerSample || player.GetLastStatusUpdateTime() < (timestamp - 20s))
 			continue;
 
-		auto& data = player.GetOrCreateData<PlayerExtraData>(player);
 		totalPing += data.GetAveragePing();
 		samples++;
 	}
 
-	m_ServerPingSamples.push_back({ timestamp, uint16_t(totalPing / samples) });
-	m_LastServerPingSample = timestamp;
+	if (!takeServerSample || samples == 0)
+		return;
 
-	while ((timestamp - m_ServerPingSamples.front().m_Timestamp) > 5min)
-		m_ServerPingSamples.erase(m_ServerPingSamples.begin());
+	m_ServerPingSamples.push_back(timestamp, uint16_t(totalPing / samples));
+	m_LastServerPingSample = timestamp;
 }
 
 time_point_t MainWindow::GetLastStatusUpdateTime() const
@@ -1069,19 +1040,20 @@ time_point_t MainWindow::GetLastStatusUpdateTime() const
 
 float MainWindow::PlayerExtraData::GetAveragePing() const
 {
-	//throw std::runtime_error("TODO");
-#if 1
-	unsigned totalPing = m_Parent->GetPing();
-	unsigned samples = 1;
+	if (m_PingHistory.empty())
+		return m_Parent->GetPing();
 
-	for (const auto& entry : m_PingHistory)
-	{
-		totalPing += entry.m_Ping;
-		samples++;
-	}
+	return float(m_PingHistory.GetMean());
+}
 
-	return totalPing / float(samples);
-#endif
+void MainWindow::PlayerExtraData::UpdatePingHistory()
+{
+	const auto statusTime = m_Parent->GetLastStatusUpdateTime();
+	if (statusTime <= m_LastPingUpdateTime)
+		return;
+
+	m_PingHistory.push_back(statusTime, m_Parent->GetPing());
+	m_LastPingUpdateTime = statusTime;
 }
 
 time_point_t MainWindow::GetCurrentTimestampCompensated() const
@@ -1129,7 +1101,9 @@ std::shared_ptr<ITexture> MainWindow::TryGetAvatarTexture(IPlayer& player)
 
 MainWindow::PostSetupFlowState::PostSetupFlowState(MainWindow& window) :
 	m_Parent(&window),
-	m_ModeratorLogic(IModeratorLogic::Create(window.GetWorld(), window.m_Settings, window.GetActionManager())),
+	m_SessionJournal(ISessionJournalWriter::Create(window.GetWorld())),
+	m_ModeratorLogic(IModeratorLogic::Create(window.GetWorld(), window.m_Settings, window.GetActionManager(),
+		m_SessionJournal.get())),
 	m_SponsorsList(window.m_Settings),
 	m_Parser(window.GetWorld(), window.m_Settings, window.m_Settings.GetTFDir() / "console.log")
 {
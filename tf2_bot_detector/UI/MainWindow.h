@@ -6,6 +6,7 @@
 #include "CompensatedTS.h"
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLog/ConsoleLogParser.h"
+#include "ConsoleLog/SessionJournal.h"
 #include "Config/PlayerListJSON.h"
 #include "Config/Settings.h"
 #include "Config/SponsorsList.h"
@@ -18,6 +19,9 @@
 #include "LobbyMember.h"
 #include "PlayerStatus.h"
 #include "TFConstants.h"
+#include "Util/RingBuffer.h"
+#include "Util/RowHeights.h"
+#include "Util/TimeSeries.h"
 
 #include <imgui_desktop/Window.h>
 
@@ -63,6 +67,8 @@ namespace tf2_bot_detector
 
 		void OnDrawAppLog();
 		const void* m_LastLogMessage = nullptr;
+		RowHeights m_AppLogHeights;
+		float m_AppLogWrapWidth = 0;
 
 		void OnDrawSettingsPopup();
 		bool m_SettingsPopupOpen = false;
@@ -113,17 +119,6 @@ namespace tf2_bot_detector
 		std::unique_ptr<ITextureManager> m_TextureManager;
 		std::unique_ptr<IBaseTextures> m_BaseTextures;
 
-		struct PingSample
-		{
-			constexpr PingSample(time_point_t timestamp, uint16_t ping) :
-				m_Timestamp(timestamp), m_Ping(ping)
-			{
-			}
-
-			time_point_t m_Timestamp{};
-			uint16_t m_Ping{};
-		};
-
 		struct PlayerExtraData final
 		{
 			PlayerExtraData(const IPlayer& player) : m_Parent(&player) {}
@@ -131,22 +126,18 @@ namespace tf2_bot_detector
 			const IPlayer* m_Parent = nullptr;
 
 			time_point_t m_LastPingUpdateTime{};
-			std::vector<PingSample> m_PingHistory{};
+			TimeSeries<uint16_t, 64> m_PingHistory{ std::chrono::minutes(5) };
 			float GetAveragePing() const;
+			void UpdatePingHistory();
 		};
 
-		struct EdictUsageSample
-		{
-			time_point_t m_Timestamp;
-			uint16_t m_UsedEdicts;
-			uint16_t m_MaxEdicts;
-		};
-		std::vector<EdictUsageSample> m_EdictUsageSamples;
+		TimeSeries<uint16_t, 256> m_EdictUsageSamples{ std::chrono::minutes(5) };
+		uint16_t m_MaxEdicts = 0;
 
 		time_point_t m_OpenTime;
 
 		void UpdateServerPing(time_point_t timestamp);
-		std::vector<PingSample> m_ServerPingSamples;
+		MultiResolutionTimeSeries<uint16_t, 64, 128> m_ServerPingSamples{ std::chrono::minutes(5), std::chrono::minutes(1) };
 		time_point_t m_LastServerPingSample{};
 
 		Settings m_Settings;
@@ -165,13 +156,18 @@ namespace tf2_bot_detector
 			PostSetupFlowState(MainWindow& window);
 
 			MainWindow* m_Parent = nullptr;
+			std::unique_ptr<ISessionJournalWriter> m_SessionJournal;
 			std::unique_ptr<IModeratorLogic> m_ModeratorLogic;
 			SponsorsList m_SponsorsList;
 
 			ConsoleLogParser m_Parser;
-			std::list<std::shared_ptr<const IConsoleLine>> m_PrintingLines;  // newest to oldest order
-			static constexpr size_t MAX_PRINTING_LINES = 512;
-			cppcoro::generator<IPlayer&> GeneratePlayerPrintData();
+
+			static constexpr size_t MAX_PRINTING_LINES = 32768;
+			RingBuffer<std::shared_ptr<const IConsoleLine>> m_PrintingLines{ MAX_PRINTING_LINES };  // oldest to newest order
+			RowHeights m_PrintingLineHeights;  // One per line in m_PrintingLines, at m_PrintingLinesWrapWidth
+			float m_PrintingLinesWrapWidth = 0;
+
+			void AddPrintingLine(std::shared_ptr<const IConsoleLine> line);
 
 			void OnUpdateDiscord();
 #ifdef TF2BD_ENABLE_DISCORD_INTEGRATION
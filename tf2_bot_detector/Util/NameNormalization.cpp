@@ -0,0 +1,203 @@
+#include "NameNormalization.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct Homoglyph
+	{
+		char32_t m_From;
+		char m_To;
+
+		constexpr bool operator<(const Homoglyph& other) const { return m_From < other.m_From; }
+	};
+
+	// Sorted by m_From
+	constexpr Homoglyph HOMOGLYPHS[] =
+	{
+		// Latin
+		{ 0x0131, 'i' }, { 0x01C0, 'l' }, { 0x0251, 'a' }, { 0x0261, 'g' },
+
+		// Greek
+		{ 0x0391, 'a' }, { 0x0392, 'b' }, { 0x0395, 'e' }, { 0x0396, 'z' }, { 0x0397, 'h' },
+		{ 0x0399, 'l' }, { 0x039A, 'k' }, { 0x039C, 'm' }, { 0x039D, 'n' }, { 0x039F, 'o' },
+		{ 0x03A1, 'p' }, { 0x03A4, 't' }, { 0x03A5, 'y' }, { 0x03A7, 'x' }, { 0x03B1, 'a' },
+		{ 0x03B9, 'i' }, { 0x03BA, 'k' }, { 0x03BD, 'v' }, { 0x03BF, 'o' }, { 0x03C1, 'p' },
+		{ 0x03C5, 'u' },
+
+		// Cyrillic
+		{ 0x0405, 's' }, { 0x0406, 'l' }, { 0x0408, 'j' }, { 0x0410, 'a' }, { 0x0412, 'b' },
+		{ 0x0415, 'e' }, { 0x041A, 'k' }, { 0x041C, 'm' }, { 0x041D, 'h' }, { 0x041E, 'o' },
+		{ 0x0420, 'p' }, { 0x0421, 'c' }, { 0x0422, 't' }, { 0x0425, 'x' }, { 0x0430, 'a' },
+		{ 0x0435, 'e' }, { 0x043E, 'o' }, { 0x0440, 'p' }, { 0x0441, 'c' }, { 0x0443, 'y' },
+		{ 0x0445, 'x' }, { 0x0455, 's' }, { 0x0456, 'i' }, { 0x0458, 'j' }, { 0x04BB, 'h' },
+		{ 0x04C0, 'l' }, { 0x04CF, 'l' }, { 0x0501, 'd' }, { 0x051B, 'q' }, { 0x051D, 'w' },
+	};
+	static_assert(std::is_sorted(std::begin(HOMOGLYPHS), std::end(HOMOGLYPHS)));
+
+	bool IsInvisible(char32_t cp)
+	{
+		return cp < 0x20 ||
+			(cp >= 0x7F && cp <= 0x9F) ||
+			cp == 0xAD ||                     // Soft hyphen
+			(cp >= 0x300 && cp <= 0x36F) ||   // Combining diacritical marks
+			cp == 0x34F ||
+			cp == 0x61C ||
+			(cp >= 0x115F && cp <= 0x1160) || // Hangul fillers
+			(cp >= 0x17B4 && cp <= 0x17B5) ||
+			(cp >= 0x180B && cp <= 0x180E) ||
+			(cp >= 0x200B && cp <= 0x200F) || // Zero width space/joiners, direction marks
+			(cp >= 0x202A && cp <= 0x202E) || // Direction embedding/overrides
+			(cp >= 0x2060 && cp <= 0x206F) || // Word joiner, invisible operators
+			cp == 0x3164 ||                   // Hangul filler
+			(cp >= 0xFE00 && cp <= 0xFE0F) || // Variation selectors
+			cp == 0xFEFF ||                   // Zero width no-break space
+			cp == 0xFFA0 ||                   // Halfwidth hangul filler
+			(cp >= 0x1D173 && cp <= 0x1D17A) ||
+			(cp >= 0xE0000 && cp <= 0xE0FFF); // Tags, variation selectors supplement
+	}
+
+	bool IsWhitespace(char32_t cp)
+	{
+		return cp == ' ' || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) ||
+			cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000;
+	}
+
+	// Returns 0 if there is no ASCII lookalike
+	char FoldToASCII(char32_t cp)
+	{
+		if (cp < 0x80)
+			return char(cp);
+
+		if (cp >= 0xFF01 && cp <= 0xFF5E) // Full-width ASCII
+			return char(cp - 0xFEE0);
+
+		if (cp >= 0x1D400 && cp <= 0x1D6A3) // Mathematical alphanumeric letters, 52 per style
+		{
+			const auto index = (cp - 0x1D400) % 52;
+			return char(index < 26 ? ('A' + index) : ('a' + index - 26));
+		}
+		if (cp >= 0x1D7CE && cp <= 0x1D7FF) // Mathematical digits, 10 per style
+			return char('0' + (cp - 0x1D7CE) % 10);
+
+		const auto found = std::lower_bound(std::begin(HOMOGLYPHS), std::end(HOMOGLYPHS), Homoglyph{ cp, 0 });
+		if (found != std::end(HOMOGLYPHS) && found->m_From == cp)
+			return found->m_To;
+
+		return 0;
+	}
+
+	char FoldCase(char c)
+	{
+		switch (c)
+		{
+		case 'I':
+		case '1':
+		case '|':
+			return 'l';
+		case '0':
+			return 'o';
+		default:
+			return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+		}
+	}
+
+	constexpr char32_t INVALID_CODEPOINT = 0xFFFFFFFF;
+
+	// Invalid sequences decode one byte at a time, as INVALID_CODEPOINT
+	char32_t DecodeUTF8(const std::string_view& str, size_t& pos)
+	{
+		const auto lead = uint8_t(str[pos]);
+		size_t length;
+		char32_t cp;
+		if (lead < 0x80)
+		{
+			pos++;
+			return lead;
+		}
+		else if ((lead & 0xE0) == 0xC0)
+		{
+			length = 2;
+			cp = lead & 0x1F;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			length = 3;
+			cp = lead & 0x0F;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			length = 4;
+			cp = lead & 0x07;
+		}
+		else
+		{
+			pos++;
+			return INVALID_CODEPOINT;
+		}
+
+		if (pos + length > str.size())
+		{
+			pos++;
+			return INVALID_CODEPOINT;
+		}
+
+		for (size_t i = 1; i < length; i++)
+		{
+			const auto cont = uint8_t(str[pos + i]);
+			if ((cont & 0xC0) != 0x80)
+			{
+				pos++;
+				return INVALID_CODEPOINT;
+			}
+
+			cp = (cp << 6) | (cont & 0x3F);
+		}
+
+		pos += length;
+		return cp;
+	}
+}
+
+std::string tf2_bot_detector::NormalizePlayerName(const std::string_view& name)
+{
+	std::string retVal;
+	NormalizePlayerName(name, retVal);
+	return retVal;
+}
+
+void tf2_bot_detector::NormalizePlayerName(const std::string_view& name, std::string& output)
+{
+	output.clear();
+	output.reserve(name.size());
+
+	bool pendingSpace = false;
+	for (size_t pos = 0; pos < name.size(); )
+	{
+		const size_t start = pos;
+		const char32_t cp = DecodeUTF8(name, pos);
+
+		if (IsWhitespace(cp))
+		{
+			pendingSpace = !output.empty();
+			continue;
+		}
+		if (IsInvisible(cp))
+			continue;
+
+		if (pendingSpace)
+		{
+			output += ' ';
+			pendingSpace = false;
+		}
+
+		if (const char folded = FoldToASCII(cp))
+			output += FoldCase(folded);
+		else
+			output.append(name.substr(start, pos - start));
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// Reduces a player name to a "skeleton" that looks the same on the scoreboard as the original:
+	//  - invisible, zero-width, control and combining characters are removed
+	//  - runs of (unicode) whitespace become a single space, and leading/trailing whitespace is trimmed
+	//  - common homoglyphs (cyrillic/greek lookalikes, full-width and mathematical letters) are folded to ASCII
+	//  - ASCII is case folded, with I/l/1/| and O/0 treated as the same character
+	// Two names with the same skeleton are (visually) impersonating each other.
+	std::string NormalizePlayerName(const std::string_view& name);
+	void NormalizePlayerName(const std::string_view& name, std::string& output);
+}
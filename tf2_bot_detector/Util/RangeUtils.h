@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Non-owning view over a contiguous array of T*, iterated as T&.
+	// Cheap replacement for a cppcoro::generator<T&> that just walks a container.
+	template<typename T>
+	class DerefRange final
+	{
+		using pointer_type = std::remove_const_t<T>*;
+
+	public:
+		class iterator final
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = std::remove_const_t<T>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
+
+			constexpr iterator() = default;
+			constexpr explicit iterator(const pointer_type* ptr) : m_Ptr(ptr) {}
+
+			constexpr T& operator*() const { return **m_Ptr; }
+			constexpr T* operator->() const { return *m_Ptr; }
+			constexpr T& operator[](difference_type i) const { return *m_Ptr[i]; }
+
+			constexpr iterator& operator++() { ++m_Ptr; return *this; }
+			constexpr iterator operator++(int) { auto retVal = *this; ++m_Ptr; return retVal; }
+			constexpr iterator& operator--() { --m_Ptr; return *this; }
+			constexpr iterator operator--(int) { auto retVal = *this; --m_Ptr; return retVal; }
+			constexpr iterator& operator+=(difference_type i) { m_Ptr += i; return *this; }
+			constexpr iterator& operator-=(difference_type i) { m_Ptr -= i; return *this; }
+			constexpr iterator operator+(difference_type i) const { return iterator(m_Ptr + i); }
+			constexpr iterator operator-(difference_type i) const { return iterator(m_Ptr - i); }
+			constexpr difference_type operator-(const iterator& other) const { return m_Ptr - other.m_Ptr; }
+
+			constexpr auto operator<=>(const iterator&) const = default;
+
+		private:
+			const pointer_type* m_Ptr = nullptr;
+		};
+
+		constexpr DerefRange() = default;
+		constexpr DerefRange(const pointer_type* begin, const pointer_type* end) : m_Begin(begin), m_End(end) {}
+		DerefRange(const std::vector<pointer_type>& vec) : DerefRange(vec.data(), vec.data() + vec.size()) {}
+
+		// Allow DerefRange<X> -> DerefRange<const X>
+		template<typename T2, typename = std::enable_if_t<std::is_same_v<const T2, T> && !std::is_const_v<T2>>>
+		constexpr DerefRange(const DerefRange<T2>& other) : m_Begin(other.data()), m_End(other.data() + other.size()) {}
+
+		constexpr iterator begin() const { return iterator(m_Begin); }
+		constexpr iterator end() const { return iterator(m_End); }
+		constexpr size_t size() const { return m_End - m_Begin; }
+		constexpr bool empty() const { return m_Begin == m_End; }
+		constexpr T& operator[](size_t i) const { return *m_Begin[i]; }
+		constexpr const pointer_type* data() const { return m_Begin; }
+
+	private:
+		const pointer_type* m_Begin = nullptr;
+		const pointer_type* m_End = nullptr;
+	};
+}
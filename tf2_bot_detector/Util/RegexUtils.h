@@ -24,10 +24,9 @@ namespace tf2_bot_detector
 		return mh::from_chars(to_string_view(match), out);
 	}
 
-	template<typename TIter, typename T, typename... TArgs>
-	inline void from_chars_throw(const std::sub_match<TIter>& match, T& out, TArgs&&... args)
+	template<typename T, typename... TArgs>
+	inline void from_chars_throw(const std::string_view& sv, T& out, TArgs&&... args)
 	{
-		const auto sv = to_string_view(match);
 		auto result = mh::from_chars(sv, out, std::forward<TArgs>(args)...);
 		if (!result)
 		{
@@ -35,4 +34,10 @@ namespace tf2_bot_detector
 			throw std::runtime_error("Failed to parse "s << std::quoted(sv) << " as " << typeid(T).name());
 		}
 	}
+
+	template<typename TIter, typename T, typename... TArgs>
+	inline void from_chars_throw(const std::sub_match<TIter>& match, T& out, TArgs&&... args)
+	{
+		from_chars_throw(to_string_view(match), out, std::forward<TArgs>(args)...);
+	}
 }
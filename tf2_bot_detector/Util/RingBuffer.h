@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Contiguous, fixed-capacity FIFO. Once full, pushing a new item overwrites the oldest one.
+	template<typename T>
+	class RingBuffer final
+	{
+	public:
+		explicit RingBuffer(size_t capacity) : m_Items(capacity)
+		{
+			assert(capacity > 0);
+		}
+
+		size_t capacity() const { return m_Items.size(); }
+		size_t size() const { return m_Size; }
+		bool empty() const { return m_Size == 0; }
+		bool full() const { return m_Size == capacity(); }
+
+		// 0 is the oldest item
+		T& operator[](size_t index) { assert(index < m_Size); return m_Items[(m_Begin + index) % capacity()]; }
+		const T& operator[](size_t index) const { assert(index < m_Size); return m_Items[(m_Begin + index) % capacity()]; }
+		T& front() { return (*this)[0]; }
+		const T& front() const { return (*this)[0]; }
+		T& back() { return (*this)[m_Size - 1]; }
+		const T& back() const { return (*this)[m_Size - 1]; }
+
+		T& push_back(T value)
+		{
+			T* slot;
+			if (full())
+			{
+				slot = &m_Items[m_Begin];
+				m_Begin = (m_Begin + 1) % capacity();
+			}
+			else
+			{
+				slot = &m_Items[(m_Begin + m_Size) % capacity()];
+				m_Size++;
+			}
+
+			*slot = std::move(value);
+			return *slot;
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < m_Size; i++)
+				(*this)[i] = T{};
+
+			m_Begin = m_Size = 0;
+		}
+
+	private:
+		std::vector<T> m_Items;
+		size_t m_Begin = 0;
+		size_t m_Size = 0;
+	};
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+
+namespace tf2_bot_detector
+{
+	// Heights of a list of rows that grows at the back and drops rows from the front (a log),
+	// plus the running total of those heights, so finding the row at a given scroll offset is a
+	// binary search instead of adding up every row above it. Rows that haven't been measured yet
+	// count as the default height.
+	class RowHeights final
+	{
+	public:
+		size_t size() const { return m_Heights.size(); }
+		bool empty() const { return m_Heights.empty(); }
+
+		// Index of the first row ever pushed that is still here
+		size_t GetFirstIndex() const { return m_FirstIndex; }
+
+		void push_back(float height = 0)
+		{
+			const bool upToDate = (m_FirstDirty == size());
+			const double top = m_Bottoms.empty() ? m_Evicted : m_Bottoms.back();
+			m_Heights.push_back(height);
+			m_Bottoms.push_back(top + GetHeight(size() - 1));
+			if (upToDate)
+				m_FirstDirty = size();
+		}
+
+		void pop_front(size_t count = 1)
+		{
+			assert(count <= size());
+			count = std::min(count, size());
+			if (count == 0)
+				return;
+
+			UpdateBottoms();
+			m_Evicted = m_Bottoms[count - 1];
+			m_Heights.erase(m_Heights.begin(), m_Heights.begin() + count);
+			m_Bottoms.erase(m_Bottoms.begin(), m_Bottoms.begin() + count);
+			m_FirstIndex += count;
+			m_FirstDirty -= std::min(m_FirstDirty, count);
+		}
+
+		void clear()
+		{
+			m_FirstIndex += size();
+			m_Heights.clear();
+			m_Bottoms.clear();
+			m_Evicted = 0;
+			m_FirstDirty = 0;
+		}
+
+		// Follows a list that only ever appends and drops from the front, given the index of its
+		// current first row (counting every row it ever had) and its current size
+		void Track(size_t firstIndex, size_t count)
+		{
+			if (firstIndex < m_FirstIndex || firstIndex > (m_FirstIndex + size()))
+			{
+				clear();
+				m_FirstIndex = firstIndex;
+			}
+			else
+			{
+				pop_front(firstIndex - m_FirstIndex);
+			}
+
+			if (count < size())
+			{
+				// Shrunk without dropping from the front, so we can't tell which rows are still ours
+				clear();
+				m_FirstIndex = firstIndex;
+			}
+
+			while (size() < count)
+				push_back();
+		}
+
+		float GetDefaultHeight() const { return m_DefaultHeight; }
+		void SetDefaultHeight(float height)
+		{
+			if (height != m_DefaultHeight)
+			{
+				m_DefaultHeight = height;
+				m_FirstDirty = 0;
+			}
+		}
+
+		float GetHeight(size_t index) const
+		{
+			const float height = m_Heights[index];
+			return height > 0 ? height : m_DefaultHeight;
+		}
+		void SetHeight(size_t index, float height)
+		{
+			float& current = m_Heights[index];
+			if (current != height)
+			{
+				current = height;
+				m_FirstDirty = std::min(m_FirstDirty, index);
+			}
+		}
+
+		// Forget every measurement, for when they were taken at a different wrap width
+		void ResetHeights()
+		{
+			std::fill(m_Heights.begin(), m_Heights.end(), 0.0f);
+			m_FirstDirty = 0;
+		}
+
+		// Offset of the top of the row from the top of the first row. index may be size().
+		float GetTop(size_t index)
+		{
+			assert(index <= size());
+			if (index == 0)
+				return 0;
+
+			UpdateBottoms();
+			return float(m_Bottoms[index - 1] - m_Evicted);
+		}
+		float GetTotalHeight() { return GetTop(size()); }
+
+		// First row that ends below the given offset, or size() if there are none
+		size_t FindRow(float offset)
+		{
+			UpdateBottoms();
+			const double target = m_Evicted + offset;
+			return size_t(std::upper_bound(m_Bottoms.begin(), m_Bottoms.end(), target) - m_Bottoms.begin());
+		}
+
+	private:
+		// Rows only get re-measured as they are drawn and the results rarely change, so
+		// the running totals are brought up to date (from the first changed row) lazily
+		void UpdateBottoms()
+		{
+			if (m_FirstDirty >= size())
+				return;
+
+			double bottom = (m_FirstDirty > 0) ? m_Bottoms[m_FirstDirty - 1] : m_Evicted;
+			for (size_t i = m_FirstDirty; i < size(); i++)
+			{
+				bottom += GetHeight(i);
+				m_Bottoms[i] = bottom;
+			}
+
+			m_FirstDirty = size();
+		}
+
+		std::deque<float> m_Heights;   // 0 if not measured yet
+		std::deque<double> m_Bottoms;  // Total height of every row ever pushed, up to and including this one
+		double m_Evicted = 0;          // Total height of every row that was popped
+		size_t m_FirstDirty = 0;       // Rows from here on have stale m_Bottoms
+		size_t m_FirstIndex = 0;
+		float m_DefaultHeight = 0;
+	};
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// Character classes matching std::regex's ECMAScript \d, \s, \w and . for char
+	// in the "C" locale, so hand-written matchers stay drop-in replacements for
+	// the patterns they were written from.
+	constexpr bool IsDigitChar(char c) { return c >= '0' && c <= '9'; }
+	constexpr bool IsSpaceChar(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+	}
+	constexpr bool IsWordChar(char c)
+	{
+		return IsDigitChar(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+	constexpr bool IsLineChar(char c) { return c != '\n' && c != '\r'; }
+	constexpr bool IsHexDigitChar(char c)
+	{
+		return IsDigitChar(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+	}
+
+	// Forward-only cursor over a string_view. Every "token" function is greedy,
+	// consumes nothing and returns an empty view on failure, and otherwise returns
+	// a view into the original text, so matchers built on it never allocate.
+	class TextScanner final
+	{
+	public:
+		constexpr explicit TextScanner(std::string_view text) : m_Text(text) {}
+
+		constexpr size_t GetPosition() const { return m_Pos; }
+		constexpr std::string_view GetRemaining() const { return m_Text.substr(m_Pos); }
+		constexpr bool IsAtEnd() const { return m_Pos == m_Text.size(); }
+
+		constexpr bool Literal(std::string_view literal)
+		{
+			if (m_Text.substr(m_Pos, literal.size()) != literal)
+				return false;
+
+			m_Pos += literal.size();
+			return true;
+		}
+		constexpr bool Char(char c)
+		{
+			if (m_Pos >= m_Text.size() || m_Text[m_Pos] != c)
+				return false;
+
+			m_Pos++;
+			return true;
+		}
+
+		// c+
+		constexpr std::string_view Repeat(char c) { return While([c](char x) { return x == c; }); }
+
+		// \d+
+		constexpr std::string_view Digits() { return While(IsDigitChar); }
+		// \s+
+		constexpr std::string_view Spaces() { return While(IsSpaceChar); }
+		// \w+
+		constexpr std::string_view Word() { return While(IsWordChar); }
+		// \S+
+		constexpr std::string_view NonSpaces() { return While([](char c) { return !IsSpaceChar(c); }); }
+
+		// \d+\.\d+, or \d+\.\d{fractionDigits} if fractionDigits is nonzero
+		constexpr std::string_view Decimal(size_t fractionDigits = 0)
+		{
+			const size_t start = m_Pos;
+			if (Digits().empty() || !Char('.'))
+				return Reset(start);
+
+			if (fractionDigits == 0)
+			{
+				if (Digits().empty())
+					return Reset(start);
+			}
+			else
+			{
+				for (size_t i = 0; i < fractionDigits; i++)
+				{
+					if (m_Pos >= m_Text.size() || !IsDigitChar(m_Text[m_Pos]))
+						return Reset(start);
+
+					m_Pos++;
+				}
+			}
+
+			return m_Text.substr(start, m_Pos - start);
+		}
+
+		// .{count}
+		constexpr std::string_view LineChars(size_t count)
+		{
+			if (m_Text.size() - m_Pos < count)
+				return {};
+
+			for (size_t i = 0; i < count; i++)
+			{
+				if (!IsLineChar(m_Text[m_Pos + i]))
+					return {};
+			}
+
+			const auto retVal = m_Text.substr(m_Pos, count);
+			m_Pos += count;
+			return retVal;
+		}
+
+		template<typename TPredicate>
+		constexpr std::string_view While(TPredicate&& pred)
+		{
+			const size_t start = m_Pos;
+			while (m_Pos < m_Text.size() && pred(m_Text[m_Pos]))
+				m_Pos++;
+
+			return m_Text.substr(start, m_Pos - start);
+		}
+
+	private:
+		constexpr std::string_view Reset(size_t pos)
+		{
+			m_Pos = pos;
+			return {};
+		}
+
+		std::string_view m_Text;
+		size_t m_Pos = 0;
+	};
+}
@@ -7,16 +7,251 @@
 #include <mh/text/fmtstr.hpp>
 #include <mh/text/string_insertion.hpp>
 
+#include <algorithm>
 #include <codecvt>
+#include <cstdint>
 #include <fstream>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define TF2BD_TEXTUTILS_SSE2 1
+#include <emmintrin.h>
+#else
+#define TF2BD_TEXTUTILS_SSE2 0
+#endif
 
 using namespace std::string_literals;
 
+namespace
+{
+	constexpr char32_t REPLACEMENT_CHAR = 0xFFFD;
+
+	template<typename TOut>
+	TOut* EncodeU8(char32_t cp, TOut* out)
+	{
+		if (cp < 0x80)
+		{
+			*out++ = TOut(cp);
+		}
+		else if (cp < 0x800)
+		{
+			*out++ = TOut(0xC0 | (cp >> 6));
+			*out++ = TOut(0x80 | (cp & 0x3F));
+		}
+		else if (cp < 0x10000)
+		{
+			*out++ = TOut(0xE0 | (cp >> 12));
+			*out++ = TOut(0x80 | ((cp >> 6) & 0x3F));
+			*out++ = TOut(0x80 | (cp & 0x3F));
+		}
+		else
+		{
+			*out++ = TOut(0xF0 | (cp >> 18));
+			*out++ = TOut(0x80 | ((cp >> 12) & 0x3F));
+			*out++ = TOut(0x80 | ((cp >> 6) & 0x3F));
+			*out++ = TOut(0x80 | (cp & 0x3F));
+		}
+
+		return out;
+	}
+
+	char16_t* EncodeU16(char32_t cp, char16_t* out)
+	{
+		if (cp < 0x10000)
+		{
+			*out++ = char16_t(cp);
+		}
+		else
+		{
+			cp -= 0x10000;
+			*out++ = char16_t(0xD800 | (cp >> 10));
+			*out++ = char16_t(0xDC00 | (cp & 0x3FF));
+		}
+
+		return out;
+	}
+
+	// Decodes one code point, rejecting overlong forms, surrogates and anything past U+10FFFF
+	char32_t DecodeU8(const uint8_t*& it, const uint8_t* end, bool& valid)
+	{
+		const uint8_t lead = *it++;
+		if (lead < 0x80)
+			return lead;
+
+		size_t trailCount;
+		char32_t cp;
+		uint8_t minSecond = 0x80;
+		uint8_t maxSecond = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF)
+		{
+			trailCount = 1;
+			cp = lead & 0x1F;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			trailCount = 2;
+			cp = lead & 0x0F;
+			if (lead == 0xE0)
+				minSecond = 0xA0;
+			else if (lead == 0xED)
+				maxSecond = 0x9F;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			trailCount = 3;
+			cp = lead & 0x07;
+			if (lead == 0xF0)
+				minSecond = 0x90;
+			else if (lead == 0xF4)
+				maxSecond = 0x8F;
+		}
+		else
+		{
+			valid = false;
+			return REPLACEMENT_CHAR;
+		}
+
+		for (size_t i = 0; i < trailCount; i++)
+		{
+			const uint8_t minTrail = (i == 0) ? minSecond : 0x80;
+			const uint8_t maxTrail = (i == 0) ? maxSecond : 0xBF;
+			if (it == end || *it < minTrail || *it > maxTrail)
+			{
+				// Leave the offending byte for the next call
+				valid = false;
+				return REPLACEMENT_CHAR;
+			}
+
+			cp = (cp << 6) | (*it++ & 0x3F);
+		}
+
+		return cp;
+	}
+
+	// Stop taking the scalar path after this many code units to give the ASCII fast path another try
+	constexpr size_t SCALAR_RUN_LENGTH = 16;
+
+	// out must have room for count code units
+	size_t TranscodeU8ToU16(const uint8_t* in, size_t count, char16_t* out, bool& valid)
+	{
+		const uint8_t* const end = in + count;
+		char16_t* const outBegin = out;
+
+		while (in < end)
+		{
+#if TF2BD_TEXTUTILS_SSE2
+			while ((end - in) >= 16)
+			{
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+				if (_mm_movemask_epi8(bytes) != 0)
+					break; // Not all ASCII
+
+				const __m128i zero = _mm_setzero_si128();
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(bytes, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+				in += 16;
+				out += 16;
+			}
+#endif
+
+			const uint8_t* const scalarEnd = in + std::min<size_t>(end - in, SCALAR_RUN_LENGTH);
+			while (in < scalarEnd)
+				out = EncodeU16(DecodeU8(in, end, valid), out);
+		}
+
+		return out - outBegin;
+	}
+
+	// out must have room for count * 3 code units
+	template<typename TOut>
+	size_t TranscodeU16ToU8(const char16_t* in, size_t count, TOut* out, bool& valid)
+	{
+		static_assert(sizeof(TOut) == 1);
+
+		const char16_t* const end = in + count;
+		TOut* const outBegin = out;
+
+		while (in < end)
+		{
+#if TF2BD_TEXTUTILS_SSE2
+			while ((end - in) >= 16)
+			{
+				const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+				const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+				const __m128i nonASCII = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(int16_t(0xFF80)));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonASCII, _mm_setzero_si128())) != 0xFFFF)
+					break;
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(lo, hi));
+				in += 16;
+				out += 16;
+			}
+#endif
+
+			const char16_t* const scalarEnd = in + std::min<size_t>(end - in, SCALAR_RUN_LENGTH);
+			while (in < scalarEnd)
+			{
+				char32_t cp = *in++;
+				if (cp >= 0xD800 && cp <= 0xDFFF)
+				{
+					if (cp <= 0xDBFF && in < end && *in >= 0xDC00 && *in <= 0xDFFF)
+					{
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (*in++ - 0xDC00);
+					}
+					else
+					{
+						valid = false;
+						cp = REPLACEMENT_CHAR;
+					}
+				}
+
+				out = EncodeU8(cp, out);
+			}
+		}
+
+		return out - outBegin;
+	}
+
+	template<typename TString>
+	bool TranscodeU16ToU8(const std::u16string_view& input, TString& output)
+	{
+		bool valid = true;
+		output.resize(input.size() * 3);
+		output.resize(TranscodeU16ToU8(input.data(), input.size(), output.data(), valid));
+		return valid;
+	}
+}
+
+bool tf2_bot_detector::ToU16(const std::u8string_view& input, std::u16string& output)
+{
+	bool valid = true;
+	output.resize(input.size());
+	output.resize(TranscodeU8ToU16(reinterpret_cast<const uint8_t*>(input.data()), input.size(), output.data(), valid));
+	return valid;
+}
+
+bool tf2_bot_detector::ToU16(const std::string_view& input, std::u16string& output)
+{
+	return ToU16(std::u8string_view(reinterpret_cast<const char8_t*>(input.data()), input.size()), output);
+}
+
+bool tf2_bot_detector::ToU8(const std::u16string_view& input, std::u8string& output)
+{
+	return TranscodeU16ToU8(input, output);
+}
+
+bool tf2_bot_detector::ToMB(const std::u16string_view& input, std::string& output)
+{
+	return TranscodeU16ToU8(input, output);
+}
+
 std::u16string tf2_bot_detector::ToU16(const std::u8string_view& input)
 {
-	std::wstring_convert<std::codecvt<char16_t, char, std::mbstate_t>, char16_t> converter;
-	return converter.from_bytes(reinterpret_cast<const char*>(input.data()),
-		reinterpret_cast<const char*>(input.data()) + input.size());
+	std::u16string retVal;
+	if (!ToU16(input, retVal))
+		throw std::range_error("Invalid UTF-8 sequence");
+
+	return retVal;
 }
 
 std::u16string tf2_bot_detector::ToU16(const char* input, const char* input_end)
@@ -44,8 +279,11 @@ std::u8string tf2_bot_detector::ToU8(const std::string_view& input)
 
 std::u8string tf2_bot_detector::ToU8(const std::u16string_view& input)
 {
-	std::wstring_convert<std::codecvt<char16_t, char, std::mbstate_t>, char16_t> converter;
-	return ToU8(converter.to_bytes(input.data(), input.data() + input.size()));
+	std::u8string retVal;
+	if (!ToU8(input, retVal))
+		throw std::range_error("Invalid UTF-16 sequence");
+
+	return retVal;
 }
 
 std::u8string tf2_bot_detector::ToU8(const std::wstring_view& input)
@@ -60,7 +298,11 @@ std::string tf2_bot_detector::ToMB(const std::u8string_view& input)
 
 std::string tf2_bot_detector::ToMB(const std::u16string_view& input)
 {
-	return ToMB(ToU8(input));
+	std::string retVal;
+	if (!ToMB(input, retVal))
+		throw std::range_error("Invalid UTF-16 sequence");
+
+	return retVal;
 }
 
 std::string tf2_bot_detector::ToMB(const std::wstring_view& input)
@@ -18,6 +18,14 @@ namespace tf2_bot_detector
 	std::string ToMB(const std::wstring_view& input);
 	std::wstring ToWC(const std::string_view& input);
 
+	// Transcode into a caller-provided buffer, replacing its contents, so repeated
+	// conversions can reuse one allocation. Malformed input is replaced with U+FFFD and
+	// makes these return false, where the allocating versions above throw std::range_error.
+	bool ToU16(const std::u8string_view& input, std::u16string& output);
+	bool ToU16(const std::string_view& input, std::u16string& output);
+	bool ToU8(const std::u16string_view& input, std::u8string& output);
+	bool ToMB(const std::u16string_view& input, std::string& output);
+
 	std::u16string ReadWideFile(const std::filesystem::path& filename);
 	void WriteWideFile(const std::filesystem::path& filename, const std::u16string_view& text);
 
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace tf2_bot_detector
+{
+	template<typename T>
+	struct TimeSeriesSample
+	{
+		time_point_t m_Timestamp{};
+		T m_Value{};
+	};
+
+	// Fixed-capacity ring of timestamped samples, limited to a sliding time window.
+	// Sum, min, max and an exponentially weighted moving average are maintained as
+	// samples are pushed and evicted, so every aggregate is O(1) to read.
+	template<typename T, size_t TCapacity>
+	class TimeSeries final
+	{
+		static_assert(std::is_arithmetic_v<T>);
+		static_assert(TCapacity > 0);
+
+	public:
+		using value_type = TimeSeriesSample<T>;
+		using sum_type = std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+
+		explicit TimeSeries(duration_t window = duration_t::max(), float ewmaAlpha = 0.25f) :
+			m_Window(window), m_EWMAAlpha(ewmaAlpha)
+		{
+		}
+
+		static constexpr size_t capacity() { return TCapacity; }
+		size_t size() const { return m_Size; }
+		bool empty() const { return m_Size == 0; }
+		duration_t GetWindow() const { return m_Window; }
+
+		// 0 is the oldest sample
+		const value_type& operator[](size_t index) const
+		{
+			assert(index < m_Size);
+			return GetBySequence(m_PushCount - m_Size + index);
+		}
+		const value_type& front() const { return (*this)[0]; }
+		const value_type& back() const { return (*this)[m_Size - 1]; }
+
+		void push_back(time_point_t timestamp, T value)
+		{
+			if (m_Size == TCapacity)
+				pop_front();
+
+			m_Samples[m_PushCount % TCapacity] = { timestamp, value };
+			m_Sum += value;
+			m_EWMA = m_HasEWMA ? (m_EWMAAlpha * double(value) + (1 - m_EWMAAlpha) * m_EWMA) : double(value);
+			m_HasEWMA = true;
+
+			while (!m_MinQueue.empty() && GetBySequence(m_MinQueue.back()).m_Value >= value)
+				m_MinQueue.pop_back();
+			m_MinQueue.push_back(m_PushCount);
+
+			while (!m_MaxQueue.empty() && GetBySequence(m_MaxQueue.back()).m_Value <= value)
+				m_MaxQueue.pop_back();
+			m_MaxQueue.push_back(m_PushCount);
+
+			m_PushCount++;
+			m_Size++;
+
+			EvictOlderThan(timestamp - std::min(m_Window, timestamp.time_since_epoch()));
+		}
+
+		// Drops every sample with a timestamp before the given time
+		void EvictOlderThan(time_point_t time)
+		{
+			while (m_Size > 0 && front().m_Timestamp < time)
+				pop_front();
+		}
+
+		void clear()
+		{
+			m_Size = 0;
+			m_Sum = 0;
+			m_EWMA = 0;
+			m_HasEWMA = false;
+			m_MinQueue.clear();
+			m_MaxQueue.clear();
+		}
+
+		sum_type GetSum() const { return m_Sum; }
+		double GetMean() const { return m_Size > 0 ? (double(m_Sum) / m_Size) : 0; }
+		T GetMin() const { return m_MinQueue.empty() ? T{} : GetBySequence(m_MinQueue.front()).m_Value; }
+		T GetMax() const { return m_MaxQueue.empty() ? T{} : GetBySequence(m_MaxQueue.front()).m_Value; }
+
+		// Not affected by eviction, covers every sample pushed since the last clear()
+		double GetEWMA() const { return m_EWMA; }
+
+	private:
+		// Ring of sample sequence numbers used as a monotonic queue for min/max
+		class SequenceQueue final
+		{
+		public:
+			bool empty() const { return m_Size == 0; }
+			uint64_t front() const { return m_Values[m_Begin]; }
+			uint64_t back() const { return m_Values[(m_Begin + m_Size - 1) % TCapacity]; }
+			void push_back(uint64_t value) { assert(m_Size < TCapacity); m_Values[(m_Begin + m_Size++) % TCapacity] = value; }
+			void pop_back() { m_Size--; }
+			void pop_front() { m_Begin = (m_Begin + 1) % TCapacity; m_Size--; }
+			void clear() { m_Begin = m_Size = 0; }
+
+		private:
+			std::array<uint64_t, TCapacity> m_Values{};
+			size_t m_Begin = 0;
+			size_t m_Size = 0;
+		};
+
+		const value_type& GetBySequence(uint64_t sequence) const { return m_Samples[sequence % TCapacity]; }
+
+		void pop_front()
+		{
+			assert(m_Size > 0);
+			const uint64_t sequence = m_PushCount - m_Size;
+			m_Sum -= GetBySequence(sequence).m_Value;
+
+			if (!m_MinQueue.empty() && m_MinQueue.front() == sequence)
+				m_MinQueue.pop_front();
+			if (!m_MaxQueue.empty() && m_MaxQueue.front() == sequence)
+				m_MaxQueue.pop_front();
+
+			m_Size--;
+		}
+
+		std::array<value_type, TCapacity> m_Samples{};
+		uint64_t m_PushCount = 0;
+		size_t m_Size = 0;
+
+		duration_t m_Window;
+		sum_type m_Sum = 0;
+
+		float m_EWMAAlpha;
+		double m_EWMA = 0;
+		bool m_HasEWMA = false;
+
+		SequenceQueue m_MinQueue;
+		SequenceQueue m_MaxQueue;
+	};
+
+	// Keeps a high resolution window of raw samples alongside a much longer,
+	// low resolution window where each sample is the mean of one bucket.
+	template<typename T, size_t TFineCapacity, size_t TCoarseCapacity>
+	class MultiResolutionTimeSeries final
+	{
+	public:
+		using fine_type = TimeSeries<T, TFineCapacity>;
+		using coarse_type = TimeSeries<float, TCoarseCapacity>;
+
+		MultiResolutionTimeSeries(duration_t fineWindow, duration_t bucketSize) :
+			m_Fine(fineWindow),
+			m_Coarse(bucketSize * TCoarseCapacity),
+			m_BucketSize(bucketSize)
+		{
+		}
+
+		void push_back(time_point_t timestamp, T value)
+		{
+			m_Fine.push_back(timestamp, value);
+
+			if (m_BucketCount > 0 && (timestamp - m_BucketStart) >= m_BucketSize)
+				FlushBucket();
+
+			if (m_BucketCount == 0)
+				m_BucketStart = timestamp;
+
+			m_BucketSum += value;
+			m_BucketCount++;
+		}
+
+		void clear()
+		{
+			m_Fine.clear();
+			m_Coarse.clear();
+			m_BucketSum = 0;
+			m_BucketCount = 0;
+		}
+
+		const fine_type& GetFine() const { return m_Fine; }
+		const coarse_type& GetCoarse() const { return m_Coarse; }
+
+	private:
+		void FlushBucket()
+		{
+			m_Coarse.push_back(m_BucketStart, float(double(m_BucketSum) / m_BucketCount));
+			m_BucketSum = 0;
+			m_BucketCount = 0;
+		}
+
+		fine_type m_Fine;
+		coarse_type m_Coarse;
+
+		duration_t m_BucketSize;
+		time_point_t m_BucketStart{};
+		typename fine_type::sum_type m_BucketSum = 0;
+		uint32_t m_BucketCount = 0;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "Clock.h"
 
+#include <cstdint>
 #include <string_view>
 
 namespace tf2_bot_detector
@@ -9,6 +10,7 @@ namespace tf2_bot_detector
 	class IPlayer;
 	class IWorldState;
 	enum class TFClassType;
+	enum class TFTeam : uint8_t;
 
 	class IWorldEventListener
 	{
@@ -16,7 +18,17 @@ namespace tf2_bot_detector
 		virtual ~IWorldEventListener() = default;
 
 		virtual void OnTimestampUpdate(IWorldState& world) = 0;
+
+		// Status dumps are diffed against the previous one. OnPlayerStatusUpdate is only called
+		// when something other than ping/loss/connection time changed (including the first time
+		// we see a player), otherwise OnPlayerTelemetryUpdate is called instead.
 		virtual void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) = 0;
+		virtual void OnPlayerTelemetryUpdate(IWorldState& world, const IPlayer& player) = 0;
+		virtual void OnPlayerJoined(IWorldState& world, IPlayer& player) = 0;
+		virtual void OnPlayerLeft(IWorldState& world, IPlayer& player) = 0;
+		virtual void OnPlayerNameChanged(IWorldState& world, IPlayer& player, const std::string_view& oldName) = 0;
+		virtual void OnPlayerTeamChanged(IWorldState& world, IPlayer& player, TFTeam oldTeam) = 0;
+
 		virtual void OnChatMsg(IWorldState& world, IPlayer& player, const std::string_view& msg) = 0;
 		virtual void OnLocalPlayerInitialized(IWorldState& world, bool initialized) = 0;
 		virtual void OnLocalPlayerSpawned(IWorldState& world, TFClassType classType) = 0;
@@ -28,6 +40,11 @@ namespace tf2_bot_detector
 	public:
 		void OnTimestampUpdate(IWorldState& world) override {}
 		void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) override {}
+		void OnPlayerTelemetryUpdate(IWorldState& world, const IPlayer& player) override {}
+		void OnPlayerJoined(IWorldState& world, IPlayer& player) override {}
+		void OnPlayerLeft(IWorldState& world, IPlayer& player) override {}
+		void OnPlayerNameChanged(IWorldState& world, IPlayer& player, const std::string_view& oldName) override {}
+		void OnPlayerTeamChanged(IWorldState& world, IPlayer& player, TFTeam oldTeam) override {}
 		void OnChatMsg(IWorldState& world, IPlayer& player, const std::string_view& msg) override {}
 		void OnLocalPlayerInitialized(IWorldState& world, bool initialized) override {}
 		void OnLocalPlayerSpawned(IWorldState& world, TFClassType classType) override {}
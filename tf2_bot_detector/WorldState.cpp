@@ -10,14 +10,20 @@
 #include "Networking/SteamAPI.h"
 #include "Util/RegexUtils.h"
 #include "Util/TextUtils.h"
-#include "BatchedAction.h"
 #include "IPlayer.h"
 #include "Log.h"
+#include "PlayerNameIndex.h"
+#include "PlayerRequestScheduler.h"
+#include "PlayerTable.h"
+#include "ScoreboardView.h"
 #include "WorldEventListener.h"
 
 #include <mh/concurrency/main_thread.hpp>
 #include <mh/future.hpp>
 
+#include <algorithm>
+#include <array>
+
 using namespace std::chrono_literals;
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -27,60 +33,70 @@ namespace
 {
 	class WorldState;
 
+	// Which fields of a player changed when applying a status line, ignoring
+	// the ones that change every time (ping, loss, connection time)
+	struct PlayerStatusDiff
+	{
+		bool m_NameChanged = false;
+		bool m_StateChanged = false;
+		bool m_UserIDChanged = false;
+
+		bool IsTelemetryOnly() const { return !m_NameChanged && !m_StateChanged && !m_UserIDChanged; }
+	};
+
 	class Player final : public IPlayer
 	{
 	public:
-		Player(WorldState& world, SteamID id);
+		Player(WorldState& world, PlayerTable& table, PlayerTable::slot_t slot);
+		Player(const Player&) = delete;
+		Player& operator=(const Player&) = delete;
 
 		using IPlayer::GetWorld;
 		const IWorldState& GetWorld() const override;
 		const LobbyMember* GetLobbyMember() const override;
-		std::string_view GetNameUnsafe() const override { return m_Status.m_Name; }
+		std::string_view GetNameUnsafe() const override { return m_Table->m_NamesUnsafe[m_Slot]; }
 		std::string_view GetNameSafe() const override { return m_PlayerNameSafe; }
-		SteamID GetSteamID() const override { return m_Status.m_SteamID; }
-		PlayerStatusState GetConnectionState() const override { return m_Status.m_State; }
+		SteamID GetSteamID() const override { return m_Table->m_SteamIDs[m_Slot]; }
+		PlayerStatusState GetConnectionState() const override { return m_Table->m_States[m_Slot]; }
 		std::optional<UserID_t> GetUserID() const override;
-		TFTeam GetTeam() const override { return m_Team; }
-		time_point_t GetConnectionTime() const override { return m_Status.m_ConnectionTime; }
+		TFTeam GetTeam() const override { return m_Table->m_Teams[m_Slot]; }
+		time_point_t GetConnectionTime() const override { return m_ConnectionTime; }
 		duration_t GetConnectedTime() const override;
-		const PlayerScores& GetScores() const override { return m_Scores; }
-		uint16_t GetPing() const override { return m_Status.m_Ping; }
-		time_point_t GetLastStatusUpdateTime() const override { return m_LastStatusUpdateTime; }
+		const PlayerScores& GetScores() const override { return m_Table->m_Scores[m_Slot]; }
+		uint16_t GetPing() const override { return m_Table->m_Pings[m_Slot]; }
+		time_point_t GetLastStatusUpdateTime() const override { return m_Table->m_LastStatusUpdateTimes[m_Slot]; }
 		const SteamAPI::PlayerSummary* GetPlayerSummary() const override;
 		const SteamAPI::PlayerBans* GetPlayerBans() const override;
 		const SteamAPI::TF2PlaytimeResult* GetTF2Playtime() const override;
 		bool IsFriend() const override;
 		duration_t GetActiveTime() const override;
 
-		PlayerScores m_Scores{};
-		TFTeam m_Team{};
+		PlayerTable::slot_t GetSlot() const { return m_Slot; }
+		PlayerScores& GetScores() { return m_Table->m_Scores[m_Slot]; }
+		void SetTeam(TFTeam team) { m_Table->m_Teams[m_Slot] = team; }
 
 		uint8_t m_ClientIndex{};
 		std::optional<SteamAPI::PlayerSummary> m_PlayerSummary;
 		std::optional<SteamAPI::PlayerBans> m_PlayerSteamBans;
+		std::optional<SteamAPI::TF2PlaytimeResult> m_TF2Playtime;
 
-		void SetStatus(PlayerStatus status, time_point_t timestamp);
-		const PlayerStatus& GetStatus() const { return m_Status; }
+		PlayerStatusDiff SetStatus(PlayerStatus status, time_point_t timestamp);
 
 		void SetPing(uint16_t ping, time_point_t timestamp);
 
-	protected:
-		std::map<std::type_index, std::any> m_UserData;
-		const std::any* FindDataStorage(const std::type_index& type) const override;
-		std::any& GetOrCreateDataStorage(const std::type_index& type) override;
+		PlayerDataStorage& GetDataStorage() override { return m_UserData; }
+		const PlayerDataStorage& GetDataStorage() const override { return m_UserData; }
 
 	private:
 		WorldState* m_World = nullptr;
-		PlayerStatus m_Status{};
-		std::string m_PlayerNameSafe;
+		PlayerTable* m_Table = nullptr;
+		PlayerTable::slot_t m_Slot{};
+		PlayerDataStorage m_UserData;
 
+		std::string m_PlayerNameSafe;
+		time_point_t m_ConnectionTime{};
 		time_point_t m_LastStatusActiveBegin{};
-
-		time_point_t m_LastStatusUpdateTime{};
 		time_point_t m_LastPingUpdateTime{};
-
-		mutable bool m_TF2PlaytimeFetched = false;
-		mutable std::shared_future<SteamAPI::TF2PlaytimeResult> m_TF2Playtime;
 	};
 
 	class WorldState final : public IWorldState, BaseConsoleLineListener
@@ -94,11 +110,13 @@ namespace
 
 		void Update() override;
 		void UpdateTimestamp(const ConsoleLogParser& parser);
+		void UpdateTimestamp(time_point_t timestamp);
 
 		void AddWorldEventListener(IWorldEventListener* listener) override;
 		void RemoveWorldEventListener(IWorldEventListener* listener) override;
-		void AddConsoleLineListener(IConsoleLineListener* listener) override;
+		void AddConsoleLineListener(IConsoleLineListener* listener, ConsoleLineTypeMask types) override;
 		void RemoveConsoleLineListener(IConsoleLineListener* listener) override;
+		const ConsoleLineDispatchStats& GetConsoleLineDispatchStats(ConsoleLineType type) const override;
 
 		void AddConsoleOutputChunk(const std::string_view& chunk) override;
 		void AddConsoleOutputLine(const std::string_view& line) override;
@@ -115,9 +133,9 @@ namespace
 
 		using IWorldState::FindPlayer;
 		const IPlayer* FindPlayer(const SteamID& id) const override;
+		const PlayerTable& GetPlayerTable() const override { return m_PlayerTable; }
+		const PlayerNameIndex& GetPlayerNameIndex() const override { return m_PlayerNameIndex; }
 
-		cppcoro::generator<const IPlayer&> GetLobbyMembers() const;
-		cppcoro::generator<const IPlayer&> GetPlayers() const;
 		std::vector<const IPlayer*> GetRecentPlayers(size_t recentPlayerCount = 32) const;
 		std::vector<IPlayer*> GetRecentPlayers(size_t recentPlayerCount = 32);
 
@@ -129,6 +147,8 @@ namespace
 
 		void QueuePlayerSummaryUpdate(const SteamID& id);
 		void QueuePlayerBansUpdate(const SteamID& id);
+		void QueueTF2PlaytimeUpdate(const SteamID& id);
+		void PrioritizeSteamAPIRequests(const SteamID& id, PlayerRequestPriority priority) override;
 
 		const Settings& GetSettings() const { return m_Settings; }
 		const std::vector<LobbyMember>& GetCurrentLobbyMembers() const { return m_CurrentLobbyMembers; }
@@ -137,6 +157,8 @@ namespace
 
 	protected:
 		virtual IConsoleLineListener& GetConsoleLineListenerBroadcaster() { return m_ConsoleLineListenerBroadcaster; }
+		DerefRange<IPlayer> GetLobbyMembersImpl() const override;
+		DerefRange<IPlayer> GetScoreboardPlayersImpl() const override;
 
 	private:
 		const Settings& m_Settings;
@@ -153,35 +175,48 @@ namespace
 
 		Player& FindOrCreatePlayer(const SteamID& id);
 
-		struct PlayerSummaryUpdateAction final :
-			BatchedAction<WorldState*, SteamID, std::vector<SteamAPI::PlayerSummary>>
-		{
-			using BatchedAction::BatchedAction;
-		protected:
-			response_future_type SendRequest(WorldState*& state, queue_collection_type& collection) override;
-			void OnDataReady(WorldState*& state, const response_type& response,
-				queue_collection_type& collection) override;
-		} m_PlayerSummaryUpdates;
-
-		struct PlayerBansUpdateAction final :
-			BatchedAction<WorldState*, SteamID, std::vector<SteamAPI::PlayerBans>>
-		{
-			using BatchedAction::BatchedAction;
-		protected:
-			response_future_type SendRequest(state_type& state, queue_collection_type& collection) override;
-			void OnDataReady(state_type& state, const response_type& response,
-				queue_collection_type& collection) override;
-		} m_PlayerBansUpdates;
+		// Steam API data is only requested for players someone asked about, most important
+		// players first, within a budget shared by every kind of request.
+		RequestBudget m_SteamAPIBudget{ 16, 1s };
+		PlayerRequestScheduler m_PlayerSummaryRequests;
+		PlayerRequestScheduler m_PlayerBansRequests;
+		PlayerRequestScheduler m_TF2PlaytimeRequests;
+		std::future<std::vector<SteamAPI::PlayerSummary>> m_PlayerSummariesResponse;
+		std::vector<SteamID> m_PlayerSummariesRequested;
+		std::shared_future<std::vector<SteamAPI::PlayerBans>> m_PlayerBansResponse;
+		std::vector<SteamID> m_PlayerBansRequested;
+		static constexpr size_t MAX_CONCURRENT_TF2_PLAYTIME_REQUESTS = 4;
+		SinglePlayerRequests<SteamAPI::TF2PlaytimeResult> m_TF2PlaytimeResponses{ MAX_CONCURRENT_TF2_PLAYTIME_REQUESTS };
+		void UpdateSteamAPIRequests();
+		void CancelSteamAPIRequests(const SteamID& id);
 
 		std::vector<LobbyMember> m_CurrentLobbyMembers;
 		std::vector<LobbyMember> m_PendingLobbyMembers;
-		std::unordered_map<SteamID, Player> m_CurrentPlayerData;
+
+		// Players for m_CurrentLobbyMembers + m_PendingLobbyMembers, rebuilt on demand
+		mutable std::vector<IPlayer*> m_LobbyMemberPlayers;
+		mutable bool m_LobbyMemberPlayersDirty = true;
+		void MarkLobbyMembersDirty();
+		void ClearPlayers();
+		mutable ScoreboardView m_ScoreboardView;
+		PlayerTable m_PlayerTable;
+		std::vector<std::unique_ptr<Player>> m_Players; // Indexed by PlayerTable slot
+		PlayerNameIndex m_PlayerNameIndex;
 		bool m_IsLocalPlayerInitialized = false;
 		bool m_IsVoteInProgress = false;
 
 		time_point_t m_LastStatusUpdateTime{};
 
+		// Players in the last complete status dump, and in the one we're currently receiving
+		std::unordered_set<SteamID> m_StatusDumpPlayers;
+		std::unordered_set<SteamID> m_PendingStatusDumpPlayers;
+		std::optional<size_t> m_PendingStatusDumpPlayerCount;
+		void OnStatusPlayerLine(const ServerStatusPlayerLine& statusLine);
+		void FinishStatusDump();
+
 		std::unordered_set<IConsoleLineListener*> m_ConsoleLineListeners;
+		std::array<std::vector<IConsoleLineListener*>, size_t(ConsoleLineType::COUNT)> m_ConsoleLineListenersByType;
+		std::array<ConsoleLineDispatchStats, size_t(ConsoleLineType::COUNT)> m_ConsoleLineDispatchStats;
 		std::unordered_set<IWorldEventListener*> m_EventListeners;
 
 		struct ConsoleLineListenerBroadcaster final : IConsoleLineListener
@@ -190,8 +225,17 @@ namespace
 
 			void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override
 			{
-				for (IConsoleLineListener* l : m_World.m_ConsoleLineListeners)
+				const auto type = size_t(line.GetType());
+				const auto& listeners = m_World.m_ConsoleLineListenersByType[type];
+				const auto startTime = std::chrono::steady_clock::now();
+
+				for (IConsoleLineListener* l : listeners)
 					l->OnConsoleLineParsed(world, line);
+
+				auto& stats = m_World.m_ConsoleLineDispatchStats[type];
+				stats.m_LineCount++;
+				stats.m_ListenerCalls += listeners.size();
+				stats.m_TotalTime += std::chrono::steady_clock::now() - startTime;
 			}
 			void OnConsoleLineUnparsed(IWorldState& world, const std::string_view& text) override
 			{
@@ -223,11 +267,27 @@ std::unique_ptr<IWorldState> IWorldState::Create(const Settings& settings)
 
 WorldState::WorldState(const Settings& settings) :
 	m_Settings(settings),
-	m_PlayerSummaryUpdates(this),
-	m_PlayerBansUpdates(this),
 	m_ConsoleLineListenerBroadcaster(*this)
 {
-	AddConsoleLineListener(this);
+	AddConsoleLineListener(this,
+		{
+			ConsoleLineType::LobbyHeader,
+			ConsoleLineType::LobbyStatusFailed,
+			ConsoleLineType::LobbyChanged,
+			ConsoleLineType::HostNewGame,
+			ConsoleLineType::Connecting,
+			ConsoleLineType::ClientReachedServerSpawn,
+			ConsoleLineType::Chat,
+			ConsoleLineType::ServerDroppedPlayer,
+			ConsoleLineType::ConfigExec,
+			ConsoleLineType::LobbyMember,
+			ConsoleLineType::Ping,
+			ConsoleLineType::PlayerStatus,
+			ConsoleLineType::PlayerStatusCount,
+			ConsoleLineType::PlayerStatusShort,
+			ConsoleLineType::KillNotification,
+			ConsoleLineType::SVC_UserMessage,
+		});
 }
 
 WorldState::~WorldState()
@@ -237,8 +297,7 @@ WorldState::~WorldState()
 
 void WorldState::Update()
 {
-	m_PlayerSummaryUpdates.Update();
-	m_PlayerBansUpdates.Update();
+	UpdateSteamAPIRequests();
 
 	UpdateFriends();
 }
@@ -282,14 +341,31 @@ void WorldState::UpdateFriends()
 	}
 }
 
-void WorldState::AddConsoleLineListener(IConsoleLineListener* listener)
+void WorldState::AddConsoleLineListener(IConsoleLineListener* listener, ConsoleLineTypeMask types)
 {
+	// Re-registering just updates the mask
+	RemoveConsoleLineListener(listener);
+
 	m_ConsoleLineListeners.insert(listener);
+	for (size_t i = 0; i < m_ConsoleLineListenersByType.size(); i++)
+	{
+		if (types.Contains(ConsoleLineType(i)))
+			m_ConsoleLineListenersByType[i].push_back(listener);
+	}
 }
 
 void WorldState::RemoveConsoleLineListener(IConsoleLineListener* listener)
 {
-	m_ConsoleLineListeners.erase(listener);
+	if (!m_ConsoleLineListeners.erase(listener))
+		return;
+
+	for (auto& listeners : m_ConsoleLineListenersByType)
+		listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+const ConsoleLineDispatchStats& WorldState::GetConsoleLineDispatchStats(ConsoleLineType type) const
+{
+	return m_ConsoleLineDispatchStats.at(size_t(type));
 }
 
 void WorldState::AddConsoleOutputChunk(const std::string_view& chunk)
@@ -307,15 +383,9 @@ void WorldState::AddConsoleOutputLine(const std::string_view& line)
 {
 	auto parsed = IConsoleLine::ParseConsoleLine(line, GetCurrentTime());
 	if (parsed)
-	{
-		for (auto listener : m_ConsoleLineListeners)
-			listener->OnConsoleLineParsed(*this, *parsed);
-	}
+		m_ConsoleLineListenerBroadcaster.OnConsoleLineParsed(*this, *parsed);
 	else
-	{
-		for (auto listener : m_ConsoleLineListeners)
-			listener->OnConsoleLineUnparsed(*this, line);
-	}
+		m_ConsoleLineListenerBroadcaster.OnConsoleLineUnparsed(*this, line);
 }
 
 void WorldState::UpdateTimestamp(const ConsoleLogParser& parser)
@@ -323,6 +393,11 @@ void WorldState::UpdateTimestamp(const ConsoleLogParser& parser)
 	m_CurrentTimestamp = parser.GetCurrentTimestamp();
 }
 
+void WorldState::UpdateTimestamp(time_point_t timestamp)
+{
+	m_CurrentTimestamp.SetExact(timestamp);
+}
+
 void WorldState::AddWorldEventListener(IWorldEventListener* listener)
 {
 	m_EventListeners.insert(listener);
@@ -338,12 +413,14 @@ std::optional<SteamID> WorldState::FindSteamIDForName(const std::string_view& pl
 	std::optional<SteamID> retVal;
 	time_point_t lastUpdated{};
 
-	for (const auto& data : m_CurrentPlayerData)
+	const auto& names = m_PlayerTable.m_NamesUnsafe;
+	const auto& updateTimes = m_PlayerTable.m_LastStatusUpdateTimes;
+	for (size_t i = 0; i < names.size(); i++)
 	{
-		if (data.second.GetStatus().m_Name == playerName && data.second.GetLastStatusUpdateTime() > lastUpdated)
+		if (updateTimes[i] > lastUpdated && names[i] == playerName)
 		{
-			retVal = data.second.GetSteamID();
-			lastUpdated = data.second.GetLastStatusUpdateTime();
+			retVal = m_PlayerTable.m_SteamIDs[i];
+			lastUpdated = updateTimes[i];
 		}
 	}
 
@@ -369,11 +446,8 @@ std::optional<LobbyMemberTeam> WorldState::FindLobbyMemberTeam(const SteamID& id
 
 std::optional<UserID_t> WorldState::FindUserID(const SteamID& id) const
 {
-	for (const auto& player : m_CurrentPlayerData)
-	{
-		if (player.second.GetSteamID() == id)
-			return player.second.GetUserID();
-	}
+	if (auto slot = m_PlayerTable.FindSlot(id))
+		return m_Players[*slot]->GetUserID();
 
 	return std::nullopt;
 }
@@ -407,8 +481,8 @@ auto WorldState::GetTeamShareResult(const std::optional<LobbyMemberTeam>& team0,
 
 const IPlayer* WorldState::FindPlayer(const SteamID& id) const
 {
-	if (auto found = m_CurrentPlayerData.find(id); found != m_CurrentPlayerData.end())
-		return &found->second;
+	if (auto slot = m_PlayerTable.FindSlot(id))
+		return m_Players[*slot].get();
 
 	return nullptr;
 }
@@ -418,32 +492,31 @@ size_t WorldState::GetApproxLobbyMemberCount() const
 	return m_CurrentLobbyMembers.size() + m_PendingLobbyMembers.size();
 }
 
-cppcoro::generator<const IPlayer&> WorldState::GetLobbyMembers() const
+DerefRange<IPlayer> WorldState::GetLobbyMembersImpl() const
 {
-	const auto GetPlayer = [&](const LobbyMember& member) -> const IPlayer*
+	if (!m_LobbyMemberPlayersDirty)
+		return m_LobbyMemberPlayers;
+
+	const auto GetPlayer = [&](const LobbyMember& member) -> IPlayer*
 	{
 		assert(member != LobbyMember{});
 		assert(member.m_SteamID.IsValid());
 
-		if (auto found = m_CurrentPlayerData.find(member.m_SteamID); found != m_CurrentPlayerData.end())
-		{
-			[[maybe_unused]] const LobbyMember* testMember = found->second.GetLobbyMember();
-			//assert(*testMember == member);
-			return &found->second;
-		}
+		if (auto slot = m_PlayerTable.FindSlot(member.m_SteamID))
+			return m_Players[*slot].get();
 		else
-		{
 			throw std::runtime_error("Missing player for lobby member!");
-		}
 	};
 
+	m_LobbyMemberPlayers.clear();
+
 	for (const auto& member : m_CurrentLobbyMembers)
 	{
 		if (!member.IsValid())
 			continue;
 
 		if (auto found = GetPlayer(member))
-			co_yield *found;
+			m_LobbyMemberPlayers.push_back(found);
 	}
 	for (const auto& member : m_PendingLobbyMembers)
 	{
@@ -458,55 +531,88 @@ cppcoro::generator<const IPlayer&> WorldState::GetLobbyMembers() const
 		}
 
 		if (auto found = GetPlayer(member))
-			co_yield *found;
+			m_LobbyMemberPlayers.push_back(found);
 	}
+
+	m_LobbyMemberPlayersDirty = false;
+	return m_LobbyMemberPlayers;
 }
 
-cppcoro::generator<const IPlayer&> WorldState::GetPlayers() const
+DerefRange<IPlayer> WorldState::GetScoreboardPlayersImpl() const
 {
-	for (const auto& pair : m_CurrentPlayerData)
-		co_yield pair.second;
+	m_ScoreboardView.Update(m_PlayerTable, GetLobbyMembersImpl(), m_LastStatusUpdateTime);
+	return m_ScoreboardView.GetPlayers();
 }
 
 void WorldState::QueuePlayerSummaryUpdate(const SteamID& id)
 {
-	return m_PlayerSummaryUpdates.Queue(id);
+	m_PlayerSummaryRequests.Queue(id, PlayerRequestPriority::Background, clock_t::now());
 }
 
 void WorldState::QueuePlayerBansUpdate(const SteamID& id)
 {
-	return m_PlayerBansUpdates.Queue(id);
+	m_PlayerBansRequests.Queue(id, PlayerRequestPriority::Background, clock_t::now());
 }
 
-template<typename TMap>
-static auto GetRecentPlayersImpl(TMap&& map, size_t recentPlayerCount)
+void WorldState::QueueTF2PlaytimeUpdate(const SteamID& id)
 {
-	using value_type = std::conditional_t<std::is_const_v<std::remove_reference_t<TMap>>, const IPlayer*, IPlayer*>;
-	std::vector<value_type> retVal;
+	m_TF2PlaytimeRequests.Queue(id, PlayerRequestPriority::Background, clock_t::now());
+}
 
-	for (auto& [sid, player] : map)
-		retVal.push_back(&player);
+void WorldState::PrioritizeSteamAPIRequests(const SteamID& id, PlayerRequestPriority priority)
+{
+	const auto now = clock_t::now();
+	m_PlayerSummaryRequests.Prioritize(id, priority, now);
+	m_PlayerBansRequests.Prioritize(id, priority, now);
+	m_TF2PlaytimeRequests.Prioritize(id, priority, now);
+}
 
-	std::sort(retVal.begin(), retVal.end(),
-		[](const IPlayer* a, const IPlayer* b)
-		{
-			return b->GetLastStatusUpdateTime() < a->GetLastStatusUpdateTime();
-		});
+void WorldState::CancelSteamAPIRequests(const SteamID& id)
+{
+	m_PlayerSummaryRequests.Cancel(id);
+	m_PlayerBansRequests.Cancel(id);
+	m_TF2PlaytimeRequests.Cancel(id);
+}
+
+template<typename TPlayer>
+static std::vector<TPlayer*> GetRecentPlayersImpl(const PlayerTable& table, size_t recentPlayerCount)
+{
+	std::vector<PlayerTable::slot_t> slots(table.size());
+	for (size_t i = 0; i < slots.size(); i++)
+		slots[i] = PlayerTable::slot_t(i);
+
+	const auto& updateTimes = table.m_LastStatusUpdateTimes;
+	const auto comparator = [&](PlayerTable::slot_t a, PlayerTable::slot_t b)
+	{
+		return updateTimes[b] < updateTimes[a];
+	};
+
+	if (slots.size() > recentPlayerCount)
+	{
+		std::partial_sort(slots.begin(), slots.begin() + recentPlayerCount, slots.end(), comparator);
+		slots.resize(recentPlayerCount);
+	}
+	else
+	{
+		std::sort(slots.begin(), slots.end(), comparator);
+	}
 
-	if (retVal.size() > recentPlayerCount)
-		retVal.resize(recentPlayerCount);
+	std::vector<TPlayer*> retVal;
+	retVal.reserve(slots.size());
+	for (auto slot : slots)
+		retVal.push_back(table.m_Players[slot]);
 
 	return retVal;
 }
 
 std::vector<const IPlayer*> WorldState::GetRecentPlayers(size_t recentPlayerCount) const
 {
-	return GetRecentPlayersImpl(m_CurrentPlayerData, recentPlayerCount);
+	return GetRecentPlayersImpl<const IPlayer>(m_PlayerTable, recentPlayerCount);
 }
 
 std::vector<IPlayer*> WorldState::GetRecentPlayers(size_t recentPlayerCount)
 {
-	return GetRecentPlayersImpl(m_CurrentPlayerData, recentPlayerCount);
+	return GetRecentPlayersImpl<IPlayer>(m_PlayerTable, recentPlayerCount);
 }
 
 void WorldState::OnConfigExecLineParsed(const ConfigExecLine& execLine)
@@ -562,7 +668,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 	{
 		m_CurrentLobbyMembers.clear();
 		m_PendingLobbyMembers.clear();
-		m_CurrentPlayerData.clear();
+		ClearPlayers();
 	};
 
 	switch (parsed.GetType())
@@ -572,6 +678,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		auto& headerLine = static_cast<const LobbyHeaderLine&>(parsed);
 		m_CurrentLobbyMembers.resize(headerLine.GetMemberCount());
 		m_PendingLobbyMembers.resize(headerLine.GetPendingCount());
+		MarkLobbyMembersDirty();
 		break;
 	}
 	case ConsoleLineType::LobbyStatusFailed:
@@ -580,7 +687,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		{
 			m_CurrentLobbyMembers.clear();
 			m_PendingLobbyMembers.clear();
-			m_CurrentPlayerData.clear();
+			ClearPlayers();
 		}
 		break;
 	}
@@ -597,8 +704,8 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		if (changeType == LobbyChangeType::Created || changeType == LobbyChangeType::Updated)
 		{
 			// We can't trust the existing client indices
-			for (auto& player : m_CurrentPlayerData)
-				player.second.m_ClientIndex = 0;
+			for (auto& player : m_Players)
+				player->m_ClientIndex = 0;
 		}
 		break;
 	}
@@ -699,7 +806,15 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 			vec[member.m_Index] = member;
 
 		const TFTeam tfTeam = member.m_Team == LobbyMemberTeam::Defenders ? TFTeam::Red : TFTeam::Blue;
-		FindOrCreatePlayer(member.m_SteamID).m_Team = tfTeam;
+		auto& player = FindOrCreatePlayer(member.m_SteamID);
+		if (const TFTeam oldTeam = player.GetTeam(); oldTeam != tfTeam)
+		{
+			player.SetTeam(tfTeam);
+			if (oldTeam != TFTeam::Unknown)
+				InvokeEventListener(&IWorldEventListener::OnPlayerTeamChanged, *this, player, oldTeam);
+		}
+
+		MarkLobbyMembersDirty();
 
 		break;
 	}
@@ -710,28 +825,24 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		{
 			auto& playerData = FindOrCreatePlayer(*found);
 			playerData.SetPing(pingLine.GetPing(), pingLine.GetTimestamp());
+			InvokeEventListener(&IWorldEventListener::OnPlayerTelemetryUpdate, *this, playerData);
 		}
 
 		break;
 	}
-	case ConsoleLineType::PlayerStatus:
+	case ConsoleLineType::PlayerStatusCount:
 	{
-		auto& statusLine = static_cast<const ServerStatusPlayerLine&>(parsed);
-		auto newStatus = statusLine.GetPlayerStatus();
-		auto& playerData = FindOrCreatePlayer(newStatus.m_SteamID);
-
-		// Don't introduce stutter to our connection time view
-		if (auto delta = (playerData.GetStatus().m_ConnectionTime - newStatus.m_ConnectionTime);
-			delta < 2s && delta > -2s)
-		{
-			newStatus.m_ConnectionTime = playerData.GetStatus().m_ConnectionTime;
-		}
-
-		assert(playerData.GetStatus().m_SteamID == newStatus.m_SteamID);
-		playerData.SetStatus(newStatus, statusLine.GetTimestamp());
-		m_LastStatusUpdateTime = std::max(m_LastStatusUpdateTime, playerData.GetLastStatusUpdateTime());
-		InvokeEventListener(&IWorldEventListener::OnPlayerStatusUpdate, *this, playerData);
+		// Start of a new status dump. If the previous one never reached its expected
+		// player count (unparseable rows, etc), this is the latest we can close it.
+		if (!m_PendingStatusDumpPlayers.empty())
+			FinishStatusDump();
 
+		m_PendingStatusDumpPlayerCount = static_cast<const ServerStatusPlayerCountLine&>(parsed).GetPlayerCount();
+		break;
+	}
+	case ConsoleLineType::PlayerStatus:
+	{
+		OnStatusPlayerLine(static_cast<const ServerStatusPlayerLine&>(parsed));
 		break;
 	}
 	case ConsoleLineType::PlayerStatusShort:
@@ -753,21 +864,24 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 		if (attackerSteamID)
 		{
 			auto& attacker = FindOrCreatePlayer(*attackerSteamID);
-			attacker.m_Scores.m_Kills++;
+			attacker.GetScores().m_Kills++;
 
 			if (victimSteamID == localSteamID)
-				attacker.m_Scores.m_LocalKills++;
+				attacker.GetScores().m_LocalKills++;
 		}
 
 		if (victimSteamID)
 		{
 			auto& victim = FindOrCreatePlayer(*victimSteamID);
-			victim.m_Scores.m_Deaths++;
+			victim.GetScores().m_Deaths++;
 
 			if (attackerSteamID == localSteamID)
-				victim.m_Scores.m_LocalDeaths++;
+				victim.GetScores().m_LocalDeaths++;
 		}
 
+		if (attackerSteamID || victimSteamID)
+			m_ScoreboardView.MarkOrderDirty();
+
 		break;
 	}
 	case ConsoleLineType::SVC_UserMessage:
@@ -824,34 +938,140 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 	}
 }
 
-Player& WorldState::FindOrCreatePlayer(const SteamID& id)
+void WorldState::OnStatusPlayerLine(const ServerStatusPlayerLine& statusLine)
 {
-	Player* data;
-	if (auto found = m_CurrentPlayerData.find(id); found != m_CurrentPlayerData.end())
-		data = &found->second;
+	auto newStatus = statusLine.GetPlayerStatus();
+	auto& playerData = FindOrCreatePlayer(newStatus.m_SteamID);
+
+	// Don't introduce stutter to our connection time view
+	if (auto delta = (playerData.GetConnectionTime() - newStatus.m_ConnectionTime);
+		delta < 2s && delta > -2s)
+	{
+		newStatus.m_ConnectionTime = playerData.GetConnectionTime();
+	}
+
+	std::string oldName;
+	if (playerData.GetNameUnsafe() != newStatus.m_Name)
+		oldName = playerData.GetNameUnsafe();
+
+	assert(playerData.GetSteamID() == newStatus.m_SteamID);
+	const PlayerStatusDiff diff = playerData.SetStatus(std::move(newStatus), statusLine.GetTimestamp());
+	m_LastStatusUpdateTime = std::max(m_LastStatusUpdateTime, playerData.GetLastStatusUpdateTime());
+
+	const SteamID steamID = playerData.GetSteamID();
+	const bool joined = !m_StatusDumpPlayers.contains(steamID) && !m_PendingStatusDumpPlayers.contains(steamID);
+	m_PendingStatusDumpPlayers.insert(steamID);
+	m_PlayerNameIndex.Update(steamID, playerData.GetNameUnsafe());
+
+	if (joined)
+	{
+		m_ScoreboardView.MarkMembershipDirty();
+		InvokeEventListener(&IWorldEventListener::OnPlayerJoined, *this, playerData);
+	}
+	else if (diff.m_NameChanged && !oldName.empty())
+	{
+		InvokeEventListener(&IWorldEventListener::OnPlayerNameChanged, *this, playerData, oldName);
+	}
+
+	if (diff.m_UserIDChanged)
+		m_ScoreboardView.MarkOrderDirty();
+
+	if (joined || !diff.IsTelemetryOnly())
+		InvokeEventListener(&IWorldEventListener::OnPlayerStatusUpdate, *this, playerData);
 	else
-		data = &m_CurrentPlayerData.emplace(id, Player{ *this, id }).first->second;
+		InvokeEventListener(&IWorldEventListener::OnPlayerTelemetryUpdate, *this, playerData);
 
-	assert(data->GetSteamID() == id);
-	return *data;
+	if (m_PendingStatusDumpPlayerCount && m_PendingStatusDumpPlayers.size() >= *m_PendingStatusDumpPlayerCount)
+		FinishStatusDump();
 }
 
-auto WorldState::GetTeamShareResult(const SteamID& id0, const SteamID& id1) const -> TeamShareResult
+void WorldState::FinishStatusDump()
 {
-	return GetTeamShareResult(FindLobbyMemberTeam(id0), FindLobbyMemberTeam(id1));
+	for (const SteamID& id : m_StatusDumpPlayers)
+	{
+		if (m_PendingStatusDumpPlayers.contains(id))
+			continue;
+
+		m_PlayerNameIndex.Remove(id);
+		CancelSteamAPIRequests(id);
+		if (auto slot = m_PlayerTable.FindSlot(id))
+			InvokeEventListener(&IWorldEventListener::OnPlayerLeft, *this, *m_Players[*slot]);
+	}
+
+	m_StatusDumpPlayers.swap(m_PendingStatusDumpPlayers);
+	m_PendingStatusDumpPlayers.clear();
+	m_PendingStatusDumpPlayerCount.reset();
+	m_ScoreboardView.MarkMembershipDirty();
+}
+
+Player& WorldState::FindOrCreatePlayer(const SteamID& id)
+{
+	if (auto slot = m_PlayerTable.FindSlot(id))
+	{
+		Player& existing = *m_Players[*slot];
+		assert(existing.GetSteamID() == id);
+		return existing;
+	}
+
+	const auto slot = PlayerTable::slot_t(m_PlayerTable.size());
+	Player& player = *m_Players.emplace_back(std::make_unique<Player>(*this, m_PlayerTable, slot));
+	[[maybe_unused]] const auto addedSlot = m_PlayerTable.Add(player, id);
+	assert(addedSlot == slot);
+
+	if (!m_Settings.m_LazyLoadAPIData)
+	{
+		player.GetPlayerSummary();
+		player.GetPlayerBans();
+		player.GetTF2Playtime();
+	}
+
+	return player;
 }
 
-Player::Player(WorldState& world, SteamID id) :
-	m_World(&world)
+void WorldState::MarkLobbyMembersDirty()
 {
-	m_Status.m_SteamID = id;
+	m_LobbyMemberPlayersDirty = true;
+	m_ScoreboardView.MarkMembershipDirty();
+}
 
-	if (!m_World->GetSettings().m_LazyLoadAPIData)
+void WorldState::ClearPlayers()
+{
+	// Everyone we were playing with is gone, so listeners get to forget about them too
+	const auto InvokeLeft = [&](const SteamID& id)
+	{
+		if (auto slot = m_PlayerTable.FindSlot(id))
+			InvokeEventListener(&IWorldEventListener::OnPlayerLeft, *this, *m_Players[*slot]);
+	};
+	for (const SteamID& id : m_StatusDumpPlayers)
+		InvokeLeft(id);
+	for (const SteamID& id : m_PendingStatusDumpPlayers)
 	{
-		GetPlayerSummary();
-		GetPlayerBans();
-		GetTF2Playtime();
+		if (!m_StatusDumpPlayers.contains(id))
+			InvokeLeft(id);
 	}
+
+	m_PlayerTable.clear();
+	m_Players.clear();
+	m_PlayerNameIndex.clear();
+	m_PlayerSummaryRequests.clear();
+	m_PlayerBansRequests.clear();
+	m_TF2PlaytimeRequests.clear();
+	m_LobbyMemberPlayers.clear();
+	m_ScoreboardView.clear();
+	m_StatusDumpPlayers.clear();
+	m_PendingStatusDumpPlayers.clear();
+	m_PendingStatusDumpPlayerCount.reset();
+	MarkLobbyMembersDirty();
+}
+
+auto WorldState::GetTeamShareResult(const SteamID& id0, const SteamID& id1) const -> TeamShareResult
+{
+	return GetTeamShareResult(FindLobbyMemberTeam(id0), FindLobbyMemberTeam(id1));
+}
+
+Player::Player(WorldState& world, PlayerTable& table, PlayerTable::slot_t slot) :
+	m_World(&world), m_Table(&table), m_Slot(slot)
+{
 }
 
 const IWorldState& Player::GetWorld() const
@@ -878,8 +1098,8 @@ const LobbyMember* Player::GetLobbyMember() const
 
 std::optional<UserID_t> Player::GetUserID() const
 {
-	if (m_Status.m_UserID > 0)
-		return m_Status.m_UserID;
+	if (auto userID = m_Table->m_UserIDs[m_Slot]; userID > 0)
+		return userID;
 
 	return std::nullopt;
 }
@@ -913,32 +1133,10 @@ const SteamAPI::PlayerBans* Player::GetPlayerBans() const
 
 const SteamAPI::TF2PlaytimeResult* Player::GetTF2Playtime() const
 {
-	if (!m_TF2PlaytimeFetched)
-	{
-		if (!m_World->GetSettings().GetSteamAPIKey().empty())
-		{
-			if (auto client = m_World->GetSettings().GetHTTPClient())
-			{
-				m_TF2PlaytimeFetched = true;
-				m_TF2Playtime = SteamAPI::GetTF2PlaytimeAsync(
-					m_World->GetSettings().GetSteamAPIKey(), GetSteamID(), *client);
-			}
-		}
-	}
-
-	if (mh::is_future_ready(m_TF2Playtime))
-	{
-		try
-		{
-			return &m_TF2Playtime.get();
-		}
-		catch (const std::exception& e)
-		{
-			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to get TF2 playtime for {}", *this);
-			m_TF2Playtime = {};
-		}
-	}
+	if (m_TF2Playtime)
+		return &*m_TF2Playtime;
 
+	m_World->QueueTF2PlaytimeUpdate(GetSteamID());
 	return nullptr;
 }
 
@@ -949,103 +1147,138 @@ bool Player::IsFriend() const
 
 duration_t Player::GetActiveTime() const
 {
-	if (m_Status.m_State != PlayerStatusState::Active)
+	if (GetConnectionState() != PlayerStatusState::Active)
 		return 0s;
 
-	return m_LastStatusUpdateTime - m_LastStatusActiveBegin;
+	return GetLastStatusUpdateTime() - m_LastStatusActiveBegin;
 }
 
-void Player::SetStatus(PlayerStatus status, time_point_t timestamp)
+PlayerStatusDiff Player::SetStatus(PlayerStatus status, time_point_t timestamp)
 {
-	if (m_Status.m_State != PlayerStatusState::Active && status.m_State == PlayerStatusState::Active)
+	if (GetConnectionState() != PlayerStatusState::Active && status.m_State == PlayerStatusState::Active)
 		m_LastStatusActiveBegin = timestamp;
 
-	m_Status = std::move(status);
-	m_PlayerNameSafe = CollapseNewlines(m_Status.m_Name);
-	m_LastStatusUpdateTime = m_LastPingUpdateTime = timestamp;
+	PlayerStatusDiff diff;
+	diff.m_StateChanged = m_Table->m_States[m_Slot] != status.m_State;
+	diff.m_UserIDChanged = m_Table->m_UserIDs[m_Slot] != status.m_UserID;
+
+	assert(m_Table->m_SteamIDs[m_Slot] == status.m_SteamID);
+	m_Table->m_States[m_Slot] = status.m_State;
+	m_Table->m_Pings[m_Slot] = status.m_Ping;
+	m_Table->m_UserIDs[m_Slot] = status.m_UserID;
+	m_Table->m_LastStatusUpdateTimes[m_Slot] = timestamp;
+
+	if (m_Table->m_NamesUnsafe[m_Slot] != status.m_Name)
+	{
+		diff.m_NameChanged = true;
+		m_PlayerNameSafe = CollapseNewlines(status.m_Name);
+		m_Table->m_NamesUnsafe[m_Slot] = std::move(status.m_Name);
+	}
+
+	m_ConnectionTime = status.m_ConnectionTime;
+	m_LastPingUpdateTime = timestamp;
+	return diff;
 }
 void Player::SetPing(uint16_t ping, time_point_t timestamp)
 {
-	m_Status.m_Ping = ping;
+	m_Table->m_Pings[m_Slot] = ping;
 	m_LastPingUpdateTime = timestamp;
 }
 
-const std::any* Player::FindDataStorage(const std::type_index& type) const
+void WorldState::UpdateSteamAPIRequests()
 {
-	if (auto found = m_UserData.find(type); found != m_UserData.end())
-		return &found->second;
+	const auto now = clock_t::now();
 
-	return nullptr;
-}
+	// Results for players that have left (or been cleared) since the request went out are dropped
+	const auto FindExistingPlayer = [&](const SteamID& id) -> Player*
+	{
+		if (auto slot = m_PlayerTable.FindSlot(id))
+			return m_Players[*slot].get();
 
-std::any& Player::GetOrCreateDataStorage(const std::type_index& type)
-{
-	return m_UserData[type];
-}
+		return nullptr;
+	};
 
-template<typename T>
-static std::vector<SteamID> Take100(const T& collection)
-{
-	std::vector<SteamID> retVal;
-	for (SteamID id : collection)
+	if (mh::is_future_ready(m_PlayerSummariesResponse))
 	{
-		if (retVal.size() >= 100)
-			break;
+		try
+		{
+			const auto summaries = m_PlayerSummariesResponse.get();
+			DebugLog("[SteamAPI] Received "s << summaries.size() << " player summaries");
+			for (const SteamAPI::PlayerSummary& entry : summaries)
+			{
+				if (auto player = FindExistingPlayer(entry.m_SteamID))
+					player->m_PlayerSummary = entry;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to get player summaries");
+			m_PlayerSummaryRequests.OnRequestFailed(m_PlayerSummariesRequested, now);
+		}
 
-		retVal.push_back(id);
+		m_PlayerSummariesResponse = {};
 	}
-	return retVal;
-}
-
-auto WorldState::PlayerSummaryUpdateAction::SendRequest(
-	WorldState*& state, queue_collection_type& collection) -> response_future_type
-{
-	auto client = state->GetSettings().GetHTTPClient();
-	if (!client)
-		return {};
-
-	if (state->GetSettings().GetSteamAPIKey().empty())
-		return {};
-
-	std::vector<SteamID> steamIDs = Take100(collection);
 
-	return SteamAPI::GetPlayerSummariesAsync(
-		state->GetSettings().GetSteamAPIKey(), std::move(steamIDs), *client);
-}
-
-void WorldState::PlayerSummaryUpdateAction::OnDataReady(WorldState*& state,
-	const response_type& response, queue_collection_type& collection)
-{
-	DebugLog("[SteamAPI] Received "s << response.size() << " player summaries");
-	for (const SteamAPI::PlayerSummary& entry : response)
+	if (mh::is_future_ready(m_PlayerBansResponse))
 	{
-		state->FindOrCreatePlayer(entry.m_SteamID).m_PlayerSummary = entry;
-		collection.erase(entry.m_SteamID);
+		try
+		{
+			const auto& bans = m_PlayerBansResponse.get();
+			DebugLog("[SteamAPI] Received "s << bans.size() << " player bans");
+			for (const SteamAPI::PlayerBans& entry : bans)
+			{
+				if (auto player = FindExistingPlayer(entry.m_SteamID))
+					player->m_PlayerSteamBans = entry;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to get player bans");
+			m_PlayerBansRequests.OnRequestFailed(m_PlayerBansRequested, now);
+		}
+
+		m_PlayerBansResponse = {};
 	}
-}
 
-auto WorldState::PlayerBansUpdateAction::SendRequest(state_type& state,
-	queue_collection_type& collection) -> response_future_type
-{
-	auto client = state->GetSettings().GetHTTPClient();
+	m_TF2PlaytimeResponses.TakeFinished([&](const SteamID& id, std::future<SteamAPI::TF2PlaytimeResult>& response)
+		{
+			try
+			{
+				auto playtime = response.get();
+				if (auto player = FindExistingPlayer(id))
+					player->m_TF2Playtime = playtime;
+			}
+			catch (const std::exception& e)
+			{
+				LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to get TF2 playtime for {}", id);
+				m_TF2PlaytimeRequests.OnRequestFailed({ id }, now);
+			}
+		});
+
+	auto client = GetSettings().GetHTTPClient();
 	if (!client)
-		return {};
+		return;
 
-	if (state->GetSettings().GetSteamAPIKey().empty())
-		return {};
+	const auto& apiKey = GetSettings().GetSteamAPIKey();
+	if (apiKey.empty())
+		return;
 
-	std::vector<SteamID> steamIDs = Take100(collection);
-	return SteamAPI::GetPlayerBansAsync(
-		state->GetSettings().GetSteamAPIKey(), std::move(steamIDs), *client);
-}
+	// Everything shares one budget, most important players first. Only one summary/bans request
+	// is in flight at a time, so anyone queued in the meantime goes out together in the next one.
+	if (!m_PlayerSummariesResponse.valid())
+	{
+		m_PlayerSummariesRequested = m_PlayerSummaryRequests.TakeBatch(100, m_SteamAPIBudget, now);
+		if (!m_PlayerSummariesRequested.empty())
+			m_PlayerSummariesResponse = SteamAPI::GetPlayerSummariesAsync(apiKey, m_PlayerSummariesRequested, *client);
+	}
 
-void WorldState::PlayerBansUpdateAction::OnDataReady(state_type& state,
-	const response_type& response, queue_collection_type& collection)
-{
-	DebugLog("[SteamAPI] Received "s << response.size() << " player bans");
-	for (const SteamAPI::PlayerBans& bans : response)
+	if (!m_PlayerBansResponse.valid())
 	{
-		state->FindOrCreatePlayer(bans.m_SteamID).m_PlayerSteamBans = bans;
-		collection.erase(bans.m_SteamID);
+		m_PlayerBansRequested = m_PlayerBansRequests.TakeBatch(100, m_SteamAPIBudget, now);
+		if (!m_PlayerBansRequested.empty())
+			m_PlayerBansResponse = SteamAPI::GetPlayerBansAsync(apiKey, m_PlayerBansRequested, *client);
 	}
+
+	m_TF2PlaytimeResponses.Start(m_TF2PlaytimeRequests, m_SteamAPIBudget, now,
+		[&](const SteamID& id) { return SteamAPI::GetTF2PlaytimeAsync(apiKey, id, *client); });
 }
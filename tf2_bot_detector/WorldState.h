@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Clock.h"
+#include "ConsoleLog/ConsoleLineListener.h"
+#include "PlayerTable.h"
 #include "SteamID.h"
 #include "TFConstants.h"
+#include "Util/RangeUtils.h"
 
 #include <cppcoro/generator.hpp>
 
@@ -13,10 +16,12 @@ namespace tf2_bot_detector
 	class ChatConsoleLine;
 	class ConfigExecLine;
 	class ConsoleLogParser;
-	class IConsoleLineListener;
 	class IPlayer;
 	class IWorldEventListener;
 	enum class LobbyMemberTeam : uint8_t;
+	class PlayerNameIndex;
+	enum class PlayerRequestPriority : uint8_t;
+	class SessionJournalReplayer;
 	class Settings;
 	enum class TFClassType;
 
@@ -36,10 +41,12 @@ namespace tf2_bot_detector
 
 	private:
 		friend class ConsoleLogParser;
+		friend class SessionJournalReplayer;
 
 		virtual IConsoleLineListener& GetConsoleLineListenerBroadcaster() = 0;
 
 		virtual void UpdateTimestamp(const ConsoleLogParser& parser) = 0;
+		virtual void UpdateTimestamp(time_point_t timestamp) = 0;
 	};
 
 	class IWorldState : public IWorldStateConLog
@@ -56,8 +63,10 @@ namespace tf2_bot_detector
 
 		virtual void AddWorldEventListener(IWorldEventListener* listener) = 0;
 		virtual void RemoveWorldEventListener(IWorldEventListener* listener) = 0;
-		virtual void AddConsoleLineListener(IConsoleLineListener* listener) = 0;
+		virtual void AddConsoleLineListener(IConsoleLineListener* listener,
+			ConsoleLineTypeMask types = ConsoleLineTypeMask::All()) = 0;
 		virtual void RemoveConsoleLineListener(IConsoleLineListener* listener) = 0;
+		virtual const ConsoleLineDispatchStats& GetConsoleLineDispatchStats(ConsoleLineType type) const = 0;
 
 		virtual void AddConsoleOutputChunk(const std::string_view& chunk) = 0;
 		virtual void AddConsoleOutputLine(const std::string_view& line) = 0;
@@ -75,25 +84,59 @@ namespace tf2_bot_detector
 		virtual const IPlayer* FindPlayer(const SteamID& id) const = 0;
 		IPlayer* FindPlayer(const SteamID& id) { return const_cast<IPlayer*>(std::as_const(*this).FindPlayer(id)); }
 
+		// Dense view of every known player, for linear per-frame scans
+		virtual const PlayerTable& GetPlayerTable() const = 0;
+
+		// Connected players, grouped by normalized (impersonation-proof) name
+		virtual const PlayerNameIndex& GetPlayerNameIndex() const = 0;
+
 		virtual size_t GetApproxLobbyMemberCount() const = 0;
-		virtual cppcoro::generator<const IPlayer&> GetLobbyMembers() const = 0;
-		cppcoro::generator<IPlayer&> GetLobbyMembers();
-		virtual cppcoro::generator<const IPlayer&> GetPlayers() const = 0;
-		cppcoro::generator<IPlayer&> GetPlayers();
+		DerefRange<const IPlayer> GetLobbyMembers() const { return GetLobbyMembersImpl(); }
+		DerefRange<IPlayer> GetLobbyMembers() { return GetLobbyMembersImpl(); }
+		DerefRange<const IPlayer> GetPlayers() const { return GetPlayerTable().m_Players; }
+		DerefRange<IPlayer> GetPlayers() { return GetPlayerTable().m_Players; }
+
+		// Players to draw on the scoreboard, already in display order
+		DerefRange<const IPlayer> GetScoreboardPlayers() const { return GetScoreboardPlayersImpl(); }
+		DerefRange<IPlayer> GetScoreboardPlayers() { return GetScoreboardPlayersImpl(); }
+
+		// Compatibility shims, prefer the range versions above
+		cppcoro::generator<const IPlayer&> GenerateLobbyMembers() const;
+		cppcoro::generator<IPlayer&> GenerateLobbyMembers();
+		cppcoro::generator<const IPlayer&> GeneratePlayers() const;
+		cppcoro::generator<IPlayer&> GeneratePlayers();
+
+		// Moves this player's outstanding Steam API requests up the queue for a couple seconds.
+		// Call it every frame the player is on screen.
+		virtual void PrioritizeSteamAPIRequests(const SteamID& id, PlayerRequestPriority priority) = 0;
 
 		// Have we joined a team and picked a class?
 		virtual bool IsLocalPlayerInitialized() const = 0;
 		virtual bool IsVoteInProgress() const = 0;
+
+	protected:
+		virtual DerefRange<IPlayer> GetLobbyMembersImpl() const = 0;
+		virtual DerefRange<IPlayer> GetScoreboardPlayersImpl() const = 0;
 	};
 
-	inline cppcoro::generator<IPlayer&> IWorldState::GetLobbyMembers()
+	inline cppcoro::generator<const IPlayer&> IWorldState::GenerateLobbyMembers() const
+	{
+		for (const IPlayer& p : GetLobbyMembers())
+			co_yield p;
+	}
+	inline cppcoro::generator<IPlayer&> IWorldState::GenerateLobbyMembers()
+	{
+		for (IPlayer& p : GetLobbyMembers())
+			co_yield p;
+	}
+	inline cppcoro::generator<const IPlayer&> IWorldState::GeneratePlayers() const
 	{
-		for (const IPlayer& p : std::as_const(*this).GetLobbyMembers())
-			co_yield const_cast<IPlayer&>(p);
+		for (const IPlayer& p : GetPlayers())
+			co_yield p;
 	}
-	inline cppcoro::generator<IPlayer&> IWorldState::GetPlayers()
+	inline cppcoro::generator<IPlayer&> IWorldState::GeneratePlayers()
 	{
-		for (const IPlayer& p : std::as_const(*this).GetPlayers())
-			co_yield const_cast<IPlayer&>(p);
+		for (IPlayer& p : GetPlayers())
+			co_yield p;
 	}
 }